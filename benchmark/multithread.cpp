@@ -12,9 +12,11 @@
 #include <umf/memory_pool.h>
 #include <umf/pools/pool_disjoint.h>
 #include <umf/pools/pool_jemalloc.h>
+#include <umf/pools/pool_proxy.h>
 #include <umf/pools/pool_scalable.h>
 #include <umf/providers/provider_os_memory.h>
 
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <numeric>
@@ -90,6 +92,213 @@ static void mt_alloc_free(poolCreateExtParams params,
               << std::endl;
 }
 
+// A provider backed by the system allocator. It is cheap enough that
+// the cost of the proxy pool on top of it is dominated by the memory tracker,
+// which has to insert and remove every single allocation.
+static umf_result_t malloc_provider_initialize(void *params, void **provider) {
+    (void)params;
+    *provider = nullptr;
+    return UMF_RESULT_SUCCESS;
+}
+
+static void malloc_provider_finalize(void *provider) { (void)provider; }
+
+static umf_result_t malloc_provider_alloc(void *provider, size_t size,
+                                          size_t alignment, void **ptr) {
+    (void)provider;
+    if (!alignment) {
+        alignment = 8;
+    }
+
+    size_t aligned_size = (size + alignment - 1) & ~(alignment - 1);
+
+#ifdef _WIN32
+    *ptr = _aligned_malloc(aligned_size, alignment);
+#else
+    *ptr = ::aligned_alloc(alignment, aligned_size);
+#endif
+
+    return (*ptr) ? UMF_RESULT_SUCCESS : UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+}
+
+static umf_result_t malloc_provider_free(void *provider, void *ptr,
+                                         size_t size) {
+    (void)provider;
+    (void)size;
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    ::free(ptr);
+#endif
+    return UMF_RESULT_SUCCESS;
+}
+
+static void malloc_provider_get_last_native_error(void *provider,
+                                                  const char **ppMessage,
+                                                  int32_t *pError) {
+    (void)provider;
+    *ppMessage = "";
+    *pError = 0;
+}
+
+static umf_result_t malloc_provider_get_recommended_page_size(void *provider,
+                                                              size_t size,
+                                                              size_t *pageSize) {
+    (void)provider;
+    (void)size;
+    *pageSize = 4096;
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t malloc_provider_get_min_page_size(void *provider,
+                                                      void *ptr,
+                                                      size_t *pageSize) {
+    (void)provider;
+    (void)ptr;
+    *pageSize = 4096;
+    return UMF_RESULT_SUCCESS;
+}
+
+static const char *malloc_provider_get_name(void *provider) {
+    (void)provider;
+    return "malloc";
+}
+
+static umf_memory_provider_ops_t *mallocProviderOps() {
+    static umf_memory_provider_ops_t ops = [] {
+        umf_memory_provider_ops_t o = {};
+        o.version = UMF_VERSION_CURRENT;
+        o.initialize = malloc_provider_initialize;
+        o.finalize = malloc_provider_finalize;
+        o.alloc = malloc_provider_alloc;
+        o.free = malloc_provider_free;
+        o.get_last_native_error = malloc_provider_get_last_native_error;
+        o.get_recommended_page_size =
+            malloc_provider_get_recommended_page_size;
+        o.get_min_page_size = malloc_provider_get_min_page_size;
+        o.get_name = malloc_provider_get_name;
+        return o;
+    }();
+    return &ops;
+}
+
+// Every allocation made through the proxy pool is inserted into (and removed
+// from) the memory tracker, so this measures how the tracker scales with
+// the number of concurrent writers.
+static void mt_tracker_writers(const bench_params &bench = bench_params()) {
+    for (size_t n_threads = 1; n_threads <= bench.n_threads; n_threads *= 2) {
+        bench_params params = bench;
+        params.n_threads = n_threads;
+
+        auto pool = poolCreateExtUnique(poolCreateExtParams{
+            umfProxyPoolOps(), nullptr, mallocProviderOps(), nullptr});
+
+        std::vector<std::vector<void *>> allocs(params.n_threads);
+        for (auto &v : allocs) {
+            v.reserve(params.n_iterations);
+        }
+
+        auto values = umf_bench::measure<std::chrono::milliseconds>(
+            params.n_repeats, params.n_threads,
+            [&, pool = pool.get()](auto thread_id) {
+                for (size_t i = 0; i < params.n_iterations; i++) {
+                    allocs[thread_id].push_back(
+                        umfPoolMalloc(pool, params.alloc_size));
+                }
+
+                for (size_t i = 0; i < params.n_iterations; i++) {
+                    umfPoolFree(pool, allocs[thread_id][i]);
+                }
+
+                allocs[thread_id].clear();
+            });
+
+        double mean = umf_bench::mean(values);
+        double ops = 2.0 * params.n_iterations * params.n_threads;
+        std::cout << "  threads: " << n_threads << " mean: " << mean
+                  << " [ms] std_dev: " << umf_bench::std_dev(values)
+                  << " [ms] throughput: "
+                  << (mean > 0 ? ops / mean : 0.0) << " [ops/ms]"
+                  << std::endl;
+    }
+}
+
+// Every thread allocates from (and frees to) its own proxy pool. The regions
+// of all the pools come from the same provider, so they are close to each
+// other in the address space, but they should still be tracked in different
+// shards of the memory tracker, so this measures how the tracker scales
+// with the number of pools used concurrently.
+static void mt_tracker_pools(const bench_params &bench = bench_params()) {
+    for (size_t n_threads = 1; n_threads <= bench.n_threads; n_threads *= 2) {
+        bench_params params = bench;
+        params.n_threads = n_threads;
+
+        std::vector<std::shared_ptr<umf_memory_pool_t>> pools;
+        std::vector<std::vector<void *>> allocs(params.n_threads);
+        for (auto &v : allocs) {
+            v.reserve(params.n_iterations);
+            pools.push_back(poolCreateExtUnique(poolCreateExtParams{
+                umfProxyPoolOps(), nullptr, mallocProviderOps(), nullptr}));
+        }
+
+        auto values = umf_bench::measure<std::chrono::milliseconds>(
+            params.n_repeats, params.n_threads, [&](auto thread_id) {
+                auto pool = pools[thread_id].get();
+                for (size_t i = 0; i < params.n_iterations; i++) {
+                    allocs[thread_id].push_back(
+                        umfPoolMalloc(pool, params.alloc_size));
+                }
+
+                for (size_t i = 0; i < params.n_iterations; i++) {
+                    umfPoolFree(pool, allocs[thread_id][i]);
+                }
+
+                allocs[thread_id].clear();
+            });
+
+        double mean = umf_bench::mean(values);
+        double ops = 2.0 * params.n_iterations * params.n_threads;
+        std::cout << "  threads: " << n_threads << " mean: " << mean
+                  << " [ms] std_dev: " << umf_bench::std_dev(values)
+                  << " [ms] throughput: "
+                  << (mean > 0 ? ops / mean : 0.0) << " [ops/ms]"
+                  << std::endl;
+    }
+}
+
+// Looks up pointers not tracked by the memory tracker (e.g. the stack),
+// which are never cached, while regions of a pool are tracked.
+static void mt_tracker_misses(const bench_params &bench = bench_params()) {
+    auto pool = poolCreateExtUnique(poolCreateExtParams{
+        umfProxyPoolOps(), nullptr, mallocProviderOps(), nullptr});
+
+    std::vector<void *> allocs;
+    for (size_t i = 0; i < bench.n_iterations; i++) {
+        allocs.push_back(umfPoolMalloc(pool.get(), bench.alloc_size));
+    }
+
+    std::vector<size_t> numFound(bench.n_threads);
+    auto values = umf_bench::measure<std::chrono::milliseconds>(
+        bench.n_repeats, bench.n_threads, [&](auto thread_id) {
+            char buf[64];
+            for (size_t i = 0; i < bench.n_iterations; i++) {
+                if (umfPoolByPtr(&buf[i % sizeof(buf)])) {
+                    numFound[thread_id]++;
+                }
+            }
+        });
+
+    for (auto ptr : allocs) {
+        umfPoolFree(pool.get(), ptr);
+    }
+
+    std::cout << "mean: " << umf_bench::mean(values)
+              << " [ms] std_dev: " << umf_bench::std_dev(values) << " [ms]"
+              << " (untracked pointers found: "
+              << std::accumulate(numFound.begin(), numFound.end(), 0ULL)
+              << ")" << std::endl;
+}
+
 int main() {
     auto osParams = umfOsMemoryProviderParamsDefault();
 
@@ -112,20 +321,52 @@ int main() {
     std::cout << "jemalloc_pool mt_alloc_free: ";
     mt_alloc_free(poolCreateExtParams{umfJemallocPoolOps(), nullptr,
                                       umfOsMemoryProviderOps(), &osParams});
+
+    auto jemallocParams = umfJemallocPoolParamsDefault();
+    jemallocParams.n_arenas = 0; // one arena per CPU
+
+    std::cout << "jemalloc_pool (arena per CPU) mt_alloc_free: ";
+    mt_alloc_free(poolCreateExtParams{umfJemallocPoolOps(), &jemallocParams,
+                                      umfOsMemoryProviderOps(), &osParams});
 #else
     std::cout << "skipping jemalloc_pool mt_alloc_free" << std::endl;
 #endif
 
 #if defined(UMF_BUILD_LIBUMF_POOL_DISJOINT)
+    // the default params do not pool anything
     auto disjointParams = umfDisjointPoolParamsDefault();
+    disjointParams.SlabMinSize = 64 * 1024;
+    disjointParams.MaxPoolableSize = 64 * 1024;
+    disjointParams.Capacity = 4;
+    disjointParams.MinBucketSize = 64;
 
     std::cout << "disjoint_pool mt_alloc_free: ";
     mt_alloc_free(poolCreateExtParams{umfDisjointPoolOps(), &disjointParams,
                                       umfOsMemoryProviderOps(), &osParams});
+
+    auto disjointCachedParams = disjointParams;
+    disjointCachedParams.ThreadCacheSize = 64;
+
+    std::cout << "disjoint_pool (thread cache) mt_alloc_free: ";
+    mt_alloc_free(poolCreateExtParams{umfDisjointPoolOps(),
+                                      &disjointCachedParams,
+                                      umfOsMemoryProviderOps(), &osParams});
 #else
     std::cout << "skipping disjoint_pool mt_alloc_free" << std::endl;
 #endif
 
+    bench_params trackerParams;
+    trackerParams.n_threads = 16;
+
+    std::cout << "proxy_pool mt_tracker_writers:" << std::endl;
+    mt_tracker_writers(trackerParams);
+
+    std::cout << "proxy_pool mt_tracker_pools:" << std::endl;
+    mt_tracker_pools(trackerParams);
+
+    std::cout << "proxy_pool mt_tracker_misses: ";
+    mt_tracker_misses(trackerParams);
+
     // ctest looks for "PASSED" in the output
     std::cout << "PASSED" << std::endl;
 
@@ -63,6 +63,14 @@
 #define DISJOINT_POOL_CAPACITY (N_ITERATIONS + 10)
 #define DISJOINT_POOL_MIN_BUCKET_SIZE (ALLOC_SIZE)
 
+// FREE PATH CONFIG
+// small objects, so that many of them share a single slab of the pool
+#define FREE_PATH_ALLOC_SIZE 64
+#define FREE_PATH_SLAB_MIN_SIZE (64 * 1024)
+// must not be 0 (the default), otherwise all allocations would go
+// directly to the provider and the benchmark would measure the provider
+#define FREE_PATH_MAX_POOLABLE_SIZE (FREE_PATH_SLAB_MIN_SIZE)
+
 typedef struct alloc_s {
     void *ptr;
     size_t size;
@@ -137,6 +145,16 @@ static umf_os_memory_provider_params_t UMF_OS_MEMORY_PROVIDER_PARAMS = {
 
     /* .partitions = */ NULL,
     /* .partitions_len = */ 0,
+
+    // huge pages config
+    /* .huge_pages = */ UMF_HUGE_PAGES_NONE,
+    /* .huge_page_size = */ 0,
+
+    /* .reserve_size = */ 0,
+
+    // populate config
+    /* .populate = */ 0,
+    /* .populate_threads = */ 0,
 };
 
 static void *w_umfMemoryProviderAlloc(void *provider, size_t size,
@@ -246,6 +264,17 @@ UBENCH_EX(simple, proxy_pool_with_os_memory_provider) {
 #if (defined UMF_BUILD_LIBUMF_POOL_DISJOINT)
 ////////////////// DISJOINT POOL WITH OS MEMORY PROVIDER
 
+static void w_umfFree(void *provider, void *ptr, size_t size) {
+    (void)provider; // unused
+    (void)size;     // unused
+    umf_result_t umf_result;
+    umf_result = umfFree(ptr);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfFree() failed\n");
+        exit(-1);
+    }
+}
+
 UBENCH_EX(simple, disjoint_pool_with_os_memory_provider) {
     alloc_t *array = alloc_array(N_ITERATIONS);
 
@@ -286,6 +315,61 @@ UBENCH_EX(simple, disjoint_pool_with_os_memory_provider) {
     umfMemoryProviderDestroy(os_memory_provider);
     free(array);
 }
+
+////////////////// FREE PATH OF DISJOINT POOL: umfPoolFree() vs umfFree()
+
+// umfFree() has to find the pool of the pointer in the memory tracker,
+// while umfPoolFree() gets the pool from the caller. The difference between
+// these two benchmarks is the cost of the tracker lookup.
+static void do_free_path_benchmark(struct ubench_run_state_s *ubench_run_state,
+                                   free_t free_f) {
+    alloc_t *array = alloc_array(N_ITERATIONS);
+    Alloc_size = FREE_PATH_ALLOC_SIZE;
+
+    umf_result_t umf_result;
+    umf_memory_provider_handle_t os_memory_provider = NULL;
+    umf_result = umfMemoryProviderCreate(umfOsMemoryProviderOps(),
+                                         &UMF_OS_MEMORY_PROVIDER_PARAMS,
+                                         &os_memory_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfMemoryProviderCreate() failed\n");
+        exit(-1);
+    }
+
+    umf_disjoint_pool_params_t disjoint_memory_pool_params =
+        umfDisjointPoolParamsDefault();
+    disjoint_memory_pool_params.SlabMinSize = FREE_PATH_SLAB_MIN_SIZE;
+    disjoint_memory_pool_params.MaxPoolableSize = FREE_PATH_MAX_POOLABLE_SIZE;
+    disjoint_memory_pool_params.Capacity = DISJOINT_POOL_CAPACITY;
+
+    umf_memory_pool_handle_t disjoint_pool;
+    umf_result = umfPoolCreate(umfDisjointPoolOps(), os_memory_provider,
+                               &disjoint_memory_pool_params, 0, &disjoint_pool);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfPoolCreate() failed\n");
+        exit(-1);
+    }
+
+    do_benchmark(array, N_ITERATIONS, w_umfPoolMalloc, free_f,
+                 disjoint_pool); // WARMUP
+
+    UBENCH_DO_BENCHMARK() {
+        do_benchmark(array, N_ITERATIONS, w_umfPoolMalloc, free_f,
+                     disjoint_pool);
+    }
+
+    umfPoolDestroy(disjoint_pool);
+    umfMemoryProviderDestroy(os_memory_provider);
+    free(array);
+}
+
+UBENCH_EX(free_path, disjoint_pool_umfPoolFree) {
+    do_free_path_benchmark(ubench_run_state, w_umfPoolFree);
+}
+
+UBENCH_EX(free_path, disjoint_pool_umfFree) {
+    do_free_path_benchmark(ubench_run_state, w_umfFree);
+}
 #endif /* (defined UMF_BUILD_LIBUMF_POOL_DISJOINT) */
 
 #if (defined UMF_BUILD_LIBUMF_POOL_JEMALLOC)
@@ -170,6 +170,20 @@ umf_memory_pool_handle_t umfPoolByPtr(const void *ptr);
 umf_result_t umfPoolGetMemoryProvider(umf_memory_pool_handle_t hPool,
                                       umf_memory_provider_handle_t *hProvider);
 
+///
+/// @brief Releases free memory held by the pool back to its memory provider,
+///        e.g. before forking worker processes or under memory pressure.
+///        Memory allocated from the pool is not affected.
+/// @param hPool specified memory pool
+/// @param size number of bytes to release, 0 to release as much as possible.
+///        The pool may release more memory than requested.
+/// @param released [out] optional, number of bytes actually released
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if the pool does not support trimming
+///
+umf_result_t umfPoolTrim(umf_memory_pool_handle_t hPool, size_t size,
+                         size_t *released);
+
 #ifdef __cplusplus
 }
 #endif
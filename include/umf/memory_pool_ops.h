@@ -25,6 +25,8 @@ extern "C" {
 typedef struct umf_memory_pool_ops_t {
     /// Version of the ops structure.
     /// Should be initialized using UMF_VERSION_CURRENT.
+    /// The ops of the versions from 0.9 on are accepted, the ops added
+    /// in later versions are treated as NULL for the older versions.
     uint32_t version;
 
     ///
@@ -120,6 +122,18 @@ typedef struct umf_memory_pool_ops_t {
     ///         The value is undefined if the previous allocation was successful.
     ///
     umf_result_t (*get_last_allocation_error)(void *pool);
+
+    ///
+    /// @brief Releases free memory held by the \p pool back to its memory provider.
+    ///        This operation is optional, it may be set to NULL if the pool
+    ///        does not support it. Available since the version 0.10 of the ops.
+    /// @param pool pointer to the memory pool
+    /// @param size number of bytes to release, 0 to release as much as possible.
+    ///        The pool may release more memory than requested.
+    /// @param released [out] number of bytes actually released
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+    ///
+    umf_result_t (*trim)(void *pool, size_t size, size_t *released);
 } umf_memory_pool_ops_t;
 
 #ifdef __cplusplus
@@ -136,6 +136,56 @@ umf_result_t umfMemoryProviderPurgeLazy(umf_memory_provider_handle_t hProvider,
 umf_result_t umfMemoryProviderPurgeForce(umf_memory_provider_handle_t hProvider,
                                          void *ptr, size_t size);
 
+///
+/// @brief Commit physical memory to back the pages within the virtual memory mapping
+///        associated at the given addr and \p size, which were decommitted before.
+///        The pages are zero-filled on the next access.
+/// @param hProvider handle to the memory provider
+/// @param ptr beginning of the virtual memory range
+/// @param size size of the virtual memory range
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         UMF_RESULT_ERROR_INVALID_ALIGNMENT if ptr or size is not page-aligned.
+///         UMF_RESULT_ERROR_INVALID_ARGUMENT if the range is known not to be allocated
+///         from this provider (e.g. it is not owned by the pool of the provider).
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if operation is not supported by this provider.
+///
+umf_result_t umfMemoryProviderCommit(umf_memory_provider_handle_t hProvider,
+                                     void *ptr, size_t size);
+
+///
+/// @brief Decommit physical memory backing the pages within the virtual memory mapping
+///        associated at the given addr and \p size. The virtual memory range stays reserved,
+///        but it cannot be accessed until it is committed with umfMemoryProviderCommit().
+/// @param hProvider handle to the memory provider
+/// @param ptr beginning of the virtual memory range
+/// @param size size of the virtual memory range
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         UMF_RESULT_ERROR_INVALID_ALIGNMENT if ptr or size is not page-aligned.
+///         UMF_RESULT_ERROR_INVALID_ARGUMENT if the range is known not to be allocated
+///         from this provider (e.g. it is not owned by the pool of the provider).
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if operation is not supported by this provider.
+///
+umf_result_t umfMemoryProviderDecommit(umf_memory_provider_handle_t hProvider,
+                                       void *ptr, size_t size);
+
+///
+/// @brief Allocate \p size bytes of memory from the specified memory provider like
+///        umfMemoryProviderAlloc() and report whether the allocated memory is known
+///        to be zero-filled (e.g. pages freshly mapped from the OS), so that the caller
+///        does not have to zero it (and touch all its pages).
+/// @param hProvider handle to the memory provider
+/// @param size number of bytes to allocate
+/// @param alignment alignment of the allocation in bytes, it has to be a multiple or a divider of the minimum page size
+/// @param ptr [out] pointer to the allocated memory
+/// @param zeroed [out] set to 1 if the allocated memory is zero-filled,
+///        0 if it is not known (always for providers not reporting it)
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+///
+umf_result_t
+umfMemoryProviderAllocWithZeroInfo(umf_memory_provider_handle_t hProvider,
+                                   size_t size, size_t alignment, void **ptr,
+                                   int *zeroed);
+
 ///
 /// @brief Retrieve the size of opaque data structure required to store IPC data.
 /// \param hProvider [in] handle to the memory provider.
@@ -78,6 +78,55 @@ typedef struct umf_memory_provider_ext_ops_t {
     umf_result_t (*allocation_split)(void *hProvider, void *ptr,
                                      size_t totalSize, size_t firstSize);
 
+    ///
+    /// @brief Commit physical memory to back the pages within the virtual memory mapping
+    ///        associated at the given addr and \p size, which were decommitted before.
+    ///        The pages are zero-filled on the next access.
+    ///        Available since the version 0.10 of the ops.
+    /// @param provider pointer to the memory provider
+    /// @param ptr beginning of the virtual memory range
+    /// @param size size of the virtual memory range
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+    ///         UMF_RESULT_ERROR_INVALID_ALIGNMENT if ptr or size is not page-aligned.
+    ///         UMF_RESULT_ERROR_INVALID_ARGUMENT if the range is known not to be allocated
+    ///         from this provider (e.g. it is not owned by the pool of the provider).
+    ///         UMF_RESULT_ERROR_NOT_SUPPORTED if operation is not supported by this provider.
+    ///
+    umf_result_t (*commit)(void *provider, void *ptr, size_t size);
+
+    ///
+    /// @brief Decommit physical memory backing the pages within the virtual memory mapping
+    ///        associated at the given addr and \p size. The virtual memory range stays reserved,
+    ///        but it cannot be accessed until it is committed again.
+    ///        Available since the version 0.10 of the ops.
+    /// @param provider pointer to the memory provider
+    /// @param ptr beginning of the virtual memory range
+    /// @param size size of the virtual memory range
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+    ///         UMF_RESULT_ERROR_INVALID_ALIGNMENT if ptr or size is not page-aligned.
+    ///         UMF_RESULT_ERROR_INVALID_ARGUMENT if the range is known not to be allocated
+    ///         from this provider (e.g. it is not owned by the pool of the provider).
+    ///         UMF_RESULT_ERROR_NOT_SUPPORTED if operation is not supported by this provider.
+    ///
+    umf_result_t (*decommit)(void *provider, void *ptr, size_t size);
+
+    ///
+    /// @brief Allocate \p size bytes of memory like alloc() and report whether the allocated
+    ///        memory is known to be zero-filled (e.g. pages freshly mapped from the OS),
+    ///        so that the caller does not have to zero it.
+    ///        If it is NULL, alloc() is used and the memory is reported as not zero-filled.
+    ///        Available since the version 0.10 of the ops.
+    /// @param provider pointer to the memory provider
+    /// @param size number of bytes to allocate
+    /// @param alignment alignment of the allocation in bytes, it has to be a multiple or a divider of the minimum page size
+    /// @param ptr [out] pointer to the allocated memory
+    /// @param zeroed [out] set to 1 if the allocated memory is zero-filled, 0 if it is not known
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+    ///
+    umf_result_t (*alloc_with_zero_info)(void *provider, size_t size,
+                                         size_t alignment, void **ptr,
+                                         int *zeroed);
+
 } umf_memory_provider_ext_ops_t;
 
 ///
@@ -144,6 +193,8 @@ typedef struct umf_memory_provider_ipc_ops_t {
 typedef struct umf_memory_provider_ops_t {
     /// Version of the ops structure.
     /// Should be initialized using UMF_VERSION_CURRENT.
+    /// The ops of the versions from 0.9 on are accepted, the ops added
+    /// in later versions are treated as NULL for the older versions.
     uint32_t version;
 
     ///
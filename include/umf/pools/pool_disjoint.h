@@ -58,10 +58,69 @@ typedef struct umf_disjoint_pool_params_t {
 
     /// Name used in traces
     const char *Name;
+
+    /// Maximum number of free chunks of each bucket cached by each thread.
+    /// Chunks are moved between the caches and the buckets in batches,
+    /// so most allocations and deallocations do not lock the bucket.
+    /// 0 disables the per-thread caches.
+    size_t ThreadCacheSize;
+
+    /// Time in milliseconds after which a slab idle in the pool is purged
+    /// with umfMemoryProviderPurgeLazy(). A slab idle for twice that time
+    /// is returned to the memory provider. The decay is done by the
+    /// allocations and deallocations of the pool, so the pool keeps its
+    /// slabs while it is not used. 0 disables the decay and the pooled
+    /// slabs are kept until the pool is destroyed.
+    size_t DecayMs;
 } umf_disjoint_pool_params_t;
 
 umf_memory_pool_ops_t *umfDisjointPoolOps(void);
 
+/// @brief Statistics of a single bucket of a disjoint pool
+typedef struct umf_disjoint_pool_bucket_stats_t {
+    /// Size of the allocations served by the bucket
+    size_t Size;
+
+    /// Alignment of the slabs of the bucket, 0 for the regular buckets
+    size_t Alignment;
+
+    /// Number of slabs currently in use and its peak value
+    size_t SlabsInUse;
+    size_t PeakSlabsInUse;
+
+    /// Number of free slabs currently kept in the pool and its peak value
+    size_t SlabsInPool;
+    size_t PeakSlabsInPool;
+
+    /// Number of chunks currently allocated from the slabs of the bucket,
+    /// including the free chunks held by the per-thread caches
+    size_t ChunksAllocated;
+
+    /// Total number of allocations and deallocations served by the bucket
+    size_t AllocCount;
+    size_t FreeCount;
+
+    /// Number of allocations served from the memory already held
+    /// by the pool and of allocations which had to get a new slab
+    /// from the memory provider
+    size_t PoolHits;
+    size_t PoolMisses;
+} umf_disjoint_pool_bucket_stats_t;
+
+/// @brief Get the statistics of the buckets of a disjoint pool.
+///        The statistics are always collected, regardless of PoolTrace.
+/// @param hPool handle to a disjoint pool
+/// @param Stats array of NumBuckets elements to be filled with the statistics
+///        of the buckets or NULL to query the number of buckets only
+/// @param NumBuckets [inout] on input the number of elements of Stats,
+///        on output the number of buckets of the pool. If it is bigger than
+///        the input value, only that many buckets are reported.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+umf_result_t
+umfDisjointPoolGetStats(umf_memory_pool_handle_t hPool,
+                        umf_disjoint_pool_bucket_stats_t *Stats,
+                        size_t *NumBuckets);
+
 /// @brief Create default params struct for disjoint pool
 static inline umf_disjoint_pool_params_t umfDisjointPoolParamsDefault(void) {
     umf_disjoint_pool_params_t params = {
@@ -72,7 +131,9 @@ static inline umf_disjoint_pool_params_t umfDisjointPoolParamsDefault(void) {
         0,                                         /* CurPoolSize */
         0,                                         /* PoolTrace */
         NULL,                                      /* SharedLimits */
-        "disjoint_pool"                            /* Name */
+        "disjoint_pool",                           /* Name */
+        0,                                         /* ThreadCacheSize */
+        0                                          /* DecayMs */
     };
 
     return params;
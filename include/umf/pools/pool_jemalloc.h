@@ -14,10 +14,66 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <umf/memory_pool_ops.h>
 
+/// @brief Value of the decay times of umf_jemalloc_pool_params_t
+///        keeping the default of jemalloc
+#define UMF_JEMALLOC_POOL_DECAY_DEFAULT (-2)
+
+/// @brief Policy of selecting the arena of a jemalloc pool used by a thread
+typedef enum umf_jemalloc_pool_arena_selection_t {
+    /// Threads are assigned to the arenas round-robin on their first use
+    /// of any jemalloc pool and always use the same arena
+    UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD = 0,
+    /// Threads use the arena of the CPU they are currently running on
+    UMF_JEMALLOC_POOL_ARENA_SELECTION_CPU,
+} umf_jemalloc_pool_arena_selection_t;
+
+/// @brief Configuration of the jemalloc pool
+typedef struct umf_jemalloc_pool_params_t {
+    /// Number of jemalloc arenas of the pool, 1 by default. Threads using
+    /// different arenas do not contend with each other, but each arena keeps
+    /// its own free memory. 0 means one arena per CPU (but not more than 64).
+    unsigned n_arenas;
+    /// Policy of selecting the arena used by a thread
+    umf_jemalloc_pool_arena_selection_t arena_selection;
+    /// Time in milliseconds after which unused dirty pages are purged lazily
+    /// (see dirty_decay_ms of jemalloc). -1 disables the decay, 0 purges
+    /// the pages immediately, UMF_JEMALLOC_POOL_DECAY_DEFAULT keeps
+    /// the default of jemalloc.
+    int64_t dirty_decay_ms;
+    /// Time in milliseconds after which lazily purged pages are purged with
+    /// force (see muzzy_decay_ms of jemalloc), the values as above.
+    int64_t muzzy_decay_ms;
+    /// If non-zero, the extents freed by the arenas are only purged and kept
+    /// for later reuse instead of being returned to the memory provider
+    /// (they are returned when the pool is destroyed).
+    int retain;
+    /// Maximum size of the memory requested from the memory provider when
+    /// an arena grows (see arena.<i>.retain_grow_limit of jemalloc, effective
+    /// only if jemalloc is configured with opt.retain). 0 keeps the default.
+    size_t retain_grow_limit;
+} umf_jemalloc_pool_params_t;
+
 umf_memory_pool_ops_t *umfJemallocPoolOps(void);
 
+/// @brief Create default params struct for jemalloc pool
+static inline umf_jemalloc_pool_params_t umfJemallocPoolParamsDefault(void) {
+    umf_jemalloc_pool_params_t params = {
+        1,                                        /* n_arenas */
+        UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD, /* arena_selection */
+        UMF_JEMALLOC_POOL_DECAY_DEFAULT,          /* dirty_decay_ms */
+        UMF_JEMALLOC_POOL_DECAY_DEFAULT,          /* muzzy_decay_ms */
+        0,                                        /* retain */
+        0                                         /* retain_grow_limit */
+    };
+
+    return params;
+}
+
 #ifdef __cplusplus
 }
 #endif
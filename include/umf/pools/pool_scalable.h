@@ -14,11 +14,40 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
+
 #include <umf/memory_pool.h>
 #include <umf/memory_provider.h>
 
+/// @brief Default granularity of the memory requested by the scalable pool
+///        from the memory provider
+#define UMF_SCALABLE_POOL_GRANULARITY_DEFAULT (2 * 1024 * 1024)
+
+/// @brief Configuration of the scalable pool
+typedef struct umf_scalable_pool_params_t {
+    /// Granularity of the memory requested from the memory provider in bytes.
+    /// It is rounded up to a multiple of the recommended page size of
+    /// the provider, so the chunks of the pool line up with its pages.
+    /// 0 means UMF_SCALABLE_POOL_GRANULARITY_DEFAULT.
+    size_t granularity;
+    /// If non-zero, the pool keeps all the memory requested from the memory
+    /// provider until it is destroyed, instead of returning the unused
+    /// memory to the provider.
+    int keep_all_memory;
+} umf_scalable_pool_params_t;
+
 umf_memory_pool_ops_t *umfScalablePoolOps(void);
 
+/// @brief Create default params struct for scalable pool
+static inline umf_scalable_pool_params_t umfScalablePoolParamsDefault(void) {
+    umf_scalable_pool_params_t params = {
+        UMF_SCALABLE_POOL_GRANULARITY_DEFAULT, /* granularity */
+        0                                      /* keep_all_memory */
+    };
+
+    return params;
+}
+
 #ifdef __cplusplus
 }
 #endif
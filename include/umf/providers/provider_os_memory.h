@@ -77,11 +77,35 @@ typedef struct umf_numa_split_partition_t {
     unsigned target;
 } umf_numa_split_partition_t;
 
+/// @brief Huge pages mode
+/// Specifies whether and how the memory of the allocations is backed by
+/// huge pages. Huge pages are supported on Linux only, on other systems
+/// the regular pages are used.
+typedef enum umf_huge_pages_mode_t {
+    /// Regular pages are used (default)
+    UMF_HUGE_PAGES_NONE = 0,
+
+    /// The allocations are aligned to the huge page size and the kernel is
+    /// advised to back them with transparent huge pages (MADV_HUGEPAGE).
+    /// The kernel falls back to regular pages if no huge page is available.
+    UMF_HUGE_PAGES_TRANSPARENT,
+
+    /// The allocations are backed by huge pages reserved in the system
+    /// (MAP_HUGETLB). If no huge pages of the requested size are reserved
+    /// or all of them are in use, transparent huge pages are used instead.
+    /// It is not supported for the UMF_MEM_MAP_SHARED memory visibility mode.
+    UMF_HUGE_PAGES_EXPLICIT,
+} umf_huge_pages_mode_t;
+
 /// @brief Memory provider settings struct
 typedef struct umf_os_memory_provider_params_t {
     /// Combination of 'umf_mem_protection_flags_t' flags
     unsigned protection;
     /// memory visibility mode
+    /// In the UMF_MEM_MAP_SHARED mode the file ranges of the freed allocations
+    /// are hole-punched and reused by the next allocations, so all the IPC
+    /// handles of an allocation opened by other processes have to be closed
+    /// (umfCloseIPCHandle()) before the allocation is freed.
     umf_memory_visibility_t visibility;
     /// (optional) a name of a shared memory file (valid only in case of the shared memory visibility)
     char *shm_name;
@@ -95,13 +119,33 @@ typedef struct umf_os_memory_provider_params_t {
     /// Describes how node list is interpreted
     umf_numa_mode_t numa_mode;
     /// part size for interleave mode - 0 means default (system specific)
-    /// It might be rounded up because of HW constraints
+    /// It might be rounded up because of HW constraints.
+    /// Parts of (at most) one page are interleaved by the kernel with a single
+    /// memory binding per allocation if numa_list is in the ascending order
+    /// (the first page does not have to be placed on the first node then).
     size_t part_size;
 
     /// ordered list of the partitions for the split mode
     umf_numa_split_partition_t *partitions;
     /// len of the partitions array
     unsigned partitions_len;
+
+    /// huge pages mode
+    umf_huge_pages_mode_t huge_pages;
+    /// size of a huge page - 0 means the default huge page size of the system
+    /// (e.g. 2MB or 1GB on x86-64)
+    size_t huge_page_size;
+
+    /// size of the address space reserved up front to carve the allocations
+    /// from - 0 means no reservation (every allocation is mapped separately)
+    size_t reserve_size;
+
+    /// populate (prefault) the memory at the allocation time, so that
+    /// the first touch of the memory does not take the page faults
+    int populate;
+    /// number of threads (including the allocating one) populating large
+    /// allocations in parallel - 0 or 1 means the allocating thread only
+    unsigned populate_threads;
 } umf_os_memory_provider_params_t;
 
 /// @brief OS Memory Provider operation results
@@ -114,6 +158,8 @@ typedef enum umf_os_memory_provider_native_error {
     UMF_OS_RESULT_ERROR_PURGE_LAZY_FAILED,     ///< Lazy purging failed
     UMF_OS_RESULT_ERROR_PURGE_FORCE_FAILED,    ///< Force purging failed
     UMF_OS_RESULT_ERROR_TOPO_DISCOVERY_FAILED, ///< HWLOC topology discovery failed
+    UMF_OS_RESULT_ERROR_COMMIT_FAILED,         ///< Committing memory failed
+    UMF_OS_RESULT_ERROR_DECOMMIT_FAILED,       ///< Decommitting memory failed
 } umf_os_memory_provider_native_error_t;
 
 umf_memory_provider_ops_t *umfOsMemoryProviderOps(void);
@@ -130,7 +176,12 @@ umfOsMemoryProviderParamsDefault(void) {
         UMF_NUMA_MODE_DEFAULT, /* numa_mode */
         0,                     /* part_size */
         NULL,                  /* partitions */
-        0};                    /* partitions_len*/
+        0,                     /* partitions_len*/
+        UMF_HUGE_PAGES_NONE,   /* huge_pages */
+        0,                     /* huge_page_size */
+        0,                     /* reserve_size */
+        0,                     /* populate */
+        0};                    /* populate_threads */
 
     return params;
 }
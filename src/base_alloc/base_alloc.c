@@ -23,6 +23,15 @@
 // alignment of the base allocator
 #define MEMORY_ALIGNMENT (sizeof(uintptr_t))
 
+// maximum number of free chunks of a pool cached by a thread (a magazine)
+#define MAGAZINE_SIZE (16)
+
+// number of chunks moved at once between a magazine and the free list
+#define MAGAZINE_BATCH (MAGAZINE_SIZE / 2)
+
+// maximum number of pools a thread caches free chunks of
+#define MAGAZINES_PER_THREAD (8)
+
 typedef struct umf_ba_chunk_t umf_ba_chunk_t;
 typedef struct umf_ba_next_pool_t umf_ba_next_pool_t;
 
@@ -38,7 +47,10 @@ struct umf_ba_main_pool_meta_t {
     size_t chunk_size;         // size of all memory chunks in this pool
     os_mutex_t free_lock;      // lock of free_list
     umf_ba_chunk_t *free_list; // list of free chunks
-    size_t n_allocs;           // number of allocated chunks
+    size_t n_allocs;  // number of chunks not on free_list (incl. n_cached)
+    size_t n_cached;  // number of chunks cached in magazines of threads
+    uint64_t id;      // unique id of the pool, never reused
+    umf_ba_pool_t *next_live; // next pool on the list of live pools
 #ifndef NDEBUG
     size_t n_pools;
     size_t n_chunks;
@@ -66,6 +78,48 @@ struct umf_ba_next_pool_t {
     char data[];
 };
 
+// A thread-local LIFO cache of free chunks of one pool. Chunks are moved
+// between a magazine and the free list of the pool in batches, so most of
+// umf_ba_alloc() and umf_ba_free() calls do not take the lock of the pool.
+typedef struct ba_magazine_t {
+    umf_ba_pool_t *pool;
+    uint64_t pool_id; // 0 if the magazine is not used
+    size_t n_chunks;
+    umf_ba_chunk_t *chunks[MAGAZINE_SIZE];
+} ba_magazine_t;
+
+typedef struct ba_thread_cache_t {
+    ba_magazine_t magazines[MAGAZINES_PER_THREAD];
+    // set while the thread-exit callback is being registered - the OS
+    // can allocate memory for it (e.g. glibc for the thread-specific data),
+    // which may come back here (e.g. through the proxy library)
+    int registering_exit;
+} ba_thread_cache_t;
+
+static __TLS ba_thread_cache_t TLS_ba_cache;
+
+// All live pools are kept on a list, so that the magazines of an exiting
+// thread are returned only to pools which were not destroyed in the meantime
+// (a pool can also be destroyed and created again at the same address,
+// so pools are identified by their unique id too).
+static UTIL_ONCE_FLAG Live_pools_is_initialized = UTIL_ONCE_FLAG_INIT;
+static os_mutex_t Live_pools_lock;
+static umf_ba_pool_t *Live_pools;
+static uint64_t Last_pool_id;
+
+static void ba_init_live_pools(void) { util_mutex_init(&Live_pools_lock); }
+
+// Should be called under Live_pools_lock
+static int ba_pool_is_live(umf_ba_pool_t *pool, uint64_t id) {
+    for (umf_ba_pool_t *p = Live_pools; p; p = p->metadata.next_live) {
+        if (p == pool) {
+            return p->metadata.id == id;
+        }
+    }
+
+    return 0;
+}
+
 #ifndef NDEBUG
 static void ba_debug_checks(umf_ba_pool_t *pool) {
     // count pools
@@ -158,6 +212,7 @@ umf_ba_pool_t *umf_ba_create(size_t size) {
     pool->metadata.chunk_size = chunk_size;
     pool->next_pool = NULL; // this is the only pool now
     pool->metadata.n_allocs = 0;
+    pool->metadata.n_cached = 0;
 #ifndef NDEBUG
     pool->metadata.n_pools = 1;
     pool->metadata.n_chunks = 0;
@@ -180,17 +235,47 @@ umf_ba_pool_t *umf_ba_create(size_t size) {
     pool->metadata.free_list = NULL;
     ba_divide_memory_into_chunks(pool, data_ptr, size_left);
 
+    util_init_once(&Live_pools_is_initialized, ba_init_live_pools);
+    util_mutex_lock(&Live_pools_lock);
+    pool->metadata.id = ++Last_pool_id;
+    pool->metadata.next_live = Live_pools;
+    Live_pools = pool;
+    util_mutex_unlock(&Live_pools_lock);
+
     return pool;
 }
 
-void *umf_ba_alloc(umf_ba_pool_t *pool) {
-    util_mutex_lock(&pool->metadata.free_lock);
+#ifndef NDEBUG
+// Checks if given pointer belongs to the pool. Should be called
+// under the lock
+static int pool_contains_pointer(umf_ba_pool_t *pool, void *ptr) {
+    char *cptr = (char *)ptr;
+    if (cptr >= pool->data &&
+        cptr < ((char *)(pool)) + pool->metadata.pool_size) {
+        return 1;
+    }
+
+    umf_ba_next_pool_t *next_pool = pool->next_pool;
+    while (next_pool) {
+        if (cptr >= next_pool->data &&
+            cptr < ((char *)(next_pool)) + pool->metadata.pool_size) {
+            return 1;
+        }
+        next_pool = next_pool->next_pool;
+    }
+
+    return 0;
+}
+#endif
+
+// Takes a chunk from the free list, allocating a new pool if it is empty.
+// Should be called under the free_lock. The chunk stays inaccessible.
+static umf_ba_chunk_t *ba_take_chunk(umf_ba_pool_t *pool) {
     if (pool->metadata.free_list == NULL) {
         umf_ba_next_pool_t *new_pool =
             (umf_ba_next_pool_t *)ba_os_alloc_annotated(
                 pool->metadata.pool_size);
         if (!new_pool) {
-            util_mutex_unlock(&pool->metadata.free_lock);
             return NULL;
         }
 
@@ -215,52 +300,182 @@ void *umf_ba_alloc(umf_ba_pool_t *pool) {
 
     umf_ba_chunk_t *chunk = pool->metadata.free_list;
 
-    // mark the memory defined to read the next ptr, after this is done
-    // we'll mark the memory as undefined
-    utils_annotate_memory_defined(chunk, sizeof(*chunk));
-
     // check if the free list is not empty
-    if (pool->metadata.free_list == NULL) {
+    if (chunk == NULL) {
         LOG_ERR("base_alloc: Free list should not be empty before new alloc");
         return NULL;
     }
 
-    pool->metadata.free_list = pool->metadata.free_list->next;
+    // mark the memory defined to read the next ptr
+    utils_annotate_memory_defined(chunk, sizeof(*chunk));
+    pool->metadata.free_list = chunk->next;
+    utils_annotate_memory_inaccessible(chunk, sizeof(*chunk));
+
     pool->metadata.n_allocs++;
+
+    return chunk;
+}
+
+// Puts a chunk back on the free list. Should be called under the free_lock.
+static void ba_put_chunk(umf_ba_pool_t *pool, umf_ba_chunk_t *chunk) {
+    assert(pool_contains_pointer(pool, chunk));
+
+    utils_annotate_memory_undefined(chunk, sizeof(*chunk));
+    chunk->next = pool->metadata.free_list;
+    utils_annotate_memory_inaccessible(chunk, sizeof(*chunk));
+
+    pool->metadata.free_list = chunk;
+    pool->metadata.n_allocs--;
+}
+
+// Returns the magazine of the calling thread for the given pool
+// or NULL if the thread cannot cache chunks of one more pool.
+static ba_magazine_t *ba_get_magazine(umf_ba_pool_t *pool) {
+    ba_thread_cache_t *cache = &TLS_ba_cache;
+    ba_magazine_t *unused = NULL;
+
+    for (int i = 0; i < MAGAZINES_PER_THREAD; i++) {
+        ba_magazine_t *magazine = &cache->magazines[i];
+        if (magazine->pool == pool &&
+            magazine->pool_id == pool->metadata.id) {
+            return magazine;
+        }
+
+        if (!unused && magazine->pool_id == 0) {
+            unused = magazine;
+        }
+    }
+
+    if (!unused) {
+        // Release magazines of destroyed pools. Their chunks were freed
+        // together with the pool, so they are just forgotten.
+        util_mutex_lock(&Live_pools_lock);
+        for (int i = 0; i < MAGAZINES_PER_THREAD; i++) {
+            ba_magazine_t *magazine = &cache->magazines[i];
+            if (!ba_pool_is_live(magazine->pool, magazine->pool_id)) {
+                magazine->pool_id = 0;
+                magazine->n_chunks = 0;
+                if (!unused) {
+                    unused = magazine;
+                }
+            }
+        }
+        util_mutex_unlock(&Live_pools_lock);
+
+        if (!unused) {
+            return NULL;
+        }
+    }
+
+    if (cache->registering_exit) {
+        // the chunks of a nested allocation are taken from the free list
+        return NULL;
+    }
+
+    cache->registering_exit = 1;
+    int ret = ba_os_notify_on_thread_exit();
+    cache->registering_exit = 0;
+    if (ret) {
+        // the cached chunks would be leaked on thread exit
+        return NULL;
+    }
+
+    unused->pool = pool;
+    unused->pool_id = pool->metadata.id;
+    unused->n_chunks = 0;
+
+    return unused;
+}
+
+// Moves up to 'count' chunks from the free list to the magazine.
+// Returns the number of chunks moved.
+static size_t ba_magazine_refill(umf_ba_pool_t *pool, ba_magazine_t *magazine,
+                                 size_t count) {
+    size_t n = 0;
+
+    util_mutex_lock(&pool->metadata.free_lock);
+    while (n < count) {
+        umf_ba_chunk_t *chunk = ba_take_chunk(pool);
+        if (!chunk) {
+            break;
+        }
+        magazine->chunks[magazine->n_chunks++] = chunk;
+        n++;
+    }
+    pool->metadata.n_cached += n;
 #ifndef NDEBUG
     ba_debug_checks(pool);
 #endif /* NDEBUG */
+    util_mutex_unlock(&pool->metadata.free_lock);
 
-    VALGRIND_DO_MALLOCLIKE_BLOCK(chunk, pool->metadata.chunk_size, 0, 0);
-    utils_annotate_memory_undefined(chunk, pool->metadata.chunk_size);
+    return n;
+}
 
+// Moves 'count' chunks from the bottom of the magazine to the free list,
+// the most recently freed (and probably still hot) chunks stay cached.
+static void ba_magazine_flush(umf_ba_pool_t *pool, ba_magazine_t *magazine,
+                              size_t count) {
+    assert(count <= magazine->n_chunks);
+
+    util_mutex_lock(&pool->metadata.free_lock);
+    for (size_t i = 0; i < count; i++) {
+        ba_put_chunk(pool, magazine->chunks[i]);
+    }
+    pool->metadata.n_cached -= count;
+#ifndef NDEBUG
+    ba_debug_checks(pool);
+#endif /* NDEBUG */
     util_mutex_unlock(&pool->metadata.free_lock);
 
-    return chunk;
+    magazine->n_chunks -= count;
+    for (size_t i = 0; i < magazine->n_chunks; i++) {
+        magazine->chunks[i] = magazine->chunks[i + count];
+    }
 }
 
-#ifndef NDEBUG
-// Checks if given pointer belongs to the pool. Should be called
-// under the lock
-static int pool_contains_pointer(umf_ba_pool_t *pool, void *ptr) {
-    char *cptr = (char *)ptr;
-    if (cptr >= pool->data &&
-        cptr < ((char *)(pool)) + pool->metadata.pool_size) {
-        return 1;
+void ba_thread_exit(void) {
+    ba_thread_cache_t *cache = &TLS_ba_cache;
+
+    util_mutex_lock(&Live_pools_lock);
+    for (int i = 0; i < MAGAZINES_PER_THREAD; i++) {
+        ba_magazine_t *magazine = &cache->magazines[i];
+        if (magazine->pool_id &&
+            ba_pool_is_live(magazine->pool, magazine->pool_id)) {
+            ba_magazine_flush(magazine->pool, magazine, magazine->n_chunks);
+        }
+        magazine->pool_id = 0;
+        magazine->n_chunks = 0;
     }
+    util_mutex_unlock(&Live_pools_lock);
+}
 
-    umf_ba_next_pool_t *next_pool = pool->next_pool;
-    while (next_pool) {
-        if (cptr >= next_pool->data &&
-            cptr < ((char *)(next_pool)) + pool->metadata.pool_size) {
-            return 1;
+void *umf_ba_alloc(umf_ba_pool_t *pool) {
+    umf_ba_chunk_t *chunk;
+
+    ba_magazine_t *magazine = ba_get_magazine(pool);
+    if (magazine) {
+        if (magazine->n_chunks == 0 &&
+            ba_magazine_refill(pool, magazine, MAGAZINE_BATCH) == 0) {
+            return NULL;
+        }
+        chunk = magazine->chunks[--magazine->n_chunks];
+    } else {
+        util_mutex_lock(&pool->metadata.free_lock);
+        chunk = ba_take_chunk(pool);
+#ifndef NDEBUG
+        ba_debug_checks(pool);
+#endif /* NDEBUG */
+        util_mutex_unlock(&pool->metadata.free_lock);
+        if (!chunk) {
+            return NULL;
         }
-        next_pool = next_pool->next_pool;
     }
 
-    return 0;
+    VALGRIND_DO_MALLOCLIKE_BLOCK(chunk, pool->metadata.chunk_size, 0, 0);
+    utils_annotate_memory_undefined(chunk, pool->metadata.chunk_size);
+
+    return chunk;
 }
-#endif
 
 void umf_ba_free(umf_ba_pool_t *pool, void *ptr) {
     if (ptr == NULL) {
@@ -269,36 +484,61 @@ void umf_ba_free(umf_ba_pool_t *pool, void *ptr) {
 
     umf_ba_chunk_t *chunk = (umf_ba_chunk_t *)ptr;
 
+    VALGRIND_DO_FREELIKE_BLOCK(chunk, 0);
+    utils_annotate_memory_inaccessible(chunk, pool->metadata.chunk_size);
+
+    ba_magazine_t *magazine = ba_get_magazine(pool);
+    if (magazine) {
+        if (magazine->n_chunks == MAGAZINE_SIZE) {
+            ba_magazine_flush(pool, magazine, MAGAZINE_BATCH);
+        }
+        magazine->chunks[magazine->n_chunks++] = chunk;
+        return;
+    }
+
     util_mutex_lock(&pool->metadata.free_lock);
-    assert(pool_contains_pointer(pool, ptr));
-    chunk->next = pool->metadata.free_list;
-    pool->metadata.free_list = chunk;
-    pool->metadata.n_allocs--;
+    ba_put_chunk(pool, chunk);
 #ifndef NDEBUG
     ba_debug_checks(pool);
 #endif /* NDEBUG */
-
-    VALGRIND_DO_FREELIKE_BLOCK(chunk, 0);
-    utils_annotate_memory_inaccessible(chunk, pool->metadata.chunk_size);
-
     util_mutex_unlock(&pool->metadata.free_lock);
 }
 
 void umf_ba_destroy(umf_ba_pool_t *pool) {
+    // chunks cached by threads are free
+    size_t n_allocs = pool->metadata.n_allocs - pool->metadata.n_cached;
+
     // Do not destroy if we are running in the proxy library,
     // because it may need those resources till
     // the very end of exiting the application.
-    if (pool->metadata.n_allocs && util_is_running_in_proxy_lib()) {
+    if (n_allocs && util_is_running_in_proxy_lib()) {
         return;
     }
 
 #ifndef NDEBUG
     ba_debug_checks(pool);
-    if (pool->metadata.n_allocs) {
-        LOG_ERR("pool->metadata.n_allocs = %zu", pool->metadata.n_allocs);
+    if (n_allocs) {
+        LOG_ERR("pool->metadata.n_allocs = %zu", n_allocs);
     }
 #endif /* NDEBUG */
 
+    util_mutex_lock(&Live_pools_lock);
+    umf_ba_pool_t **prev = &Live_pools;
+    while (*prev != pool) {
+        prev = &(*prev)->metadata.next_live;
+    }
+    *prev = pool->metadata.next_live;
+    util_mutex_unlock(&Live_pools_lock);
+
+    // the magazines of the calling thread can be released right away
+    ba_thread_cache_t *cache = &TLS_ba_cache;
+    for (int i = 0; i < MAGAZINES_PER_THREAD; i++) {
+        if (cache->magazines[i].pool == pool) {
+            cache->magazines[i].pool_id = 0;
+            cache->magazines[i].n_chunks = 0;
+        }
+    }
+
     size_t size = pool->metadata.pool_size;
     umf_ba_next_pool_t *current_pool;
     umf_ba_next_pool_t *next_pool = pool->next_pool;
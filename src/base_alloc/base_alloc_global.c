@@ -47,6 +47,8 @@ void umf_ba_destroy_global(void) {
         }
     }
 
+    ba_os_thread_exit_teardown();
+
     // portable version of "ba_is_initialized = UTIL_ONCE_FLAG_INIT;"
     static UTIL_ONCE_FLAG is_initialized = UTIL_ONCE_FLAG_INIT;
     memcpy(&ba_is_initialized, &is_initialized, sizeof(ba_is_initialized));
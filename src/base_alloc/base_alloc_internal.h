@@ -22,6 +22,17 @@ void *ba_os_alloc(size_t size);
 void ba_os_free(void *ptr, size_t size);
 size_t ba_os_get_page_size(void);
 
+// Makes ba_thread_exit() to be called when the calling thread exits
+// (does nothing if it is already registered). Returns 0 on success.
+int ba_os_notify_on_thread_exit(void);
+
+// Unregisters ba_thread_exit() for all threads, so that no thread calls it
+// after the library is torn down or unloaded.
+void ba_os_thread_exit_teardown(void);
+
+// Releases the resources cached by the calling thread, called on thread exit
+void ba_thread_exit(void);
+
 #ifdef __cplusplus
 }
 #endif
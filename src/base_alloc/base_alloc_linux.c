@@ -6,18 +6,25 @@
 */
 
 #include <assert.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
 #include "base_alloc.h"
 #include "base_alloc_global.h"
+#include "base_alloc_internal.h"
 #include "utils_concurrency.h"
 
 static UTIL_ONCE_FLAG Page_size_is_initialized = UTIL_ONCE_FLAG_INIT;
 static size_t Page_size;
 
+static UTIL_ONCE_FLAG Thread_exit_key_is_initialized = UTIL_ONCE_FLAG_INIT;
+static pthread_key_t Thread_exit_key;
+static int Thread_exit_key_ret = -1;
+
 void *ba_os_alloc(size_t size) {
     return mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
                 -1, 0);
@@ -35,3 +42,41 @@ size_t ba_os_get_page_size(void) {
     util_init_once(&Page_size_is_initialized, _ba_os_init_page_size);
     return Page_size;
 }
+
+static void _ba_os_thread_exit(void *arg) {
+    (void)arg; // unused
+    ba_thread_exit();
+}
+
+static void _ba_os_init_thread_exit_key(void) {
+    Thread_exit_key_ret = pthread_key_create(&Thread_exit_key,
+                                             _ba_os_thread_exit);
+}
+
+int ba_os_notify_on_thread_exit(void) {
+    util_init_once(&Thread_exit_key_is_initialized,
+                   _ba_os_init_thread_exit_key);
+    if (Thread_exit_key_ret) {
+        return Thread_exit_key_ret;
+    }
+
+    if (pthread_getspecific(Thread_exit_key)) {
+        return 0; // already registered
+    }
+
+    // the destructor is called only for non-NULL values
+    return pthread_setspecific(Thread_exit_key, (void *)1);
+}
+
+void ba_os_thread_exit_teardown(void) {
+    if (Thread_exit_key_ret == 0) {
+        pthread_key_delete(Thread_exit_key);
+        Thread_exit_key_ret = -1;
+    }
+
+    // portable version of
+    // "Thread_exit_key_is_initialized = UTIL_ONCE_FLAG_INIT;"
+    static UTIL_ONCE_FLAG is_initialized = UTIL_ONCE_FLAG_INIT;
+    memcpy(&Thread_exit_key_is_initialized, &is_initialized,
+           sizeof(Thread_exit_key_is_initialized));
+}
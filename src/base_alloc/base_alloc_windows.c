@@ -5,13 +5,18 @@
  * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 */
 
+#include <string.h>
 #include <windows.h>
 
+#include "base_alloc_internal.h"
 #include "utils_concurrency.h"
 
 static UTIL_ONCE_FLAG Page_size_is_initialized = UTIL_ONCE_FLAG_INIT;
 static size_t Page_size;
 
+static UTIL_ONCE_FLAG Thread_exit_index_is_initialized = UTIL_ONCE_FLAG_INIT;
+static DWORD Thread_exit_index = FLS_OUT_OF_INDEXES;
+
 void *ba_os_alloc(size_t size) {
     return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
 }
@@ -31,3 +36,43 @@ size_t ba_os_get_page_size(void) {
     util_init_once(&Page_size_is_initialized, _ba_os_init_page_size);
     return Page_size;
 }
+
+static VOID WINAPI _ba_os_thread_exit(PVOID arg) {
+    if (arg) {
+        ba_thread_exit();
+    }
+}
+
+static void _ba_os_init_thread_exit_index(void) {
+    Thread_exit_index = FlsAlloc(_ba_os_thread_exit);
+}
+
+int ba_os_notify_on_thread_exit(void) {
+    util_init_once(&Thread_exit_index_is_initialized,
+                   _ba_os_init_thread_exit_index);
+    if (Thread_exit_index == FLS_OUT_OF_INDEXES) {
+        return -1;
+    }
+
+    if (FlsGetValue(Thread_exit_index)) {
+        return 0; // already registered
+    }
+
+    // the callback is called only for non-NULL values
+    return FlsSetValue(Thread_exit_index, (PVOID)1) ? 0 : -1;
+}
+
+void ba_os_thread_exit_teardown(void) {
+    if (Thread_exit_index != FLS_OUT_OF_INDEXES) {
+        // FlsFree() calls the callback in the calling thread for the values
+        // of all threads, which releases only the cache of the calling thread
+        FlsFree(Thread_exit_index);
+        Thread_exit_index = FLS_OUT_OF_INDEXES;
+    }
+
+    // portable version of
+    // "Thread_exit_index_is_initialized = UTIL_ONCE_FLAG_INIT;"
+    static UTIL_ONCE_FLAG is_initialized = UTIL_ONCE_FLAG_INIT;
+    memcpy(&Thread_exit_index_is_initialized, &is_initialized,
+           sizeof(Thread_exit_index_is_initialized));
+}
@@ -20,6 +20,7 @@
 #include <memory>
 #include <stdexcept>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace umf {
@@ -48,7 +49,24 @@ using provider_unique_handle_t =
         }                                                                      \
     }
 
+// Assigns an optional op only if the type implements it,
+// otherwise the op is left NULL and the library default is used.
+#define UMF_ASSIGN_OP_OPTIONAL(ops, type, func, default_return)                \
+    if constexpr (detail::has_##func<type>::value) {                           \
+        UMF_ASSIGN_OP(ops, type, func, default_return);                        \
+    }
+
 namespace detail {
+#define UMF_DEFINE_HAS_OP(func)                                                \
+    template <typename T, typename = void>                                     \
+    struct has_##func : std::false_type {};                                    \
+    template <typename T>                                                      \
+    struct has_##func<T, std::void_t<decltype(&T::func)>> : std::true_type {}
+
+UMF_DEFINE_HAS_OP(trim);
+UMF_DEFINE_HAS_OP(commit);
+UMF_DEFINE_HAS_OP(decommit);
+
 template <typename T, typename ArgsTuple>
 umf_result_t initialize(T *obj, ArgsTuple &&args) {
     try {
@@ -76,6 +94,7 @@ template <typename T> umf_memory_pool_ops_t poolOpsBase() {
     UMF_ASSIGN_OP(ops, T, malloc_usable_size, ((size_t)0));
     UMF_ASSIGN_OP(ops, T, free, UMF_RESULT_SUCCESS);
     UMF_ASSIGN_OP(ops, T, get_last_allocation_error, UMF_RESULT_ERROR_UNKNOWN);
+    UMF_ASSIGN_OP_OPTIONAL(ops, T, trim, UMF_RESULT_ERROR_UNKNOWN);
     return ops;
 }
 
@@ -93,6 +112,8 @@ template <typename T> umf_memory_provider_ops_t providerOpsBase() {
     UMF_ASSIGN_OP(ops.ext, T, purge_force, UMF_RESULT_ERROR_UNKNOWN);
     UMF_ASSIGN_OP(ops.ext, T, allocation_merge, UMF_RESULT_ERROR_UNKNOWN);
     UMF_ASSIGN_OP(ops.ext, T, allocation_split, UMF_RESULT_ERROR_UNKNOWN);
+    UMF_ASSIGN_OP_OPTIONAL(ops.ext, T, commit, UMF_RESULT_ERROR_UNKNOWN);
+    UMF_ASSIGN_OP_OPTIONAL(ops.ext, T, decommit, UMF_RESULT_ERROR_UNKNOWN);
     UMF_ASSIGN_OP(ops.ipc, T, get_ipc_handle_size, UMF_RESULT_ERROR_UNKNOWN);
     UMF_ASSIGN_OP(ops.ipc, T, get_ipc_handle, UMF_RESULT_ERROR_UNKNOWN);
     UMF_ASSIGN_OP(ops.ipc, T, put_ipc_handle, UMF_RESULT_ERROR_UNKNOWN);
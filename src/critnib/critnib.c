@@ -40,18 +40,32 @@
  * notice the data being stale and restart the work.  In usual cases,
  * the structure having been modified does _not_ cause a restart.
  *
- * Writes could be easily made lock-free as well (with only a cmpxchg
- * sync), but this leads to problems with removes.  A possible solution
- * would be doing removes by overwriting by NULL w/o freeing -- yet this
- * would lead to the structure growing without bounds.  Complex per-node
- * locks would increase concurrency but they slow down individual writes
- * enough that in practice a simple global write lock works faster.
+ * Writes use optimistic per-node locking.  Every node (and the root
+ * pointer) has a version lock: a writer walks down the tree without taking
+ * any locks, remembering the versions of the nodes it passed, and then
+ * locks only the node(s) it's going to modify -- with a cmpxchg that fails
+ * if the version changed in the meantime, in which case the writer
+ * restarts.  An insert locks the single node whose child slot it replaces,
+ * a remove locks the leaf's parent and grandparent (the latter may need to
+ * be updated if the parent is left with a single child).  Thus writes to
+ * unrelated parts of the tree proceed in parallel, and writers never block
+ * readers.  Every unlock bumps the version, a node removed from the tree is
+ * marked obsolete, and nodes are never returned to malloc before the whole
+ * critnib is deleted, so a stalled writer can't modify a node that has been
+ * changed, removed or reused behind its back.
+ *
+ * There are no global locks: nodes and leaves removed from the tree are
+ * kept on lock-free stacks until they can be reused (see reuse()), so
+ * writers touch shared state only with a couple of atomic operations.
  *
  * Removes are the only operation that can break reads.  The structure
  * can do local RCU well -- the problem being knowing when it's safe to
  * free.  Any synchronization with reads would kill their speed, thus
  * instead we have a remove count.  The grace period is DELETED_LIFE,
  * after which any read will notice staleness and restart its work.
+ * Every removed node and leaf remembers the remove count it was retired at,
+ * so it is reused only after the grace period, no matter in which order
+ * concurrent writers got to retire their nodes.
  */
 #include <errno.h>
 #include <stdbool.h>
@@ -91,7 +105,18 @@
 typedef uintptr_t word;
 typedef unsigned char sh_t;
 
+/*
+ * Link of a stack of removed nodes or leaves (see retire()).  Readers never
+ * look at it, so it can be changed while stalled readers may still walk
+ * through a removed node or leaf.
+ */
+struct critnib_free {
+    struct critnib_free *next;
+    uint64_t retired_at; /* remove count after the removal */
+};
+
 struct critnib_node {
+    struct critnib_free free; /* must be the first member */
     /*
 	 * path is the part of a tree that's already traversed (be it through
 	 * explicit nodes or collapsed links) -- ie, any subtree below has all
@@ -109,28 +134,37 @@ struct critnib_node {
 	 */
     struct critnib_node *child[SLNODES];
     word path;
+    uint64_t version; /* version lock, see version_read() */
     sh_t shift;
 };
 
+/*
+ * A leaf holds the key and two words of payload: the value and an auxiliary
+ * word, so that users who need to store a pair (like the memory tracker's
+ * pool and size) do not have to allocate a separate structure for it.
+ */
 struct critnib_leaf {
+    struct critnib_free free; /* must be the first member */
     word key;
     void *value;
+    word aux;
 };
 
 struct critnib {
     struct critnib_node *root;
+    uint64_t root_version; /* version lock guarding the root pointer */
 
-    /* pool of freed nodes: singly linked list, next at child[0] */
-    struct critnib_node *deleted_node;
-    struct critnib_leaf *deleted_leaf;
+    /* stacks of nodes and leaves that can be reused right away */
+    struct critnib_free *free_nodes;
+    struct critnib_free *free_leaves;
 
-    /* nodes removed but not yet eligible for reuse */
-    struct critnib_node *pending_del_nodes[DELETED_LIFE];
-    struct critnib_leaf *pending_del_leaves[DELETED_LIFE];
+    /* stacks of removed nodes and leaves, maybe still in the grace period */
+    struct critnib_free *pending_nodes;
+    struct critnib_free *pending_leaves;
 
     uint64_t remove_count;
 
-    struct os_mutex_t mutex; /* writes/removes */
+    uint64_t iterators; /* number of critnib_iter() calls in progress */
 };
 
 /*
@@ -151,6 +185,14 @@ static void store(void *dst, void *src) {
     util_atomic_store_release((word *)dst, (word)src);
 }
 
+/*
+ * atomic compare and swap of a pointer
+ */
+static bool cas(void *ptr, void *expected, void *desired) {
+    return util_compare_exchange((uint64_t *)ptr, (uint64_t *)expected,
+                                 (uint64_t)desired);
+}
+
 /*
  * internal: is_leaf -- check tagged pointer for leafness
  */
@@ -176,6 +218,75 @@ static inline unsigned slice_index(word key, sh_t shift) {
     return (unsigned)((key >> shift) & NIB);
 }
 
+/*
+ * Layout of a version lock: bit 0 - locked, bit 1 - obsolete (the node has
+ * been removed from the tree), the remaining bits count unlocks.
+ */
+#define VERSION_LOCKED 1ULL
+#define VERSION_OBSOLETE 2ULL
+#define VERSION_STEP 4ULL
+
+/*
+ * internal: version_read -- wait until a version lock is released and
+ * return its version; returns false if the node is obsolete
+ */
+static bool version_read(uint64_t *lock, uint64_t *version) {
+    while (1) {
+        load64(lock, version);
+        if (*version & VERSION_OBSOLETE) {
+            return false;
+        }
+        if (!(*version & VERSION_LOCKED)) {
+            return true;
+        }
+    }
+}
+
+/*
+ * internal: version_check -- check if a version lock is still at the given
+ * version, ie. nothing guarded by it has changed
+ */
+static bool version_check(uint64_t *lock, uint64_t version) {
+    uint64_t current;
+    load64(lock, &current);
+    return current == version;
+}
+
+/*
+ * internal: version_lock -- lock a version lock if it's still at the given
+ * version
+ */
+static bool version_lock(uint64_t *lock, uint64_t version) {
+    return util_compare_exchange(lock, &version, version | VERSION_LOCKED);
+}
+
+/*
+ * internal: version_unlock -- unlock a version lock after a modification
+ */
+static void version_unlock(uint64_t *lock) {
+    uint64_t version;
+    load64(lock, &version);
+    util_atomic_store_release(lock,
+                              (version & ~VERSION_LOCKED) + VERSION_STEP);
+}
+
+/*
+ * internal: version_release -- unlock a version lock without a modification
+ */
+static void version_release(uint64_t *lock, uint64_t version) {
+    util_atomic_store_release(lock, version);
+}
+
+/*
+ * internal: version_obsolete -- mark a locked node as removed from the tree;
+ * it stays locked until it's reused
+ */
+static void version_obsolete(uint64_t *lock) {
+    uint64_t version;
+    load64(lock, &version);
+    util_atomic_store_release(lock, version | VERSION_OBSOLETE);
+}
+
 /*
  * critnib_new -- allocates a new critnib structure
  */
@@ -187,18 +298,9 @@ struct critnib *critnib_new(void) {
 
     memset(c, 0, sizeof(struct critnib));
 
-    void *mutex_ptr = util_mutex_init(&c->mutex);
-    if (!mutex_ptr) {
-        goto err_free_critnib;
-    }
-
-    VALGRIND_HG_DRD_DISABLE_CHECKING(&c->root, sizeof(c->root));
-    VALGRIND_HG_DRD_DISABLE_CHECKING(&c->remove_count, sizeof(c->remove_count));
+    VALGRIND_HG_DRD_DISABLE_CHECKING(c, sizeof(struct critnib));
 
     return c;
-err_free_critnib:
-    umf_ba_global_free(c);
-    return NULL;
 }
 
 /*
@@ -218,6 +320,17 @@ static void delete_node(struct critnib *c, struct critnib_node *__restrict n) {
     }
 }
 
+/*
+ * internal: delete_stack -- free (to malloc) all nodes or leaves of a stack
+ */
+static void delete_stack(struct critnib_free *f) {
+    while (f) {
+        struct critnib_free *next = f->next;
+        umf_ba_global_free(f);
+        f = next;
+    }
+}
+
 /*
  * critnib_delete -- destroy and free a critnib struct
  */
@@ -226,92 +339,260 @@ void critnib_delete(struct critnib *c) {
         delete_node(c, c->root);
     }
 
-    util_mutex_destroy_not_free(&c->mutex);
+    delete_stack(c->free_nodes);
+    delete_stack(c->free_leaves);
+    delete_stack(c->pending_nodes);
+    delete_stack(c->pending_leaves);
+
+    umf_ba_global_free(c);
+}
+
+/*
+ * internal: push -- push a chain of nodes or leaves linked from first
+ * to last on a stack
+ *
+ * A plain Treiber stack push is immune to ABA: it doesn't look at anything
+ * but the head it replaces.
+ */
+static void push(struct critnib_free **stack, struct critnib_free *first,
+                 struct critnib_free *last) {
+    struct critnib_free *head;
+    load(stack, &head);
+    do {
+        last->next = head;
+    } while (!cas(stack, &head, first));
+}
 
-    for (struct critnib_node *m = c->deleted_node; m;) {
-        struct critnib_node *mm = m->child[0];
-        umf_ba_global_free(m);
-        m = mm;
+/*
+ * internal: pop_all -- take the whole content of a stack
+ *
+ * Swapping the head for NULL doesn't look at the next links either, so
+ * there's no ABA problem; the taken chain belongs to the caller only.
+ */
+static struct critnib_free *pop_all(struct critnib_free **stack) {
+    struct critnib_free *head;
+    load(stack, &head);
+    while (head && !cas(stack, &head, NULL)) {
     }
 
-    for (struct critnib_leaf *k = c->deleted_leaf; k;) {
-        struct critnib_leaf *kk = k->value;
-        umf_ba_global_free(k);
-        k = kk;
+    return head;
+}
+
+/*
+ * internal: pop -- take one node or leaf from a stack
+ *
+ * The whole stack is taken and all but the first element are given back.
+ * If something was pushed in the meantime, it's taken too and put in front
+ * of the rest; that chain is as short as the window between the two swaps.
+ */
+static struct critnib_free *pop(struct critnib_free **stack) {
+    struct critnib_free *first = pop_all(stack);
+    if (!first) {
+        return NULL;
     }
 
-    for (int i = 0; i < DELETED_LIFE; i++) {
-        umf_ba_global_free(c->pending_del_nodes[i]);
-        umf_ba_global_free(c->pending_del_leaves[i]);
+    struct critnib_free *rest = first->next;
+    while (rest) {
+        struct critnib_free *empty = NULL;
+        if (cas(stack, &empty, rest)) {
+            break;
+        }
+
+        struct critnib_free *pushed = pop_all(stack);
+        if (!pushed) {
+            continue;
+        }
+
+        struct critnib_free *last = pushed;
+        while (last->next) {
+            last = last->next;
+        }
+        last->next = rest;
+        rest = pushed;
     }
 
-    umf_ba_global_free(c);
+    return first;
 }
 
 /*
- * internal: free_node -- free (to internal pool, not malloc) a node.
+ * internal: reuse -- get a node or leaf to reuse, NULL if there is none
  *
- * We cannot free them to malloc as a stalled reader thread may still walk
- * through such nodes; it will notice the result being bogus but only after
- * completing the walk, thus we need to ensure any freed nodes still point
- * to within the critnib structure.
+ * Nodes and leaves are retired onto the pending stack.  When the free stack
+ * is empty, the ones whose grace period has ended are moved from the pending
+ * stack to the free one.  That's not done while any critnib_iter() is in
+ * progress, as it doesn't notice the nodes being reused under its feet -
+ * the taken nodes are given back if an iterator started in the meantime.
  */
-static void free_node(struct critnib *__restrict c,
-                      struct critnib_node *__restrict n) {
-    if (!n) {
-        return;
+static struct critnib_free *reuse(struct critnib *__restrict c,
+                                  struct critnib_free **free_stack,
+                                  struct critnib_free **pending_stack) {
+    struct critnib_free *f = pop(free_stack);
+    if (f) {
+        return f;
     }
 
-    ASSERT(!is_leaf(n));
-    n->child[0] = c->deleted_node;
-    c->deleted_node = n;
+    uint64_t iterators;
+    load64(&c->iterators, &iterators);
+    if (iterators) {
+        return NULL;
+    }
+
+    struct critnib_free *p = pop_all(pending_stack);
+    if (!p) {
+        return NULL;
+    }
+
+    // An iterator started after the check above could have started before
+    // some of the taken nodes were retired, so it can still reach them.
+    // The counter is read with a read-modify-write, so that an iterator
+    // starting after it sees the tree without the taken nodes.
+    if (util_fetch_and_add64(&c->iterators, 0)) {
+        struct critnib_free *last = p;
+        while (last->next) {
+            last = last->next;
+        }
+        push(pending_stack, p, last);
+        return NULL;
+    }
+
+    uint64_t removes;
+    load64(&c->remove_count, &removes);
+
+    struct critnib_free *ready = NULL, *ready_last = NULL;
+    struct critnib_free *waiting = NULL, *waiting_last = NULL;
+    while (p) {
+        struct critnib_free *next = p->next;
+        if (p->retired_at + DELETED_LIFE <= removes) {
+            p->next = ready;
+            ready = p;
+            ready_last = ready_last ? ready_last : p;
+        } else {
+            p->next = waiting;
+            waiting = p;
+            waiting_last = waiting_last ? waiting_last : p;
+        }
+        p = next;
+    }
+
+    if (waiting) {
+        push(pending_stack, waiting, waiting_last);
+    }
+
+    if (!ready) {
+        return NULL;
+    }
+
+    f = ready;
+    if (ready != ready_last) {
+        push(free_stack, ready->next, ready_last);
+    }
+
+    return f;
 }
 
 /*
  * internal: alloc_node -- allocate a node from our pool or from malloc
+ *
+ * We cannot free nodes to malloc as a stalled reader thread may still walk
+ * through such nodes; it will notice the result being bogus but only after
+ * completing the walk, thus we need to ensure any freed nodes still point
+ * to within the critnib structure.
+ *
+ * The node is returned locked, so no stalled writer can use it before it's
+ * initialized and linked into the tree.
  */
 static struct critnib_node *alloc_node(struct critnib *__restrict c) {
-    if (!c->deleted_node) {
-        return umf_ba_global_alloc(sizeof(struct critnib_node));
-    }
+    struct critnib_node *n =
+        (struct critnib_node *)reuse(c, &c->free_nodes, &c->pending_nodes);
 
-    struct critnib_node *n = c->deleted_node;
+    if (!n) {
+        n = umf_ba_global_alloc(sizeof(struct critnib_node));
+        if (n) {
+            VALGRIND_HG_DRD_DISABLE_CHECKING(n, sizeof(struct critnib_node));
+            n->version = VERSION_LOCKED;
+        }
+        return n;
+    }
 
-    c->deleted_node = n->child[0];
+    /*
+     * Keep counting from the old version, so that a writer who saw
+     * the previous incarnation of this node can't lock it.
+     */
+    uint64_t version;
+    load64(&n->version, &version);
+    util_atomic_store_release(
+        &n->version,
+        ((version & ~(VERSION_LOCKED | VERSION_OBSOLETE)) + VERSION_STEP) |
+            VERSION_LOCKED);
     VALGRIND_ANNOTATE_NEW_MEMORY(n, sizeof(*n));
 
     return n;
 }
 
 /*
- * internal: free_leaf -- free (to internal pool, not malloc) a leaf.
- *
- * See free_node().
+ * internal: alloc_leaf -- allocate a leaf from our pool or from malloc
  */
-static void free_leaf(struct critnib *__restrict c,
-                      struct critnib_leaf *__restrict k) {
+static struct critnib_leaf *alloc_leaf(struct critnib *__restrict c) {
+    struct critnib_leaf *k =
+        (struct critnib_leaf *)reuse(c, &c->free_leaves, &c->pending_leaves);
+
     if (!k) {
-        return;
+        k = umf_ba_global_alloc(sizeof(struct critnib_leaf));
+        if (k) {
+            VALGRIND_HG_DRD_DISABLE_CHECKING(k, sizeof(struct critnib_leaf));
+        }
+        return k;
     }
 
-    k->value = c->deleted_leaf;
-    c->deleted_leaf = k;
+    VALGRIND_ANNOTATE_NEW_MEMORY(k, sizeof(*k));
+
+    return k;
 }
 
 /*
- * internal: alloc_leaf -- allocate a leaf from our pool or from malloc
+ * internal: discard -- free a node and/or a leaf that have never been
+ * linked into the tree, they can be reused right away
+ *
+ * The node has to be locked.
  */
-static struct critnib_leaf *alloc_leaf(struct critnib *__restrict c) {
-    if (!c->deleted_leaf) {
-        return umf_ba_global_alloc(sizeof(struct critnib_leaf));
+static void discard(struct critnib *__restrict c,
+                    struct critnib_node *__restrict n,
+                    struct critnib_leaf *__restrict k) {
+    if (n) {
+        version_obsolete(&n->version);
+        push(&c->free_nodes, &n->free, &n->free);
     }
 
-    struct critnib_leaf *k = c->deleted_leaf;
+    if (k) {
+        push(&c->free_leaves, &k->free, &k->free);
+    }
+}
 
-    c->deleted_leaf = k->value;
-    VALGRIND_ANNOTATE_NEW_MEMORY(k, sizeof(*k));
+/*
+ * internal: retire -- put a node and/or a leaf unlinked from the tree
+ * on the stacks of pending deletes
+ *
+ * They cannot be reused before the grace period ends: a reader that could
+ * have seen them will notice the remove count has changed by DELETED_LIFE
+ * by then.  The remove count is bumped after unlinking, so any reader that
+ * got a pointer to them has started before that.
+ *
+ * The node has to be locked and marked obsolete.
+ */
+static void retire(struct critnib *__restrict c,
+                   struct critnib_node *__restrict n,
+                   struct critnib_leaf *__restrict k) {
+    uint64_t removes = util_atomic_increment(&c->remove_count);
+
+    if (n) {
+        n->free.retired_at = removes;
+        push(&c->pending_nodes, &n->free, &n->free);
+    }
 
-    return k;
+    if (k) {
+        k->free.retired_at = removes;
+        push(&c->pending_leaves, &k->free, &k->free);
+    }
 }
 
 /*
@@ -322,48 +603,70 @@ static struct critnib_leaf *alloc_leaf(struct critnib *__restrict c) {
  *  • EEXIST if such a key already exists
  *  • ENOMEM if we're out of memory
  *
- * Takes a global write lock but doesn't stall any readers.
+ * Locks only the node being modified and doesn't stall any readers.
  */
 int critnib_insert(struct critnib *c, word key, void *value, int update) {
-    util_mutex_lock(&c->mutex);
+    return critnib_insert_aux(c, key, value, 0, update);
+}
 
+/*
+ * critnib_insert_aux -- write a key:(value, aux) triple to the critnib
+ *
+ * Same as critnib_insert(), but stores also the auxiliary word in the leaf.
+ * An update replaces the whole leaf, so readers always see the value and
+ * the auxiliary word that were inserted together.
+ */
+int critnib_insert_aux(struct critnib *c, word key, void *value, word aux,
+                       int update) {
     struct critnib_leaf *k = alloc_leaf(c);
     if (!k) {
-        util_mutex_unlock(&c->mutex);
-
         return ENOMEM;
     }
 
-    VALGRIND_HG_DRD_DISABLE_CHECKING(k, sizeof(struct critnib_leaf));
-
     k->key = key;
     k->value = value;
+    k->aux = aux;
 
     struct critnib_node *kn = (void *)((word)k | 1);
 
-    struct critnib_node *n = c->root;
-    if (!n) {
-        store(&c->root, kn);
+    /* a new inner node, allocated once and reused if we have to restart */
+    struct critnib_node *m = NULL;
 
-        util_mutex_unlock(&c->mutex);
-
-        return 0;
-    }
+restart:;
+    /* the lock guarding the slot we're going to modify and its version */
+    uint64_t *lock = &c->root_version;
+    uint64_t version;
+    version_read(lock, &version); /* the root pointer is never obsolete */
 
     struct critnib_node **parent = &c->root;
-    struct critnib_node *prev = c->root;
+    struct critnib_node *n;
+    load(parent, &n);
+
+    while (n && !is_leaf(n)) {
+        uint64_t n_version;
+        if (!version_read(&n->version, &n_version)) {
+            goto restart;
+        }
 
-    while (n && !is_leaf(n) && (key & path_mask(n->shift)) == n->path) {
-        prev = n;
+        if ((key & path_mask(n->shift)) != n->path) {
+            break;
+        }
+
+        lock = &n->version;
+        version = n_version;
         parent = &n->child[slice_index(key, n->shift)];
-        n = *parent;
+        load(parent, &n);
     }
 
     if (!n) {
-        n = prev;
-        store(&n->child[slice_index(key, n->shift)], kn);
+        if (!version_lock(lock, version)) {
+            goto restart;
+        }
 
-        util_mutex_unlock(&c->mutex);
+        store(parent, kn);
+        version_unlock(lock);
+
+        discard(c, m, NULL);
 
         return 0;
     }
@@ -373,30 +676,44 @@ int critnib_insert(struct critnib *c, word key, void *value, int update) {
     word at = path ^ key;
     if (!at) {
         ASSERT(is_leaf(n));
-        free_leaf(c, to_leaf(kn));
 
-        if (update) {
-            to_leaf(n)->value = value;
-            util_mutex_unlock(&c->mutex);
-            return 0;
-        } else {
-            util_mutex_unlock(&c->mutex);
+        if (!update) {
+            /* make sure the existing leaf was still there */
+            if (!version_check(lock, version)) {
+                goto restart;
+            }
+
+            discard(c, m, k);
             return EEXIST;
         }
+
+        /*
+         * Replace the whole leaf, so that readers always see the value and
+         * the auxiliary word that were inserted together.
+         */
+        if (!version_lock(lock, version)) {
+            goto restart;
+        }
+
+        store(parent, kn);
+        version_unlock(lock);
+
+        discard(c, m, NULL);
+        retire(c, NULL, to_leaf(n));
+
+        return 0;
     }
 
     /* and convert that to an index. */
     sh_t sh = util_mssb_index(at) & (sh_t) ~(SLICE - 1);
 
-    struct critnib_node *m = alloc_node(c);
     if (!m) {
-        free_leaf(c, to_leaf(kn));
-
-        util_mutex_unlock(&c->mutex);
-
-        return ENOMEM;
+        m = alloc_node(c);
+        if (!m) {
+            discard(c, NULL, k);
+            return ENOMEM;
+        }
     }
-    VALGRIND_HG_DRD_DISABLE_CHECKING(m, sizeof(struct critnib_node));
 
     for (int i = 0; i < SLNODES; i++) {
         m->child[i] = NULL;
@@ -406,74 +723,156 @@ int critnib_insert(struct critnib *c, word key, void *value, int update) {
     m->child[slice_index(path, sh)] = n;
     m->shift = sh;
     m->path = key & path_mask(sh);
+
+    if (!version_lock(lock, version)) {
+        goto restart;
+    }
+
     store(parent, m);
+    version_unlock(lock);
 
-    util_mutex_unlock(&c->mutex);
+    /* m is initialized and linked, let other writers use it */
+    version_unlock(&m->version);
 
     return 0;
 }
 
 /*
- * critnib_remove -- delete a key from the critnib structure, return its value
+ * critnib_update_aux -- change the auxiliary word of an existing key in place
+ *
+ * Returns:
+ *  • 0 on success
+ *  • ENOENT if there is no such key
+ *
+ * Unlike an update with critnib_insert_aux() it never allocates, so it
+ * cannot fail with ENOMEM, but readers may see the old auxiliary word
+ * together with the current value for a moment. The caller must make sure
+ * the key is not removed concurrently.
  */
-void *critnib_remove(struct critnib *c, word key) {
+int critnib_update_aux(struct critnib *c, word key, word aux) {
+    uint64_t wrs1, wrs2;
     struct critnib_leaf *k;
-    void *value = NULL;
 
-    util_mutex_lock(&c->mutex);
-
-    struct critnib_node *n = c->root;
-    if (!n) {
-        goto not_found;
-    }
+    do {
+        struct critnib_node *n;
 
-    word del = (util_atomic_increment(&c->remove_count) - 1) % DELETED_LIFE;
-    free_node(c, c->pending_del_nodes[del]);
-    free_leaf(c, c->pending_del_leaves[del]);
-    c->pending_del_nodes[del] = NULL;
-    c->pending_del_leaves[del] = NULL;
+        load64(&c->remove_count, &wrs1);
+        load(&c->root, &n);
 
-    if (is_leaf(n)) {
-        k = to_leaf(n);
-        if (k->key == key) {
-            store(&c->root, NULL);
-            goto del_leaf;
+        while (n && !is_leaf(n)) {
+            load(&n->child[slice_index(key, n->shift)], &n);
         }
 
-        goto not_found;
+        k = (n && to_leaf(n)->key == key) ? to_leaf(n) : NULL;
+        load64(&c->remove_count, &wrs2);
+    } while (wrs1 + DELETED_LIFE <= wrs2);
+
+    if (!k) {
+        return ENOENT;
     }
+
+    util_atomic_store_release(&k->aux, aux);
+
+    return 0;
+}
+
+/*
+ * critnib_remove -- delete a key from the critnib structure, return its value
+ */
+void *critnib_remove(struct critnib *c, word key) {
+restart:;
     /*
-	 * n and k are a parent:child pair (after the first iteration); k is the
-	 * leaf that holds the key we're deleting.
-	 */
+     * n is the parent of the leaf (NULL if the leaf is the root), n_lock
+     * guards the slot the leaf is in and gp_lock guards the slot n is in.
+     */
+    uint64_t *gp_lock = NULL;
+    uint64_t gp_version = 0;
+    uint64_t *n_lock = &c->root_version;
+    uint64_t n_version;
+    version_read(n_lock, &n_version); /* the root pointer is never obsolete */
+
+    struct critnib_node **n_parent = NULL;
     struct critnib_node **k_parent = &c->root;
-    struct critnib_node **n_parent = &c->root;
-    struct critnib_node *kn = n;
+    struct critnib_node *n = NULL;
+    struct critnib_node *kn;
+    load(k_parent, &kn);
+
+    while (kn && !is_leaf(kn)) {
+        uint64_t version;
+        if (!version_read(&kn->version, &version)) {
+            goto restart;
+        }
+
+        /*
+         * The key cannot be in a subtree whose path doesn't match.
+         * This check is needed to tell that the key is not in the tree:
+         * kn may have been removed and reused elsewhere in the meantime,
+         * but not if the version of its parent is still the same.
+         */
+        if ((key & path_mask(kn->shift)) != kn->path) {
+            break;
+        }
 
-    while (!is_leaf(kn)) {
+        gp_lock = n_lock;
+        gp_version = n_version;
         n_parent = k_parent;
+
         n = kn;
+        n_lock = &kn->version;
+        n_version = version;
         k_parent = &kn->child[slice_index(key, kn->shift)];
-        kn = *k_parent;
+        load(k_parent, &kn);
+    }
 
-        if (!kn) {
-            goto not_found;
+    if (!kn || !is_leaf(kn) || to_leaf(kn)->key != key) {
+        /* make sure the key was not there at some point */
+        if (!version_check(n_lock, n_version)) {
+            goto restart;
         }
+
+        return NULL;
     }
 
-    k = to_leaf(kn);
-    if (k->key != key) {
-        goto not_found;
+    struct critnib_leaf *k = to_leaf(kn);
+    void *value;
+
+    if (!n) {
+        if (!version_lock(n_lock, n_version)) {
+            goto restart;
+        }
+
+        value = k->value;
+        store(&c->root, NULL);
+        version_unlock(n_lock);
+
+        retire(c, NULL, k);
+
+        return value;
     }
 
-    store(&n->child[slice_index(key, n->shift)], NULL);
+    if (!version_lock(gp_lock, gp_version)) {
+        goto restart;
+    }
+
+    if (!version_lock(n_lock, n_version)) {
+        version_release(gp_lock, gp_version);
+        goto restart;
+    }
+
+    value = k->value;
+    store(k_parent, NULL);
 
     /* Remove the node if there's only one remaining child. */
     int ochild = -1;
     for (int i = 0; i < SLNODES; i++) {
         if (n->child[i]) {
             if (ochild != -1) {
-                goto del_leaf;
+                version_unlock(n_lock);
+                version_release(gp_lock, gp_version);
+
+                retire(c, NULL, k);
+
+                return value;
             }
 
             ochild = i;
@@ -483,14 +882,11 @@ void *critnib_remove(struct critnib *c, word key) {
     ASSERTne(ochild, -1);
 
     store(n_parent, n->child[ochild]);
-    c->pending_del_nodes[del] = n;
+    version_unlock(gp_lock);
+    version_obsolete(n_lock);
 
-del_leaf:
-    value = k->value;
-    c->pending_del_leaves[del] = k;
+    retire(c, n, k);
 
-not_found:
-    util_mutex_unlock(&c->mutex);
     return value;
 }
 
@@ -505,8 +901,17 @@ not_found:
  * we need only one that was valid at any point after the call started.
  */
 void *critnib_get(struct critnib *c, word key) {
+    return critnib_get_aux(c, key, NULL);
+}
+
+/*
+ * critnib_get_aux -- query for a key ("==" match), returns value or NULL
+ * and stores the auxiliary word of the found leaf in *raux (if not NULL)
+ */
+void *critnib_get_aux(struct critnib *c, word key, word *raux) {
     uint64_t wrs1, wrs2;
     void *res;
+    word aux = 0;
 
     do {
         struct critnib_node *n;
@@ -525,10 +930,18 @@ void *critnib_get(struct critnib *c, word key) {
 
         /* ... as we check it at the end. */
         struct critnib_leaf *k = to_leaf(n);
-        res = (n && k->key == key) ? k->value : NULL;
+        res = NULL;
+        if (n && k->key == key) {
+            res = k->value;
+            aux = k->aux;
+        }
         load64(&c->remove_count, &wrs2);
     } while (wrs1 + DELETED_LIFE <= wrs2);
 
+    if (res && raux) {
+        *raux = aux;
+    }
+
     return res;
 }
 
@@ -722,10 +1135,21 @@ static struct critnib_leaf *find_ge(struct critnib_node *__restrict n,
  */
 int critnib_find(struct critnib *c, uintptr_t key, enum find_dir_t dir,
                  uintptr_t *rkey, void **rvalue) {
+    return critnib_find_aux(c, key, dir, rkey, rvalue, NULL);
+}
+
+/*
+ * critnib_find_aux -- parametrized query, returns 1 if found
+ *
+ * Same as critnib_find(), but returns also the auxiliary word of the leaf.
+ */
+int critnib_find_aux(struct critnib *c, uintptr_t key, enum find_dir_t dir,
+                     uintptr_t *rkey, void **rvalue, uintptr_t *raux) {
     uint64_t wrs1, wrs2;
     struct critnib_leaf *k;
     uintptr_t _rkey = (uintptr_t)0x0;
     void **_rvalue = NULL;
+    uintptr_t _raux = (uintptr_t)0x0;
 
     /* <42 ≡ ≤41 */
     if (dir < -1) {
@@ -760,6 +1184,7 @@ int critnib_find(struct critnib *c, uintptr_t key, enum find_dir_t dir,
         if (k) {
             _rkey = k->key;
             _rvalue = k->value;
+            _raux = k->aux;
         }
         load64(&c->remove_count, &wrs2);
     } while (wrs1 + DELETED_LIFE <= wrs2);
@@ -771,6 +1196,9 @@ int critnib_find(struct critnib *c, uintptr_t key, enum find_dir_t dir,
         if (rvalue) {
             *rvalue = _rvalue;
         }
+        if (raux) {
+            *raux = _raux;
+        }
         return 1;
     }
 
@@ -781,6 +1209,10 @@ int critnib_find(struct critnib *c, uintptr_t key, enum find_dir_t dir,
  * critnib_iter -- iterator, [min..max], calls func(key, value, privdata)
  *
  * If func() returns non-zero, the search is aborted.
+ *
+ * Removed nodes and leaves are not reused while any walk is in progress
+ * (see reuse()); writes made concurrently with the walk may or may not be
+ * seen.
  */
 static int iter(struct critnib_node *__restrict n, word min, word max,
                 int (*func)(word key, void *value, void *privdata),
@@ -813,9 +1245,13 @@ static int iter(struct critnib_node *__restrict n, word min, word max,
 void critnib_iter(critnib *c, uintptr_t min, uintptr_t max,
                   int (*func)(uintptr_t key, void *value, void *privdata),
                   void *privdata) {
-    util_mutex_lock(&c->mutex);
-    if (c->root) {
-        iter(c->root, min, max, func, privdata);
+    util_atomic_increment(&c->iterators);
+
+    struct critnib_node *n;
+    load(&c->root, &n);
+    if (n) {
+        iter(n, min, max, func, privdata);
     }
-    util_mutex_unlock(&c->mutex);
+
+    util_atomic_decrement(&c->iterators);
 }
@@ -31,11 +31,17 @@ critnib *critnib_new(void);
 void critnib_delete(critnib *c);
 
 int critnib_insert(critnib *c, uintptr_t key, void *value, int update);
+int critnib_insert_aux(critnib *c, uintptr_t key, void *value, uintptr_t aux,
+                       int update);
+int critnib_update_aux(critnib *c, uintptr_t key, uintptr_t aux);
 void *critnib_remove(critnib *c, uintptr_t key);
 void *critnib_get(critnib *c, uintptr_t key);
+void *critnib_get_aux(critnib *c, uintptr_t key, uintptr_t *raux);
 void *critnib_find_le(critnib *c, uintptr_t key);
 int critnib_find(critnib *c, uintptr_t key, enum find_dir_t dir,
                  uintptr_t *rkey, void **rvalue);
+int critnib_find_aux(critnib *c, uintptr_t key, enum find_dir_t dir,
+                     uintptr_t *rkey, void **rvalue, uintptr_t *raux);
 void critnib_iter(critnib *c, uintptr_t min, uintptr_t max,
                   int (*func)(uintptr_t key, void *value, void *privdata),
                   void *privdata);
@@ -17,10 +17,42 @@
 #include <assert.h>
 #include <stdlib.h>
 
+#include <stddef.h>
+#include <string.h>
+
 #include "base_alloc_global.h"
 #include "memory_pool_internal.h"
 #include "memory_provider_internal.h"
 #include "provider_tracking.h"
+#include "utils_log.h"
+
+// the oldest version of the ops accepted by umfPoolCreate()
+#define POOL_OPS_MIN_VERSION UMF_MAKE_VERSION(0, 9)
+
+// the trim op was added in the version 0.10 of the ops
+#define POOL_OPS_TRIM_VERSION UMF_MAKE_VERSION(0, 10)
+
+// Copies as many ops as the version of the given ops structure has,
+// the ops added in later versions are set to NULL.
+static umf_result_t copyOps(umf_memory_pool_ops_t *dst,
+                            const umf_memory_pool_ops_t *src) {
+    if (src->version < POOL_OPS_MIN_VERSION ||
+        src->version > UMF_VERSION_CURRENT) {
+        LOG_ERR("unsupported version of the memory pool ops: %d.%d",
+                UMF_MAJOR_VERSION(src->version),
+                UMF_MINOR_VERSION(src->version));
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    memset(dst, 0, sizeof(*dst));
+    if (src->version < POOL_OPS_TRIM_VERSION) {
+        memcpy(dst, src, offsetof(umf_memory_pool_ops_t, trim));
+    } else {
+        *dst = *src;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
 
 static umf_result_t umfPoolCreateInternal(const umf_memory_pool_ops_t *ops,
                                           umf_memory_provider_handle_t provider,
@@ -38,7 +70,10 @@ static umf_result_t umfPoolCreateInternal(const umf_memory_pool_ops_t *ops,
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    assert(ops->version == UMF_VERSION_CURRENT);
+    ret = copyOps(&pool->ops, ops);
+    if (ret != UMF_RESULT_SUCCESS) {
+        goto err_provider_create;
+    }
 
     if (!(flags & UMF_POOL_CREATE_FLAG_DISABLE_TRACKING)) {
         // wrap provider with memory tracking provider
@@ -51,7 +86,6 @@ static umf_result_t umfPoolCreateInternal(const umf_memory_pool_ops_t *ops,
     }
 
     pool->flags = flags;
-    pool->ops = *ops;
 
     ret = ops->initialize(pool->provider, params, &pool->pool_priv);
     if (ret != UMF_RESULT_SUCCESS) {
@@ -170,3 +204,20 @@ umf_result_t umfPoolGetLastAllocationError(umf_memory_pool_handle_t hPool) {
     UMF_CHECK((hPool != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
     return hPool->ops.get_last_allocation_error(hPool->pool_priv);
 }
+
+umf_result_t umfPoolTrim(umf_memory_pool_handle_t hPool, size_t size,
+                         size_t *released) {
+    UMF_CHECK((hPool != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    size_t bytes = 0;
+    umf_result_t ret = UMF_RESULT_ERROR_NOT_SUPPORTED;
+    if (hPool->ops.trim) {
+        ret = hPool->ops.trim(hPool->pool_priv, size, &bytes);
+    }
+
+    if (released) {
+        *released = bytes;
+    }
+
+    return ret;
+}
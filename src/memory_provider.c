@@ -9,8 +9,10 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <umf/memory_provider.h>
 
@@ -19,12 +21,77 @@
 #include "libumf.h"
 #include "memory_provider_internal.h"
 #include "utils_assert.h"
+#include "utils_log.h"
 
 typedef struct umf_memory_provider_t {
     umf_memory_provider_ops_t ops;
     void *provider_priv;
 } umf_memory_provider_t;
 
+// the oldest version of the ops accepted by umfMemoryProviderCreate()
+#define PROVIDER_OPS_MIN_VERSION UMF_MAKE_VERSION(0, 9)
+
+// commit, decommit and alloc_with_zero_info were added to the ext ops
+// in the version 0.10 of the ops
+#define PROVIDER_OPS_COMMIT_VERSION UMF_MAKE_VERSION(0, 10)
+
+// Layout of the ops of the version 0.9, the ext ops ended with
+// allocation_split and were directly followed by the IPC ops.
+typedef struct umf_memory_provider_ext_ops_0_9_t {
+    umf_result_t (*purge_lazy)(void *provider, void *ptr, size_t size);
+    umf_result_t (*purge_force)(void *provider, void *ptr, size_t size);
+    umf_result_t (*allocation_merge)(void *hProvider, void *lowPtr,
+                                     void *highPtr, size_t totalSize);
+    umf_result_t (*allocation_split)(void *hProvider, void *ptr,
+                                     size_t totalSize, size_t firstSize);
+} umf_memory_provider_ext_ops_0_9_t;
+
+typedef struct umf_memory_provider_ops_0_9_t {
+    uint32_t version;
+    umf_result_t (*initialize)(void *params, void **provider);
+    void (*finalize)(void *provider);
+    umf_result_t (*alloc)(void *provider, size_t size, size_t alignment,
+                          void **ptr);
+    umf_result_t (*free)(void *provider, void *ptr, size_t size);
+    void (*get_last_native_error)(void *provider, const char **ppMessage,
+                                  int32_t *pError);
+    umf_result_t (*get_recommended_page_size)(void *provider, size_t size,
+                                              size_t *pageSize);
+    umf_result_t (*get_min_page_size)(void *provider, void *ptr,
+                                      size_t *pageSize);
+    const char *(*get_name)(void *provider);
+    umf_memory_provider_ext_ops_0_9_t ext;
+    umf_memory_provider_ipc_ops_t ipc;
+} umf_memory_provider_ops_0_9_t;
+
+// Copies the ops of the given version into the current layout,
+// the ops added in later versions are set to NULL.
+static umf_result_t copyOps(umf_memory_provider_ops_t *dst,
+                            const umf_memory_provider_ops_t *src) {
+    if (src->version < PROVIDER_OPS_MIN_VERSION ||
+        src->version > UMF_VERSION_CURRENT) {
+        LOG_ERR("unsupported version of the memory provider ops: %d.%d",
+                UMF_MAJOR_VERSION(src->version),
+                UMF_MINOR_VERSION(src->version));
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (src->version >= PROVIDER_OPS_COMMIT_VERSION) {
+        *dst = *src;
+        return UMF_RESULT_SUCCESS;
+    }
+
+    const umf_memory_provider_ops_0_9_t *old =
+        (const umf_memory_provider_ops_0_9_t *)src;
+
+    memset(dst, 0, sizeof(*dst));
+    memcpy(dst, old, offsetof(umf_memory_provider_ops_0_9_t, ext));
+    memcpy(&dst->ext, &old->ext, sizeof(old->ext));
+    dst->ipc = old->ipc;
+
+    return UMF_RESULT_SUCCESS;
+}
+
 static umf_result_t umfDefaultPurgeLazy(void *provider, void *ptr,
                                         size_t size) {
     (void)provider;
@@ -98,6 +165,21 @@ static umf_result_t umfDefaultCloseIPCHandle(void *provider, void *ptr,
     return UMF_RESULT_ERROR_NOT_SUPPORTED;
 }
 
+static umf_result_t umfDefaultCommit(void *provider, void *ptr, size_t size) {
+    (void)provider;
+    (void)ptr;
+    (void)size;
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
+static umf_result_t umfDefaultDecommit(void *provider, void *ptr,
+                                       size_t size) {
+    (void)provider;
+    (void)ptr;
+    (void)size;
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
 void assignOpsExtDefaults(umf_memory_provider_ops_t *ops) {
     if (!ops->ext.purge_lazy) {
         ops->ext.purge_lazy = umfDefaultPurgeLazy;
@@ -111,6 +193,12 @@ void assignOpsExtDefaults(umf_memory_provider_ops_t *ops) {
     if (!ops->ext.allocation_merge) {
         ops->ext.allocation_merge = umfDefaultAllocationMerge;
     }
+    if (!ops->ext.commit) {
+        ops->ext.commit = umfDefaultCommit;
+    }
+    if (!ops->ext.decommit) {
+        ops->ext.decommit = umfDefaultDecommit;
+    }
 }
 
 void assignOpsIpcDefaults(umf_memory_provider_ops_t *ops) {
@@ -163,7 +251,17 @@ umf_result_t umfMemoryProviderCreate(const umf_memory_provider_ops_t *ops,
                                      void *params,
                                      umf_memory_provider_handle_t *hProvider) {
     libumfInit();
-    if (!ops || !hProvider || !validateOps(ops)) {
+    if (!ops || !hProvider) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_memory_provider_ops_t provider_ops;
+    umf_result_t ret = copyOps(&provider_ops, ops);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    if (!validateOps(&provider_ops)) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
@@ -173,15 +271,13 @@ umf_result_t umfMemoryProviderCreate(const umf_memory_provider_ops_t *ops,
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    assert(ops->version == UMF_VERSION_CURRENT);
-
-    provider->ops = *ops;
+    provider->ops = provider_ops;
 
     assignOpsExtDefaults(&(provider->ops));
     assignOpsIpcDefaults(&(provider->ops));
 
     void *provider_priv;
-    umf_result_t ret = ops->initialize(params, &provider_priv);
+    ret = provider->ops.initialize(params, &provider_priv);
     if (ret != UMF_RESULT_SUCCESS) {
         umf_ba_global_free(provider);
         return ret;
@@ -216,6 +312,31 @@ umf_result_t umfMemoryProviderAlloc(umf_memory_provider_handle_t hProvider,
     return res;
 }
 
+umf_result_t
+umfMemoryProviderAllocWithZeroInfo(umf_memory_provider_handle_t hProvider,
+                                   size_t size, size_t alignment, void **ptr,
+                                   int *zeroed) {
+    UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    UMF_CHECK((zeroed != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // the op is optional and has no default, because the default
+    // would not get the provider handle to call alloc() with
+    if (!hProvider->ops.ext.alloc_with_zero_info) {
+        *zeroed = 0;
+        return umfMemoryProviderAlloc(hProvider, size, alignment, ptr);
+    }
+
+    umf_result_t res = hProvider->ops.ext.alloc_with_zero_info(
+        hProvider->provider_priv, size, alignment, ptr, zeroed);
+    checkErrorAndSetLastProvider(res, hProvider);
+    return res;
+}
+
+int umfMemoryProviderReportsZeroInfo(umf_memory_provider_handle_t hProvider) {
+    assert(hProvider);
+    return hProvider->ops.ext.alloc_with_zero_info != NULL;
+}
+
 umf_result_t umfMemoryProviderFree(umf_memory_provider_handle_t hProvider,
                                    void *ptr, size_t size) {
     UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
@@ -280,6 +401,52 @@ umf_result_t umfMemoryProviderPurgeForce(umf_memory_provider_handle_t hProvider,
     return res;
 }
 
+// Checks if the range to be (de)committed is aligned to the minimum page size
+// of the provider. A provider not reporting its page size is not checked here.
+static umf_result_t checkRangeAlignment(umf_memory_provider_handle_t hProvider,
+                                        void *ptr, size_t size) {
+    size_t page_size = 0;
+    umf_result_t res = hProvider->ops.get_min_page_size(
+        hProvider->provider_priv, ptr, &page_size);
+    if (res != UMF_RESULT_SUCCESS || page_size == 0) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if ((uintptr_t)ptr % page_size || size % page_size) {
+        LOG_ERR("range (ptr=%p, size=%zu) is not aligned to the page size %zu",
+                ptr, size, page_size);
+        return UMF_RESULT_ERROR_INVALID_ALIGNMENT;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfMemoryProviderCommit(umf_memory_provider_handle_t hProvider,
+                                     void *ptr, size_t size) {
+    UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    umf_result_t res = checkRangeAlignment(hProvider, ptr, size);
+    if (res != UMF_RESULT_SUCCESS) {
+        return res;
+    }
+
+    res = hProvider->ops.ext.commit(hProvider->provider_priv, ptr, size);
+    checkErrorAndSetLastProvider(res, hProvider);
+    return res;
+}
+
+umf_result_t umfMemoryProviderDecommit(umf_memory_provider_handle_t hProvider,
+                                       void *ptr, size_t size) {
+    UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    umf_result_t res = checkRangeAlignment(hProvider, ptr, size);
+    if (res != UMF_RESULT_SUCCESS) {
+        return res;
+    }
+
+    res = hProvider->ops.ext.decommit(hProvider->provider_priv, ptr, size);
+    checkErrorAndSetLastProvider(res, hProvider);
+    return res;
+}
+
 umf_memory_provider_handle_t umfGetLastFailedMemoryProvider(void) {
     return *umfGetLastFailedMemoryProviderPtr();
 }
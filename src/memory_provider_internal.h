@@ -17,6 +17,10 @@ extern "C" {
 #endif
 
 void *umfMemoryProviderGetPriv(umf_memory_provider_handle_t hProvider);
+
+// Returns 1 if the provider reports whether the memory it allocates is
+// zero-filled (it implements the alloc_with_zero_info op) and 0 otherwise.
+int umfMemoryProviderReportsZeroInfo(umf_memory_provider_handle_t hProvider);
 umf_memory_provider_handle_t *umfGetLastFailedMemoryProviderPtr(void);
 
 #ifdef __cplusplus
@@ -8,14 +8,15 @@
 #include <bitset>
 #include <cassert>
 #include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <limits>
-#include <list>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
+#include <new>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -25,8 +26,13 @@
 #include "provider/provider_tracking.h"
 
 #include "../cpp_helpers.hpp"
+#include "base_alloc_global.h"
+#include "critnib.h"
+#include "memory_pool_internal.h"
 #include "pool_disjoint.h"
+#include "pool_disjoint_internal.h"
 #include "umf.h"
+#include "utils_concurrency.h"
 #include "utils_log.h"
 #include "utils_math.h"
 #include "utils_sanitizers.h"
@@ -50,6 +56,13 @@ class DisjointPool {
     size_t malloc_usable_size(void *);
     umf_result_t free(void *ptr);
     umf_result_t get_last_allocation_error();
+    umf_result_t trim(size_t size, size_t *released);
+
+    // Get the statistics of all the buckets of the pool
+    void getStats(std::vector<umf_disjoint_pool_bucket_stats_t> &Stats);
+
+    // Replace the clock of the decay of the pooled slabs (for testing)
+    void setClock(uint64_t (*Clock)(void));
 
     DisjointPool();
     ~DisjointPool();
@@ -88,24 +101,6 @@ void umfDisjointPoolSharedLimitsDestroy(
 // go directly to the provider.
 static constexpr size_t CutOff = (size_t)1 << 31; // 2GB
 
-// Aligns the pointer down to the specified alignment
-// (e.g. returns 8 for Size = 13, Alignment = 8)
-static void *AlignPtrDown(void *Ptr, const size_t Alignment) {
-    return reinterpret_cast<void *>((reinterpret_cast<size_t>(Ptr)) &
-                                    (~(Alignment - 1)));
-}
-
-// Aligns the pointer up to the specified alignment
-// (e.g. returns 16 for Size = 13, Alignment = 8)
-static void *AlignPtrUp(void *Ptr, const size_t Alignment) {
-    void *AlignedPtr = AlignPtrDown(Ptr, Alignment);
-    // Special case when the pointer is already aligned
-    if (Ptr == AlignedPtr) {
-        return Ptr;
-    }
-    return static_cast<char *>(AlignedPtr) + Alignment;
-}
-
 // Aligns the value up to the specified alignment
 // (e.g. returns 16 for Size = 13, Alignment = 8)
 static size_t AlignUp(size_t Val, size_t Alignment) {
@@ -113,6 +108,26 @@ static size_t AlignUp(size_t Val, size_t Alignment) {
     return (Val + Alignment - 1) & (~(Alignment - 1));
 }
 
+// Update statistics counters which are modified by a single thread at a time
+// (e.g. under a lock), but may be read concurrently.
+static void addRelaxed(std::atomic<size_t> &Counter, size_t Value) {
+    Counter.store(Counter.load(std::memory_order_relaxed) + Value,
+                  std::memory_order_relaxed);
+}
+
+static void subRelaxed(std::atomic<size_t> &Counter, size_t Value) {
+    Counter.store(Counter.load(std::memory_order_relaxed) - Value,
+                  std::memory_order_relaxed);
+}
+
+static void maxRelaxed(std::atomic<size_t> &Max,
+                       const std::atomic<size_t> &Value) {
+    auto Val = Value.load(std::memory_order_relaxed);
+    if (Val > Max.load(std::memory_order_relaxed)) {
+        Max.store(Val, std::memory_order_relaxed);
+    }
+}
+
 typedef struct MemoryProviderError {
     umf_result_t code;
 } MemoryProviderError_t;
@@ -124,15 +139,16 @@ class Bucket;
 // chunks depends of the size of a Bucket which created the Slab.
 // Note: Bucket's methods are responsible for thread safety of Slab access,
 // so no locking happens here.
+// The Slab object is allocated from the base allocator together with its
+// chunk bitmaps, which directly follow the object, so creating a slab does
+// not call the general-purpose heap.
 class Slab {
 
     // Pointer to the allocated memory of SlabMinSize bytes
     void *MemPtr;
 
-    // Represents the current state of each chunk:
-    // if the bit is set then the chunk is allocated
-    // the chunk is free for allocation otherwise
-    std::vector<bool> Chunks;
+    // Number of chunks in the slab
+    size_t NumChunks;
 
     // Total number of allocated chunks at the moment.
     size_t NumAllocated = 0;
@@ -140,14 +156,44 @@ class Slab {
     // The bucket which the slab belongs to
     Bucket &bucket;
 
-    using ListIter = std::list<std::unique_ptr<Slab>>::iterator;
+    // Hooks of the avail/unavail list of the bucket the slab is on
+    Slab *Prev = nullptr;
+    Slab *Next = nullptr;
+    friend class SlabList;
 
-    // Store iterator to the corresponding node in avail/unavail list
-    // to achieve O(1) removal
-    ListIter SlabListIter;
+    // When the slab was put in the pool and whether its memory was purged
+    // since then, used to decay the pooled slabs.
+    std::chrono::steady_clock::time_point PooledAt;
+    bool Purged = false;
 
-    // Hints where to start search for free chunk in a slab
-    size_t FirstFreeChunkIdx = 0;
+    // Whether the memory of the slab is known to be zero-filled,
+    // i.e. it was not used since it was allocated from the memory provider
+    bool Zeroed = false;
+
+    // Number of words of the FreeChunks and FreeWords bitmaps
+    static size_t numChunksWords(size_t NumChunks) {
+        return (NumChunks + 63) / 64;
+    }
+    static size_t numSummaryWords(size_t NumChunks) {
+        return (numChunksWords(NumChunks) + 63) / 64;
+    }
+
+    // Summary of FreeChunks: the bit is set if the corresponding word
+    // of FreeChunks has at least one free chunk, so the first free chunk
+    // is found with two bit scans (for up to 64 * 64 * 64 chunks).
+    uint64_t *FreeWords() { return reinterpret_cast<uint64_t *>(this + 1); }
+    const uint64_t *FreeWords() const {
+        return reinterpret_cast<const uint64_t *>(this + 1);
+    }
+
+    // Represents the current state of each chunk:
+    // if the bit is set then the chunk is free for allocation,
+    // the chunk is allocated otherwise.
+    // Bits beyond the last chunk are never set.
+    uint64_t *FreeChunks() { return FreeWords() + numSummaryWords(NumChunks); }
+    const uint64_t *FreeChunks() const {
+        return FreeWords() + numSummaryWords(NumChunks);
+    }
 
     // Return the index of the first available chunk, SIZE_MAX otherwise
     size_t FindFirstAvailableChunkIdx() const;
@@ -155,15 +201,16 @@ class Slab {
     // Register/Unregister the slab in the global slab address map.
     void regSlab(Slab &);
     void unregSlab(Slab &);
-    static void regSlabByAddr(void *, Slab &);
-    static void unregSlabByAddr(void *, Slab &);
 
-  public:
-    Slab(Bucket &);
+    Slab(Bucket &, size_t NumChunks);
     ~Slab();
 
-    void setIterator(ListIter It) { SlabListIter = It; }
-    ListIter getIterator() const { return SlabListIter; }
+  public:
+    // Allocate a new slab for the bucket along with its metadata.
+    static Slab *create(Bucket &);
+
+    // Free the slab and its metadata.
+    static void destroy(Slab *);
 
     size_t getNumAllocated() const { return NumAllocated; }
 
@@ -177,24 +224,85 @@ class Slab {
     void *getEnd() const;
 
     size_t getChunkSize() const;
-    size_t getNumChunks() const { return Chunks.size(); }
+    size_t getNumChunks() const { return NumChunks; }
 
     bool hasAvail();
 
+    // Note that the (entirely free) slab was put in the pool at Now.
+    void setPooled(std::chrono::steady_clock::time_point Now) {
+        PooledAt = Now;
+        Purged = false;
+    }
+    std::chrono::steady_clock::time_point getPooledAt() const {
+        return PooledAt;
+    }
+
+    bool isPurged() const { return Purged; }
+    void setPurged() { Purged = true; }
+
+    // Returns whether the memory of the slab is still zero-filled
+    // and notes that it is going to be used.
+    bool takeZeroed() {
+        bool WasZeroed = Zeroed;
+        Zeroed = false;
+        return WasZeroed;
+    }
+
     Bucket &getBucket();
     const Bucket &getBucket() const;
 
     void freeChunk(void *Ptr);
 };
 
+// Intrusive doubly-linked list of slabs, linked through the hooks
+// in the Slab objects.
+class SlabList {
+    Slab *Head = nullptr;
+    size_t Count = 0;
+
+  public:
+    bool empty() const { return Head == nullptr; }
+    size_t size() const { return Count; }
+    Slab *front() const { return Head; }
+    static Slab *next(const Slab *S) { return S->Next; }
+
+    void push_front(Slab *S) {
+        S->Prev = nullptr;
+        S->Next = Head;
+        if (Head) {
+            Head->Prev = S;
+        }
+        Head = S;
+        Count++;
+    }
+
+    void remove(Slab *S) {
+        if (S->Prev) {
+            S->Prev->Next = S->Next;
+        } else {
+            assert(Head == S && "Slab is not on the list");
+            Head = S->Next;
+        }
+        if (S->Next) {
+            S->Next->Prev = S->Prev;
+        }
+        S->Prev = S->Next = nullptr;
+        Count--;
+    }
+};
+
 class Bucket {
     const size_t Size;
 
+    // Alignment of the slabs requested from the memory provider,
+    // 0 for the default alignment of the provider.
+    const size_t Alignment;
+
     // List of slabs which have at least 1 available chunk.
-    std::list<std::unique_ptr<Slab>> AvailableSlabs;
+    SlabList AvailableSlabs;
 
     // List of slabs with 0 available chunk.
-    std::list<std::unique_ptr<Slab>> UnavailableSlabs;
+    SlabList UnavailableSlabs;
 
     // Protects the bucket and all the corresponding slabs
     std::mutex BucketLock;
@@ -222,40 +330,63 @@ class Bucket {
     // if a slab in this bucket is already pooled.
     size_t chunkedSlabsInPool;
 
-    // Statistics
-    size_t allocPoolCount;
-    size_t freeCount;
-    size_t currSlabsInUse;
-    size_t currSlabsInPool;
-    size_t maxSlabsInPool;
+    // Statistics, always collected and read without the bucket lock.
+    // The allocation and free counts are updated outside of the lock,
+    // the other counters only under the lock.
+    std::atomic<size_t> allocCount;
+    std::atomic<size_t> allocPoolCount;
+    std::atomic<size_t> freeCount;
+    std::atomic<size_t> currSlabsInUse;
+    std::atomic<size_t> maxSlabsInUse;
+    std::atomic<size_t> currSlabsInPool;
+    std::atomic<size_t> maxSlabsInPool;
+    std::atomic<size_t> chunksAllocated;
 
   public:
-    // Statistics
-    size_t allocCount;
-    size_t maxSlabsInUse;
+    Bucket(size_t Sz, DisjointPool::AllocImpl &AllocCtx, size_t Align = 0)
+        : Size{Sz}, Alignment{Align}, OwnAllocCtx{AllocCtx},
+          chunkedSlabsInPool(0), allocCount(0), allocPoolCount(0),
+          freeCount(0), currSlabsInUse(0), maxSlabsInUse(0),
+          currSlabsInPool(0), maxSlabsInPool(0), chunksAllocated(0) {}
 
-    Bucket(size_t Sz, DisjointPool::AllocImpl &AllocCtx)
-        : Size{Sz}, OwnAllocCtx{AllocCtx}, chunkedSlabsInPool(0),
-          allocPoolCount(0), freeCount(0), currSlabsInUse(0),
-          currSlabsInPool(0), maxSlabsInPool(0), allocCount(0),
-          maxSlabsInUse(0) {}
+    ~Bucket();
 
     // Get pointer to allocation that is one piece of an available slab in this
     // bucket.
     void *getChunk(bool &FromPool);
 
+    // Get up to Count chunks of available slabs at once and append them
+    // (along with their slabs) to Chunks. Returns the number of chunks taken.
+    size_t getChunks(size_t Count, std::vector<std::pair<void *, Slab *>> &Chunks,
+                     bool &FromPool);
+
     // Get pointer to allocation that is a full slab in this bucket.
-    void *getSlab(bool &FromPool);
+    // Zeroed is set if the memory of the slab is known to be zero-filled.
+    void *getSlab(bool &FromPool, bool &Zeroed);
 
     // Return the allocation size of this bucket.
     size_t getSize() const { return Size; }
 
+    // Return the alignment of the slabs of this bucket.
+    size_t getAlignment() const { return Alignment; }
+
     // Free an allocation that is one piece of a slab in this bucket.
     void freeChunk(void *Ptr, Slab &Slab, bool &ToPool);
 
+    // Free Count chunks of slabs in this bucket at once.
+    void freeChunks(const std::pair<void *, Slab *> *Chunks, size_t Count);
+
     // Free an allocation that is a full slab in this bucket.
     void freeSlab(Slab &Slab, bool &ToPool);
 
+    // Purge the slabs idle in the pool for DecayMs and free the slabs idle
+    // for twice that time. Does nothing if the bucket is locked.
+    void decay(std::chrono::steady_clock::time_point Now);
+
+    // Free the slabs kept in the pool until at least Size bytes are
+    // released (all of them if Size is 0). Returns the released size.
+    size_t releasePooledSlabs(size_t Size);
+
     umf_memory_provider_handle_t getMemHandle();
 
     DisjointPool::AllocImpl &getAllocCtx() { return OwnAllocCtx; }
@@ -284,31 +415,106 @@ class Bucket {
     // Update free count
     void countFree();
 
+    // Add the counts of allocations and frees served by a thread cache
+    void addCounts(size_t Allocs, size_t PoolAllocs, size_t Frees);
+
     // Update statistics of Available/Unavailable
     void updateStats(int InUse, int InPool);
 
-    // Print bucket statistics
-    void printStats(bool &TitlePrinted, const std::string &Label);
+    // Fill the statistics of this bucket
+    void getStats(umf_disjoint_pool_bucket_stats_t &Stats);
 
   private:
     void onFreeChunk(Slab &, bool &ToPool);
 
+    // Note that the slab was put in the pool, if the decay is enabled.
+    void onSlabPooled(Slab &Slab);
+
+    // Free a slab kept in the pool, the lock must be acquired.
+    void destroyPooledSlab(Slab *Slab);
+
+    // Get a chunk of an available slab, the lock must be acquired.
+    void *getChunkLocked(bool &FromPool, Slab *&ChunkSlab);
+
     // Update statistics of pool usage, and indicate that an allocation was made
     // from the pool.
     void decrementPool(bool &FromPool);
 
     // Get a slab to be used for chunked allocations.
-    decltype(AvailableSlabs.begin()) getAvailSlab(bool &FromPool);
+    Slab *getAvailSlab(bool &FromPool);
 
     // Get a slab that will be used as a whole for a single allocation.
-    decltype(AvailableSlabs.begin()) getAvailFullSlab(bool &FromPool);
+    Slab *getAvailFullSlab(bool &FromPool);
+};
+
+// The clock of the decay is checked only once per DecayCheckInterval
+// allocations and deallocations of a pool.
+static constexpr unsigned DecayCheckInterval = 256;
+
+// Free chunks of the buckets of a single pool cached by a single thread,
+// so that most allocations and deallocations of chunks do not lock
+// the buckets. Chunks are moved between the cache and the buckets in batches.
+// From the buckets' point of view, the cached chunks are allocated.
+struct ThreadCache {
+    using Entry = std::pair<void *, Slab *>;
+
+    ThreadCache(DisjointPool::AllocImpl *Pool, size_t NumBuckets)
+        : Pool(Pool), Chunks(NumBuckets),
+          BucketCounts(std::make_unique<Counts[]>(NumBuckets)) {}
+
+    // The pool the chunks are cached for or nullptr if the cache was already
+    // flushed by the pool destruction or the owning thread exit.
+    std::atomic<DisjointPool::AllocImpl *> Pool;
+
+    // Protects the cache against concurrent flushes on the pool destruction
+    // and on the owning thread exit. The owning thread does not take it
+    // while it uses the cache, because the pool cannot be destroyed then.
+    std::mutex Lock;
+
+    // Free chunks of each bucket, indexed like the buckets of the pool
+    std::vector<std::vector<Entry>> Chunks;
+
+    // Allocations and frees of each bucket served by the cache. They are
+    // updated only by the owning thread and moved to the bucket statistics
+    // when the cache is flushed.
+    struct Counts {
+        std::atomic<size_t> Allocs{0};
+        std::atomic<size_t> PoolAllocs{0};
+        std::atomic<size_t> Frees{0};
+    };
+    std::unique_ptr<Counts[]> BucketCounts;
+
+    // Operations of the owning thread left until the clock of the decay
+    // of the pooled slabs is checked
+    unsigned DecayCountdown = DecayCheckInterval;
+
+    // Return all the cached chunks to the buckets, the lock must be acquired.
+    void flush();
+};
+
+// All caches of the calling thread, flushed when the thread exits
+class ThreadCaches {
+    std::vector<std::shared_ptr<ThreadCache>> Caches;
+
+  public:
+    // Returns the cache of the calling thread for the given pool
+    ThreadCache *get(DisjointPool::AllocImpl *Pool);
+
+    // Returns the cache of the calling thread for the given pool
+    // or nullptr if the thread has not created it yet.
+    ThreadCache *find(DisjointPool::AllocImpl *Pool);
+
+    ~ThreadCaches();
 };
 
+static thread_local ThreadCaches TLSThreadCaches;
+
 class DisjointPool::AllocImpl {
     // It's important for the map to be destroyed last after buckets and their
     // slabs This is because slab's destructor removes the object from the map.
-    std::unordered_multimap<void *, Slab &> KnownSlabs;
-    std::shared_timed_mutex KnownSlabsMapLock;
+    // The map is keyed by the start address of the slab, so the slab
+    // of a pointer is found by a lock-free critnib_find(FIND_LE) lookup.
+    std::unique_ptr<critnib, decltype(&critnib_delete)> KnownSlabs;
 
     // Handle to the memory provider
     umf_memory_provider_handle_t MemHandle;
@@ -328,28 +534,48 @@ class DisjointPool::AllocImpl {
     // Coarse-grain allocation min alignment
     size_t ProviderMinPageSize;
 
+    // Buckets for allocations aligned to more than ProviderMinPageSize,
+    // indexed by log2 of the alignment and created on first use.
+    // Their slabs are allocated with that alignment.
+    std::array<std::vector<std::unique_ptr<Bucket>>, sizeof(size_t) * 8>
+        AlignedBuckets;
+    std::array<std::once_flag, sizeof(size_t) * 8> AlignedBucketsOnce;
+    std::array<std::atomic<bool>, sizeof(size_t) * 8> AlignedBucketsCreated{};
+
+    // Caches of all threads using this pool (if enabled)
+    std::vector<std::shared_ptr<ThreadCache>> ThreadCachesList;
+    std::mutex ThreadCachesLock;
+
+    // Time (in steady_clock ticks) of the next decay of the pooled slabs
+    std::atomic<std::chrono::steady_clock::rep> NextDecay{0};
+
+    // Number of operations left until the clock of the decay is checked,
+    // used if the thread caches (which have their own countdowns) are off
+    std::atomic<unsigned> DecayCountdown{DecayCheckInterval};
+
+    // Returns the current time in milliseconds, replaces the steady clock
+    // for the decay if set (see umfDisjointPoolSetClock())
+    std::atomic<uint64_t (*)(void)> Clock{nullptr};
+
   public:
     AllocImpl(umf_memory_provider_handle_t hProvider,
               umf_disjoint_pool_params_t *params)
-        : MemHandle{hProvider}, params(*params) {
+        : KnownSlabs{critnib_new(), critnib_delete}, MemHandle{hProvider},
+          params(*params) {
+        if (!KnownSlabs) {
+            throw std::bad_alloc();
+        }
 
         VALGRIND_DO_CREATE_MEMPOOL(this, 0, 0);
 
-        // Generate buckets sized such as: 64, 96, 128, 192, ..., CutOff.
-        // Powers of 2 and the value halfway between the powers of 2.
-        auto Size1 = this->params.MinBucketSize;
         // MinBucketSize cannot be larger than CutOff.
-        Size1 = std::min(Size1, CutOff);
+        auto MinBucketSize = std::min(this->params.MinBucketSize, CutOff);
         // Buckets sized smaller than the bucket default size- 8 aren't needed.
-        Size1 = std::max(Size1, UMF_DISJOINT_POOL_MIN_BUCKET_DEFAULT_SIZE);
+        MinBucketSize =
+            std::max(MinBucketSize, UMF_DISJOINT_POOL_MIN_BUCKET_DEFAULT_SIZE);
         // Calculate the exponent for MinBucketSize used for finding buckets.
-        MinBucketSizeExp = (size_t)log2Utils(Size1);
-        auto Size2 = Size1 + Size1 / 2;
-        for (; Size2 < CutOff; Size1 *= 2, Size2 *= 2) {
-            Buckets.push_back(std::make_unique<Bucket>(Size1, *this));
-            Buckets.push_back(std::make_unique<Bucket>(Size2, *this));
-        }
-        Buckets.push_back(std::make_unique<Bucket>(CutOff, *this));
+        MinBucketSizeExp = (size_t)log2Utils(MinBucketSize);
+        createBuckets(Buckets, 0);
 
         auto ret = umfMemoryProviderGetMinPageSize(hProvider, nullptr,
                                                    &ProviderMinPageSize);
@@ -358,20 +584,26 @@ class DisjointPool::AllocImpl {
         }
     }
 
-    ~AllocImpl() { VALGRIND_DO_DESTROY_MEMPOOL(this); }
+    ~AllocImpl() {
+        flushThreadCaches();
+        VALGRIND_DO_DESTROY_MEMPOOL(this);
+    }
 
-    void *allocate(size_t Size, size_t Alignment, bool &FromPool);
-    void *allocate(size_t Size, bool &FromPool);
+    // If Zeroed is given, it is set to whether the returned memory
+    // is known to be zero-filled.
+    void *allocate(size_t Size, size_t Alignment, bool &FromPool,
+                   bool *Zeroed = nullptr);
+    void *allocate(size_t Size, bool &FromPool, bool *Zeroed = nullptr);
+    void *reallocate(void *Ptr, size_t Size);
     void deallocate(void *Ptr, bool &ToPool);
 
+    // Returns the number of bytes available from Ptr to the end of its chunk
+    // (or provider allocation), 0 if it cannot be determined.
+    size_t getUsableSize(void *Ptr);
+
     umf_memory_provider_handle_t getMemHandle() { return MemHandle; }
 
-    std::shared_timed_mutex &getKnownSlabsMapLock() {
-        return KnownSlabsMapLock;
-    }
-    std::unordered_multimap<void *, Slab &> &getKnownSlabs() {
-        return KnownSlabs;
-    }
+    critnib *getKnownSlabs() { return KnownSlabs.get(); }
 
     size_t SlabMinSize() { return params.SlabMinSize; };
 
@@ -388,19 +620,87 @@ class DisjointPool::AllocImpl {
     void printStats(bool &TitlePrinted, size_t &HighBucketSize,
                     size_t &HighPeakSlabsInUse, const std::string &Label);
 
+    // Get the statistics of all the buckets created so far
+    void getStats(std::vector<umf_disjoint_pool_bucket_stats_t> &Stats);
+
+    // Free the pooled slabs until at least Size bytes are released
+    // (all of them if Size is 0). Returns the released size.
+    size_t trim(size_t Size);
+
+    Bucket &getBucket(size_t Idx) { return *Buckets[Idx]; }
+
+    // Create a new cache of the calling thread for this pool
+    std::shared_ptr<ThreadCache> createThreadCache();
+
+    // Current time of the clock used by the decay of the pooled slabs
+    std::chrono::steady_clock::time_point now() const;
+
+    void setClock(uint64_t (*NewClock)(void)) { Clock.store(NewClock); }
+
   private:
+    // Generate buckets sized such as: 64, 96, 128, 192, ..., CutOff.
+    // Powers of 2 and the value halfway between the powers of 2.
+    void createBuckets(std::vector<std::unique_ptr<Bucket>> &NewBuckets,
+                       size_t Alignment) {
+        auto Size1 = (size_t)1 << MinBucketSizeExp;
+        auto Size2 = Size1 + Size1 / 2;
+        for (; Size2 < CutOff; Size1 *= 2, Size2 *= 2) {
+            NewBuckets.push_back(
+                std::make_unique<Bucket>(Size1, *this, Alignment));
+            NewBuckets.push_back(
+                std::make_unique<Bucket>(Size2, *this, Alignment));
+        }
+        NewBuckets.push_back(
+            std::make_unique<Bucket>(CutOff, *this, Alignment));
+    }
+
     Bucket &findBucket(size_t Size);
+    Bucket &findAlignedBucket(size_t Size, size_t Alignment);
+
+    // Returns the slab containing Ptr, or nullptr if Ptr was allocated
+    // directly from the memory provider.
+    Slab *findSlab(void *Ptr);
+
+    // Returns the usable size of Ptr which belongs to the given slab.
+    size_t getUsableSize(void *Ptr, Slab &Slab);
     std::size_t sizeToIdx(size_t Size);
+
+    // Get a chunk from the bucket, through the cache of the calling thread
+    // if it is enabled.
+    void *getChunk(Bucket &Bucket, bool &FromPool);
+
+    // Free a chunk to the bucket, through the cache of the calling thread
+    // if it is enabled.
+    void freeChunk(Bucket &Bucket, void *Ptr, Slab &Slab, bool &ToPool);
+
+    // Flush the caches of all threads, called when the pool is destroyed.
+    void flushThreadCaches();
+
+    // Flush the cache of the calling thread, if it has one.
+    void flushOwnThreadCache();
+
+    // Decay the pooled slabs of all the buckets if it is time to do so.
+    // Called by the allocations and deallocations, the clock is checked
+    // only once per DecayCheckInterval calls of the pool (of each thread
+    // if the thread caches are enabled).
+    void decayIfDue();
+    void decayBuckets();
 };
 
 static void *memoryProviderAlloc(umf_memory_provider_handle_t hProvider,
-                                 size_t size, size_t alignment = 0) {
+                                 size_t size, size_t alignment = 0,
+                                 bool *Zeroed = nullptr) {
     void *ptr;
-    auto ret = umfMemoryProviderAlloc(hProvider, size, alignment, &ptr);
+    int zeroed;
+    auto ret = umfMemoryProviderAllocWithZeroInfo(hProvider, size, alignment,
+                                                  &ptr, &zeroed);
     if (ret != UMF_RESULT_SUCCESS) {
         throw MemoryProviderError{ret};
     }
     utils_annotate_memory_inaccessible(ptr, size);
+    if (Zeroed) {
+        *Zeroed = zeroed;
+    }
     return ptr;
 }
 
@@ -432,14 +732,56 @@ std::ostream &operator<<(std::ostream &Os, const Slab &Slab) {
     return Os;
 }
 
-Slab::Slab(Bucket &Bkt)
-    : // In case bucket size is not a multiple of SlabMinSize, we would have
-      // some padding at the end of the slab.
-      Chunks(Bkt.SlabMinSize() / Bkt.getSize()), NumAllocated{0},
-      bucket(Bkt), SlabListIter{}, FirstFreeChunkIdx{0} {
+Slab *Slab::create(Bucket &Bkt) {
+    // In case bucket size is not a multiple of SlabMinSize, we would have
+    // some padding at the end of the slab.
+    size_t NumChunks = Bkt.SlabMinSize() / Bkt.getSize();
+    size_t MetadataSize =
+        sizeof(Slab) + (numSummaryWords(NumChunks) + numChunksWords(NumChunks)) *
+                           sizeof(uint64_t);
+
+    void *Metadata = umf_ba_global_alloc(MetadataSize);
+    if (!Metadata) {
+        throw std::bad_alloc();
+    }
+
+    try {
+        return new (Metadata) Slab(Bkt, NumChunks);
+    } catch (...) {
+        umf_ba_global_free(Metadata);
+        throw;
+    }
+}
+
+void Slab::destroy(Slab *Slab) {
+    Slab->~Slab();
+    umf_ba_global_free(Slab);
+}
+
+Slab::Slab(Bucket &Bkt, size_t NumChunks)
+    : NumChunks(NumChunks), NumAllocated{0}, bucket(Bkt) {
+    size_t NumWords = numChunksWords(NumChunks);
+    size_t NumSummaryWords = numSummaryWords(NumChunks);
+    std::fill_n(FreeChunks(), NumWords, ~(uint64_t)0);
+    std::fill_n(FreeWords(), NumSummaryWords, ~(uint64_t)0);
+
+    // clear the bits beyond the last chunk and the last word
+    if (NumChunks % 64) {
+        FreeChunks()[NumWords - 1] = ((uint64_t)1 << (NumChunks % 64)) - 1;
+    }
+    if (NumWords % 64) {
+        FreeWords()[NumSummaryWords - 1] = ((uint64_t)1 << (NumWords % 64)) - 1;
+    }
+
     auto SlabSize = Bkt.SlabAllocSize();
-    MemPtr = memoryProviderAlloc(Bkt.getMemHandle(), SlabSize);
-    regSlab(*this);
+    MemPtr = memoryProviderAlloc(Bkt.getMemHandle(), SlabSize,
+                                 Bkt.getAlignment(), &Zeroed);
+    try {
+        regSlab(*this);
+    } catch (...) {
+        memoryProviderFree(Bkt.getMemHandle(), MemPtr);
+        throw;
+    }
 }
 
 Slab::~Slab() {
@@ -472,11 +814,17 @@ Slab::~Slab() {
 
 // Return the index of the first available chunk, SIZE_MAX otherwise
 size_t Slab::FindFirstAvailableChunkIdx() const {
-    // Use the first free chunk index as a hint for the search.
-    auto It = std::find_if(Chunks.begin() + FirstFreeChunkIdx, Chunks.end(),
-                           [](auto x) { return !x; });
-    if (It != Chunks.end()) {
-        return It - Chunks.begin();
+    const uint64_t *Words = FreeWords();
+    const uint64_t *Chunks = FreeChunks();
+    size_t NumSummaryWords = numSummaryWords(NumChunks);
+
+    for (size_t SummaryIdx = 0; SummaryIdx < NumSummaryWords; SummaryIdx++) {
+        if (Words[SummaryIdx]) {
+            size_t WordIdx =
+                SummaryIdx * 64 + util_lssb_index(Words[SummaryIdx]);
+            assert(Chunks[WordIdx]);
+            return WordIdx * 64 + util_lssb_index(Chunks[WordIdx]);
+        }
     }
 
     return std::numeric_limits<size_t>::max();
@@ -491,11 +839,14 @@ void *Slab::getChunk() {
 
     void *const FreeChunk =
         (static_cast<uint8_t *>(getPtr())) + ChunkIdx * getChunkSize();
-    Chunks[ChunkIdx] = true;
-    NumAllocated += 1;
 
-    // Use the found index as the next hint
-    FirstFreeChunkIdx = ChunkIdx;
+    size_t WordIdx = ChunkIdx / 64;
+    FreeChunks()[WordIdx] &= ~((uint64_t)1 << (ChunkIdx % 64));
+    if (!FreeChunks()[WordIdx]) {
+        FreeWords()[WordIdx / 64] &= ~((uint64_t)1 << (WordIdx % 64));
+    }
+    NumAllocated += 1;
+    Zeroed = false;
 
     return FreeChunk;
 }
@@ -507,48 +858,24 @@ const Bucket &Slab::getBucket() const { return bucket; }
 
 size_t Slab::getChunkSize() const { return bucket.getSize(); }
 
-void Slab::regSlabByAddr(void *Addr, Slab &Slab) {
-    auto &Lock = Slab.getBucket().getAllocCtx().getKnownSlabsMapLock();
-    auto &Map = Slab.getBucket().getAllocCtx().getKnownSlabs();
-
-    std::lock_guard<std::shared_timed_mutex> Lg(Lock);
-    Map.insert({Addr, Slab});
-}
-
-void Slab::unregSlabByAddr(void *Addr, Slab &Slab) {
-    auto &Lock = Slab.getBucket().getAllocCtx().getKnownSlabsMapLock();
-    auto &Map = Slab.getBucket().getAllocCtx().getKnownSlabs();
-
-    std::lock_guard<std::shared_timed_mutex> Lg(Lock);
-
-    auto Slabs = Map.equal_range(Addr);
-    // At least the must get the current slab from the map.
-    assert(Slabs.first != Slabs.second && "Slab is not found");
-
-    for (auto It = Slabs.first; It != Slabs.second; ++It) {
-        if (It->second == Slab) {
-            Map.erase(It);
-            return;
-        }
-    }
-
-    assert(false && "Slab is not found");
-}
-
 void Slab::regSlab(Slab &Slab) {
-    void *StartAddr = AlignPtrDown(Slab.getPtr(), bucket.SlabMinSize());
-    void *EndAddr = static_cast<char *>(StartAddr) + bucket.SlabMinSize();
-
-    regSlabByAddr(StartAddr, Slab);
-    regSlabByAddr(EndAddr, Slab);
+    auto *Map = Slab.getBucket().getAllocCtx().getKnownSlabs();
+
+    // the size of the slab is stored in the leaf to check the range
+    // of a freed pointer without touching the slab itself
+    int ret = critnib_insert_aux(Map, (uintptr_t)Slab.getPtr(), &Slab,
+                                 Slab.getBucket().SlabAllocSize(), 0);
+    if (ret != 0) {
+        throw std::bad_alloc();
+    }
 }
 
 void Slab::unregSlab(Slab &Slab) {
-    void *StartAddr = AlignPtrDown(Slab.getPtr(), bucket.SlabMinSize());
-    void *EndAddr = static_cast<char *>(StartAddr) + bucket.SlabMinSize();
+    auto *Map = Slab.getBucket().getAllocCtx().getKnownSlabs();
 
-    unregSlabByAddr(StartAddr, Slab);
-    unregSlabByAddr(EndAddr, Slab);
+    [[maybe_unused]] void *Removed =
+        critnib_remove(Map, (uintptr_t)Slab.getPtr());
+    assert(Removed == &Slab && "Slab is not found");
 }
 
 void Slab::freeChunk(void *Ptr) {
@@ -563,15 +890,15 @@ void Slab::freeChunk(void *Ptr) {
     auto ChunkIdx = (static_cast<char *>(Ptr) - static_cast<char *>(MemPtr)) /
                     getChunkSize();
 
+    size_t WordIdx = ChunkIdx / 64;
+    uint64_t ChunkBit = (uint64_t)1 << (ChunkIdx % 64);
+
     // Make sure that the chunk was allocated
-    assert(Chunks[ChunkIdx] && "double free detected");
+    assert(!(FreeChunks()[WordIdx] & ChunkBit) && "double free detected");
 
-    Chunks[ChunkIdx] = false;
+    FreeChunks()[WordIdx] |= ChunkBit;
+    FreeWords()[WordIdx / 64] |= (uint64_t)1 << (WordIdx % 64);
     NumAllocated -= 1;
-
-    if (ChunkIdx < FirstFreeChunkIdx) {
-        FirstFreeChunkIdx = ChunkIdx;
-    }
 }
 
 void *Slab::getEnd() const {
@@ -588,59 +915,61 @@ void Bucket::decrementPool(bool &FromPool) {
     OwnAllocCtx.getLimits()->TotalSize -= SlabAllocSize();
 }
 
-auto Bucket::getAvailFullSlab(bool &FromPool)
-    -> decltype(AvailableSlabs.begin()) {
+Bucket::~Bucket() {
+    for (auto *List : {&AvailableSlabs, &UnavailableSlabs}) {
+        while (!List->empty()) {
+            auto *Slab = List->front();
+            List->remove(Slab);
+            Slab::destroy(Slab);
+        }
+    }
+}
+
+Slab *Bucket::getAvailFullSlab(bool &FromPool) {
     // Return a slab that will be used for a single allocation.
-    if (AvailableSlabs.size() == 0) {
-        auto It = AvailableSlabs.insert(AvailableSlabs.begin(),
-                                        std::make_unique<Slab>(*this));
-        (*It)->setIterator(It);
+    if (AvailableSlabs.empty()) {
+        AvailableSlabs.push_front(Slab::create(*this));
         FromPool = false;
         updateStats(1, 0);
     } else {
         decrementPool(FromPool);
     }
 
-    return AvailableSlabs.begin();
+    return AvailableSlabs.front();
 }
 
-void *Bucket::getSlab(bool &FromPool) {
+void *Bucket::getSlab(bool &FromPool, bool &Zeroed) {
     std::lock_guard<std::mutex> Lg(BucketLock);
 
-    auto SlabIt = getAvailFullSlab(FromPool);
-    auto *FreeSlab = (*SlabIt)->getSlab();
-    auto It =
-        UnavailableSlabs.insert(UnavailableSlabs.begin(), std::move(*SlabIt));
-    AvailableSlabs.erase(SlabIt);
-    (*It)->setIterator(It);
-    return FreeSlab;
+    auto *Slab = getAvailFullSlab(FromPool);
+    AvailableSlabs.remove(Slab);
+    UnavailableSlabs.push_front(Slab);
+    addRelaxed(chunksAllocated, 1);
+    Zeroed = Slab->takeZeroed();
+    return Slab->getSlab();
 }
 
 void Bucket::freeSlab(Slab &Slab, bool &ToPool) {
     std::lock_guard<std::mutex> Lg(BucketLock);
-    auto SlabIter = Slab.getIterator();
-    assert(SlabIter != UnavailableSlabs.end());
+    UnavailableSlabs.remove(&Slab);
+    subRelaxed(chunksAllocated, 1);
     if (CanPool(ToPool)) {
-        auto It =
-            AvailableSlabs.insert(AvailableSlabs.begin(), std::move(*SlabIter));
-        UnavailableSlabs.erase(SlabIter);
-        (*It)->setIterator(It);
+        onSlabPooled(Slab);
+        AvailableSlabs.push_front(&Slab);
     } else {
-        UnavailableSlabs.erase(SlabIter);
+        Slab::destroy(&Slab);
     }
 }
 
-auto Bucket::getAvailSlab(bool &FromPool) -> decltype(AvailableSlabs.begin()) {
+Slab *Bucket::getAvailSlab(bool &FromPool) {
 
-    if (AvailableSlabs.size() == 0) {
-        auto It = AvailableSlabs.insert(AvailableSlabs.begin(),
-                                        std::make_unique<Slab>(*this));
-        (*It)->setIterator(It);
+    if (AvailableSlabs.empty()) {
+        AvailableSlabs.push_front(Slab::create(*this));
 
         updateStats(1, 0);
         FromPool = false;
     } else {
-        if ((*(AvailableSlabs.begin()))->getNumAllocated() == 0) {
+        if (AvailableSlabs.front()->getNumAllocated() == 0) {
             // If this was an empty slab, it was in the pool.
             // Now it is no longer in the pool, so update count.
             --chunkedSlabsInPool;
@@ -651,21 +980,51 @@ auto Bucket::getAvailSlab(bool &FromPool) -> decltype(AvailableSlabs.begin()) {
         }
     }
 
-    return AvailableSlabs.begin();
+    return AvailableSlabs.front();
 }
 
 void *Bucket::getChunk(bool &FromPool) {
     std::lock_guard<std::mutex> Lg(BucketLock);
 
-    auto SlabIt = getAvailSlab(FromPool);
-    auto *FreeChunk = (*SlabIt)->getChunk();
+    Slab *ChunkSlab;
+    return getChunkLocked(FromPool, ChunkSlab);
+}
+
+size_t Bucket::getChunks(size_t Count,
+                         std::vector<std::pair<void *, Slab *>> &Chunks,
+                         bool &FromPool) {
+    std::lock_guard<std::mutex> Lg(BucketLock);
+
+    // The chunks are from the pool unless any new slab had to be created.
+    FromPool = true;
+    size_t i = 0;
+    try {
+        for (; i < Count; i++) {
+            bool ChunkFromPool;
+            Slab *ChunkSlab;
+            void *Chunk = getChunkLocked(ChunkFromPool, ChunkSlab);
+            Chunks.emplace_back(Chunk, ChunkSlab);
+            FromPool = FromPool && ChunkFromPool;
+        }
+    } catch (MemoryProviderError &) {
+        // the chunks taken so far are still usable
+        if (i == 0) {
+            throw;
+        }
+    }
+
+    return i;
+}
+
+void *Bucket::getChunkLocked(bool &FromPool, Slab *&ChunkSlab) {
+    ChunkSlab = getAvailSlab(FromPool);
+    auto *FreeChunk = ChunkSlab->getChunk();
+    addRelaxed(chunksAllocated, 1);
 
-    // If the slab is full, move it to unavailable slabs and update its iterator
-    if (!((*SlabIt)->hasAvail())) {
-        auto It = UnavailableSlabs.insert(UnavailableSlabs.begin(),
-                                          std::move(*SlabIt));
-        AvailableSlabs.erase(SlabIt);
-        (*It)->setIterator(It);
+    // If the slab is full, move it to unavailable slabs
+    if (!ChunkSlab->hasAvail()) {
+        AvailableSlabs.remove(ChunkSlab);
+        UnavailableSlabs.push_front(ChunkSlab);
     }
 
     return FreeChunk;
@@ -679,21 +1038,29 @@ void Bucket::freeChunk(void *Ptr, Slab &Slab, bool &ToPool) {
     onFreeChunk(Slab, ToPool);
 }
 
+void Bucket::freeChunks(const std::pair<void *, Slab *> *Chunks,
+                        size_t Count) {
+    std::lock_guard<std::mutex> Lg(BucketLock);
+
+    for (size_t i = 0; i < Count; i++) {
+        // The slab may be destroyed by onFreeChunk() only when its last
+        // chunk is freed, so it cannot be used by any of the next chunks.
+        bool ToPool;
+        Chunks[i].second->freeChunk(Chunks[i].first);
+        onFreeChunk(*Chunks[i].second, ToPool);
+    }
+}
+
 // The lock must be acquired before calling this method
 void Bucket::onFreeChunk(Slab &Slab, bool &ToPool) {
     ToPool = true;
+    subRelaxed(chunksAllocated, 1);
 
     // In case if the slab was previously full and now has 1 available
     // chunk, it should be moved to the list of available slabs
     if (Slab.getNumAllocated() == (Slab.getNumChunks() - 1)) {
-        auto SlabIter = Slab.getIterator();
-        assert(SlabIter != UnavailableSlabs.end());
-
-        auto It =
-            AvailableSlabs.insert(AvailableSlabs.begin(), std::move(*SlabIter));
-        UnavailableSlabs.erase(SlabIter);
-
-        (*It)->setIterator(It);
+        UnavailableSlabs.remove(&Slab);
+        AvailableSlabs.push_front(&Slab);
     }
 
     // Check if slab is empty, and pool it if we can.
@@ -702,16 +1069,76 @@ void Bucket::onFreeChunk(Slab &Slab, bool &ToPool) {
         // If pool has capacity then put the slab in the pool.
         // The ToPool parameter indicates whether the Slab will be put in the
         // pool or freed.
-        if (!CanPool(ToPool)) {
-            // Note: since the slab is stored as unique_ptr, just remove it from
-            // the list to destroy the object.
-            auto It = Slab.getIterator();
-            assert(It != AvailableSlabs.end());
-            AvailableSlabs.erase(It);
+        if (CanPool(ToPool)) {
+            onSlabPooled(Slab);
+        } else {
+            AvailableSlabs.remove(&Slab);
+            Slab::destroy(&Slab);
+        }
+    }
+}
+
+void Bucket::onSlabPooled(Slab &Slab) {
+    if (OwnAllocCtx.getParams().DecayMs) {
+        Slab.setPooled(OwnAllocCtx.now());
+    }
+}
+
+void Bucket::decay(std::chrono::steady_clock::time_point Now) {
+    std::unique_lock<std::mutex> Lg(BucketLock, std::try_to_lock);
+    if (!Lg.owns_lock()) {
+        // the bucket is in use, it will be decayed next time
+        return;
+    }
+
+    auto DecayTime =
+        std::chrono::milliseconds(OwnAllocCtx.getParams().DecayMs);
+
+    // The entirely free slabs on the Available list are the pooled ones.
+    for (auto *S = AvailableSlabs.front(); S != nullptr;) {
+        auto *NextSlab = SlabList::next(S);
+        if (S->getNumAllocated() == 0) {
+            auto Idle = Now - S->getPooledAt();
+            if (Idle >= 2 * DecayTime) {
+                destroyPooledSlab(S);
+            } else if (Idle >= DecayTime && !S->isPurged()) {
+                // the pages are reclaimed only if the provider supports it
+                umfMemoryProviderPurgeLazy(getMemHandle(), S->getPtr(),
+                                           SlabAllocSize());
+                S->setPurged();
+            }
         }
+        S = NextSlab;
     }
 }
 
+size_t Bucket::releasePooledSlabs(size_t Size) {
+    std::lock_guard<std::mutex> Lg(BucketLock);
+
+    size_t Released = 0;
+    for (auto *S = AvailableSlabs.front();
+         S != nullptr && (Size == 0 || Released < Size);) {
+        auto *NextSlab = SlabList::next(S);
+        if (S->getNumAllocated() == 0) {
+            destroyPooledSlab(S);
+            Released += SlabAllocSize();
+        }
+        S = NextSlab;
+    }
+
+    return Released;
+}
+
+void Bucket::destroyPooledSlab(Slab *Slab) {
+    AvailableSlabs.remove(Slab);
+    if (getSize() <= ChunkCutOff()) {
+        --chunkedSlabsInPool;
+    }
+    updateStats(0, -1);
+    OwnAllocCtx.getLimits()->TotalSize -= SlabAllocSize();
+    Slab::destroy(Slab);
+}
+
 bool Bucket::CanPool(bool &ToPool) {
     size_t NewFreeSlabsInBucket;
     // Check if this bucket is used in chunked form or as full slabs.
@@ -773,29 +1200,51 @@ size_t Bucket::MaxPoolableSize() {
 size_t Bucket::ChunkCutOff() { return SlabMinSize() / 2; }
 
 void Bucket::countAlloc(bool FromPool) {
-    ++allocCount;
+    allocCount.fetch_add(1, std::memory_order_relaxed);
     if (FromPool) {
-        ++allocPoolCount;
+        allocPoolCount.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
-void Bucket::countFree() { ++freeCount; }
+void Bucket::countFree() { freeCount.fetch_add(1, std::memory_order_relaxed); }
 
+void Bucket::addCounts(size_t Allocs, size_t PoolAllocs, size_t Frees) {
+    allocCount.fetch_add(Allocs, std::memory_order_relaxed);
+    allocPoolCount.fetch_add(PoolAllocs, std::memory_order_relaxed);
+    freeCount.fetch_add(Frees, std::memory_order_relaxed);
+}
+
+// The lock must be acquired before calling this method
 void Bucket::updateStats(int InUse, int InPool) {
+    addRelaxed(currSlabsInUse, InUse);
+    maxRelaxed(maxSlabsInUse, currSlabsInUse);
+    addRelaxed(currSlabsInPool, InPool);
+    maxRelaxed(maxSlabsInPool, currSlabsInPool);
     if (OwnAllocCtx.getParams().PoolTrace == 0) {
         return;
     }
-    currSlabsInUse += InUse;
-    maxSlabsInUse = std::max(currSlabsInUse, maxSlabsInUse);
-    currSlabsInPool += InPool;
-    maxSlabsInPool = std::max(currSlabsInPool, maxSlabsInPool);
     // Increment or decrement current pool sizes based on whether
     // slab was added to or removed from pool.
     OwnAllocCtx.getParams().CurPoolSize += InPool * SlabAllocSize();
 }
 
-void Bucket::printStats(bool &TitlePrinted, const std::string &Label) {
-    if (allocCount) {
+void Bucket::getStats(umf_disjoint_pool_bucket_stats_t &Stats) {
+    Stats.Size = getSize();
+    Stats.Alignment = getAlignment();
+    Stats.SlabsInUse = currSlabsInUse.load(std::memory_order_relaxed);
+    Stats.PeakSlabsInUse = maxSlabsInUse.load(std::memory_order_relaxed);
+    Stats.SlabsInPool = currSlabsInPool.load(std::memory_order_relaxed);
+    Stats.PeakSlabsInPool = maxSlabsInPool.load(std::memory_order_relaxed);
+    Stats.ChunksAllocated = chunksAllocated.load(std::memory_order_relaxed);
+    Stats.AllocCount = allocCount.load(std::memory_order_relaxed);
+    Stats.FreeCount = freeCount.load(std::memory_order_relaxed);
+    Stats.PoolHits = allocPoolCount.load(std::memory_order_relaxed);
+    Stats.PoolMisses = Stats.AllocCount - Stats.PoolHits;
+}
+
+static void printBucketStats(const umf_disjoint_pool_bucket_stats_t &Stats,
+                             bool &TitlePrinted, const std::string &Label) {
+    if (Stats.AllocCount) {
         if (!TitlePrinted) {
             std::cout << Label << " memory statistics\n";
             std::cout << std::setw(14) << "Bucket Size" << std::setw(12)
@@ -805,23 +1254,32 @@ void Bucket::printStats(bool &TitlePrinted, const std::string &Label) {
                       << "Peak Slabs in Pool" << std::endl;
             TitlePrinted = true;
         }
-        std::cout << std::setw(14) << getSize() << std::setw(12) << allocCount
-                  << std::setw(12) << freeCount << std::setw(18)
-                  << allocPoolCount << std::setw(20) << maxSlabsInUse
-                  << std::setw(21) << maxSlabsInPool << std::endl;
+        std::cout << std::setw(14) << Stats.Size << std::setw(12)
+                  << Stats.AllocCount << std::setw(12) << Stats.FreeCount
+                  << std::setw(18) << Stats.PoolHits << std::setw(20)
+                  << Stats.PeakSlabsInUse << std::setw(21)
+                  << Stats.PeakSlabsInPool << std::endl;
     }
 }
 
-void *DisjointPool::AllocImpl::allocate(size_t Size, bool &FromPool) try {
+void *DisjointPool::AllocImpl::allocate(size_t Size, bool &FromPool,
+                                        bool *Zeroed) try {
     void *Ptr;
+    bool SlabZeroed = false;
+
+    if (Zeroed) {
+        *Zeroed = false;
+    }
 
     if (Size == 0) {
         return nullptr;
     }
 
+    decayIfDue();
+
     FromPool = false;
     if (Size > getParams().MaxPoolableSize) {
-        Ptr = memoryProviderAlloc(getMemHandle(), Size);
+        Ptr = memoryProviderAlloc(getMemHandle(), Size, 0, Zeroed);
         utils_annotate_memory_undefined(Ptr, Size);
         return Ptr;
     }
@@ -829,18 +1287,19 @@ void *DisjointPool::AllocImpl::allocate(size_t Size, bool &FromPool) try {
     auto &Bucket = findBucket(Size);
 
     if (Size > Bucket.ChunkCutOff()) {
-        Ptr = Bucket.getSlab(FromPool);
-    } else {
-        Ptr = Bucket.getChunk(FromPool);
-    }
-
-    if (getParams().PoolTrace > 1) {
+        Ptr = Bucket.getSlab(FromPool, SlabZeroed);
         Bucket.countAlloc(FromPool);
+    } else {
+        Ptr = getChunk(Bucket, FromPool);
     }
 
     VALGRIND_DO_MEMPOOL_ALLOC(this, Ptr, Size);
     utils_annotate_memory_undefined(Ptr, Bucket.getSize());
 
+    if (Zeroed) {
+        *Zeroed = SlabZeroed;
+    }
+
     return Ptr;
 } catch (MemoryProviderError &e) {
     umf::getPoolLastStatusRef<DisjointPool>() = e.code;
@@ -848,55 +1307,67 @@ void *DisjointPool::AllocImpl::allocate(size_t Size, bool &FromPool) try {
 }
 
 void *DisjointPool::AllocImpl::allocate(size_t Size, size_t Alignment,
-                                        bool &FromPool) try {
+                                        bool &FromPool, bool *Zeroed) try {
     void *Ptr;
+    bool SlabZeroed = false;
+
+    if (Zeroed) {
+        *Zeroed = false;
+    }
 
     if (Size == 0) {
         return nullptr;
     }
 
     if (Alignment <= 1) {
-        return allocate(Size, FromPool);
+        return allocate(Size, FromPool, Zeroed);
     }
 
-    size_t AlignedSize;
-    if (Alignment <= ProviderMinPageSize) {
-        // This allocation will be served from a Bucket which size is multiple
-        // of Alignment and Slab address is aligned to ProviderMinPageSize
-        // so the address will be properly aligned.
-        AlignedSize = (Size > 1) ? AlignUp(Size, Alignment) : Alignment;
-    } else {
-        // Slabs are only aligned to ProviderMinPageSize, we need to compensate
-        // for that in case the allocation is within pooling limit.
-        // TODO: consider creating properly-aligned Slabs on demand
-        AlignedSize = Size + Alignment - 1;
+    decayIfDue();
+
+    // This allocation will be served from a Bucket which size is multiple
+    // of Alignment and Slab address is aligned to at least Alignment
+    // so the address will be properly aligned. Slabs of the regular buckets
+    // are aligned to ProviderMinPageSize, bigger alignments are served from
+    // buckets creating slabs aligned to Alignment.
+    size_t AlignedSize = (Size > 1) ? AlignUp(Size, Alignment) : Alignment;
+    bool AlignedSlabs = Alignment > ProviderMinPageSize;
+    if (AlignedSlabs && AlignedSize > SlabMinSize() / 2) {
+        // The allocation takes a whole slab, so the size does not have
+        // to be a multiple of Alignment (e.g. a 1MB allocation aligned
+        // to 2MB takes a 1MB slab).
+        AlignedSize = std::max(Size, SlabMinSize() / 2 + 1);
     }
 
     // Check if requested allocation size is within pooling limit.
     // If not, just request aligned pointer from the system.
     FromPool = false;
-    if (AlignedSize > getParams().MaxPoolableSize) {
-        Ptr = memoryProviderAlloc(getMemHandle(), Size, Alignment);
+    if (AlignedSize > getParams().MaxPoolableSize || AlignedSize > CutOff) {
+        Ptr = memoryProviderAlloc(getMemHandle(), Size, Alignment, Zeroed);
         utils_annotate_memory_undefined(Ptr, Size);
         return Ptr;
     }
 
-    auto &Bucket = findBucket(AlignedSize);
+    auto &Bucket = AlignedSlabs ? findAlignedBucket(AlignedSize, Alignment)
+                                : findBucket(AlignedSize);
 
     if (AlignedSize > Bucket.ChunkCutOff()) {
-        Ptr = Bucket.getSlab(FromPool);
+        Ptr = Bucket.getSlab(FromPool, SlabZeroed);
+        Bucket.countAlloc(FromPool);
     } else {
-        Ptr = Bucket.getChunk(FromPool);
+        Ptr = getChunk(Bucket, FromPool);
     }
 
-    if (getParams().PoolTrace > 1) {
-        Bucket.countAlloc(FromPool);
-    }
+    assert(((uintptr_t)Ptr & (Alignment - 1)) == 0);
+
+    VALGRIND_DO_MEMPOOL_ALLOC(this, Ptr, Size);
+    utils_annotate_memory_undefined(Ptr, Size);
 
-    VALGRIND_DO_MEMPOOL_ALLOC(this, AlignPtrUp(Ptr, Alignment), Size);
-    utils_annotate_memory_undefined(AlignPtrUp(Ptr, Alignment), Size);
+    if (Zeroed) {
+        *Zeroed = SlabZeroed;
+    }
 
-    return AlignPtrUp(Ptr, Alignment);
+    return Ptr;
 } catch (MemoryProviderError &e) {
     umf::getPoolLastStatusRef<DisjointPool>() = e.code;
     return nullptr;
@@ -933,52 +1404,389 @@ Bucket &DisjointPool::AllocImpl::findBucket(size_t Size) {
     return *(Buckets[calculatedIdx]);
 }
 
-void DisjointPool::AllocImpl::deallocate(void *Ptr, bool &ToPool) {
-    auto *SlabPtr = AlignPtrDown(Ptr, SlabMinSize());
+Bucket &DisjointPool::AllocImpl::findAlignedBucket(size_t Size,
+                                                   size_t Alignment) {
+    auto AlignmentExp = (size_t)log2Utils(Alignment);
+    auto &AlignBuckets = AlignedBuckets[AlignmentExp];
 
-    // Lock the map on read
-    std::shared_lock<std::shared_timed_mutex> Lk(getKnownSlabsMapLock());
+    std::call_once(AlignedBucketsOnce[AlignmentExp], [&] {
+        createBuckets(AlignBuckets, Alignment);
+        AlignedBucketsCreated[AlignmentExp].store(true,
+                                                  std::memory_order_release);
+    });
 
-    ToPool = false;
-    auto Slabs = getKnownSlabs().equal_range(SlabPtr);
-    if (Slabs.first == Slabs.second) {
-        Lk.unlock();
-        memoryProviderFree(getMemHandle(), Ptr);
+    auto calculatedIdx = sizeToIdx(Size);
+    assert((*(AlignBuckets[calculatedIdx])).getSize() >= Size);
+    return *(AlignBuckets[calculatedIdx]);
+}
+
+void *DisjointPool::AllocImpl::getChunk(Bucket &Bucket, bool &FromPool) {
+    // aligned buckets are not cached
+    if (!getParams().ThreadCacheSize || Bucket.getAlignment()) {
+        void *Ptr = Bucket.getChunk(FromPool);
+        Bucket.countAlloc(FromPool);
+        return Ptr;
+    }
+
+    auto *Cache = TLSThreadCaches.get(this);
+    auto Idx = sizeToIdx(Bucket.getSize());
+    auto &Chunks = Cache->Chunks[Idx];
+
+    // Allocation from the cache is treated as from pool for statistics.
+    FromPool = true;
+    if (Chunks.empty()) {
+        // Refill half of the cache, so that the following frees
+        // do not have to flush it right away.
+        size_t Count = std::max(getParams().ThreadCacheSize / 2, (size_t)1);
+        Chunks.reserve(getParams().ThreadCacheSize);
+        Bucket.getChunks(Count, Chunks, FromPool);
+    }
+
+    addRelaxed(Cache->BucketCounts[Idx].Allocs, 1);
+    if (FromPool) {
+        addRelaxed(Cache->BucketCounts[Idx].PoolAllocs, 1);
+    }
+
+    void *Ptr = Chunks.back().first;
+    Chunks.pop_back();
+    return Ptr;
+}
+
+void DisjointPool::AllocImpl::freeChunk(Bucket &Bucket, void *Ptr, Slab &Slab,
+                                        bool &ToPool) {
+    size_t CacheSize = getParams().ThreadCacheSize;
+    if (!CacheSize || Bucket.getAlignment()) {
+        Bucket.countFree();
+        Bucket.freeChunk(Ptr, Slab, ToPool);
+        return;
+    }
+
+    auto *Cache = TLSThreadCaches.get(this);
+    auto Idx = sizeToIdx(Bucket.getSize());
+    auto &Chunks = Cache->Chunks[Idx];
+    addRelaxed(Cache->BucketCounts[Idx].Frees, 1);
+    if (Chunks.size() >= CacheSize) {
+        // Return the least recently freed half of the cache.
+        size_t Count = std::max(CacheSize / 2, (size_t)1);
+        Bucket.freeChunks(Chunks.data(), Count);
+        Chunks.erase(Chunks.begin(), Chunks.begin() + Count);
+    }
+
+    Chunks.reserve(CacheSize);
+    Chunks.emplace_back(Ptr, &Slab);
+    ToPool = true;
+}
+
+std::shared_ptr<ThreadCache> DisjointPool::AllocImpl::createThreadCache() {
+    auto Cache = std::make_shared<ThreadCache>(this, Buckets.size());
+
+    std::lock_guard<std::mutex> Lg(ThreadCachesLock);
+
+    // Forget the caches of the threads which already exited.
+    ThreadCachesList.erase(
+        std::remove_if(ThreadCachesList.begin(), ThreadCachesList.end(),
+                       [](auto &C) { return C->Pool.load() == nullptr; }),
+        ThreadCachesList.end());
+
+    ThreadCachesList.push_back(Cache);
+    return Cache;
+}
+
+void DisjointPool::AllocImpl::flushThreadCaches() {
+    std::lock_guard<std::mutex> Lg(ThreadCachesLock);
+
+    for (auto &Cache : ThreadCachesList) {
+        std::lock_guard<std::mutex> CacheLg(Cache->Lock);
+        if (Cache->Pool.load() == this) {
+            Cache->flush();
+        }
+    }
+
+    ThreadCachesList.clear();
+}
+
+void DisjointPool::AllocImpl::flushOwnThreadCache() {
+    if (!getParams().ThreadCacheSize) {
         return;
     }
 
-    for (auto It = Slabs.first; It != Slabs.second; ++It) {
-        // The slab object won't be deleted until it's removed from the map which is
-        // protected by the lock, so it's safe to access it here.
-        auto &Slab = It->second;
-        if (Ptr >= Slab.getPtr() && Ptr < Slab.getEnd()) {
-            // Unlock the map before freeing the chunk, it may be locked on write
-            // there
-            Lk.unlock();
-            auto &Bucket = Slab.getBucket();
+    // The caches of other threads cannot be flushed while they use them.
+    if (auto *Cache = TLSThreadCaches.find(this)) {
+        std::lock_guard<std::mutex> Lg(Cache->Lock);
+        if (Cache->Pool.load() == this) {
+            Cache->flush();
+        }
+    }
+}
 
-            if (getParams().PoolTrace > 1) {
-                Bucket.countFree();
+size_t DisjointPool::AllocImpl::trim(size_t Size) {
+    // The chunks cached by the calling thread keep their slabs in use.
+    flushOwnThreadCache();
+
+    // Start with the biggest slabs to release the requested size
+    // with the least number of slabs.
+    size_t Released = 0;
+    auto releaseBuckets = [&](auto &BucketsList) {
+        for (auto It = BucketsList.rbegin(); It != BucketsList.rend(); ++It) {
+            if (Size && Released >= Size) {
+                return;
             }
+            Released += (*It)->releasePooledSlabs(Size ? Size - Released : 0);
+        }
+    };
+
+    for (size_t Exp = AlignedBuckets.size(); Exp-- > 0;) {
+        if (AlignedBucketsCreated[Exp].load(std::memory_order_acquire)) {
+            releaseBuckets(AlignedBuckets[Exp]);
+        }
+    }
+    releaseBuckets(Buckets);
+
+    return Released;
+}
+
+void ThreadCache::flush() {
+    auto *CachePool = Pool.load();
+    assert(CachePool);
+
+    for (size_t Idx = 0; Idx < Chunks.size(); Idx++) {
+        auto &Bucket = CachePool->getBucket(Idx);
+        if (!Chunks[Idx].empty()) {
+            Bucket.freeChunks(Chunks[Idx].data(), Chunks[Idx].size());
+            Chunks[Idx].clear();
+        }
+
+        auto &Counts = BucketCounts[Idx];
+        Bucket.addCounts(Counts.Allocs.exchange(0),
+                         Counts.PoolAllocs.exchange(0),
+                         Counts.Frees.exchange(0));
+    }
+
+    Pool = nullptr;
+}
 
-            VALGRIND_DO_MEMPOOL_FREE(this, Ptr);
-            utils_annotate_memory_inaccessible(Ptr, Bucket.getSize());
+ThreadCache *ThreadCaches::find(DisjointPool::AllocImpl *Pool) {
+    for (auto &Cache : Caches) {
+        if (Cache->Pool.load(std::memory_order_relaxed) == Pool) {
+            return Cache.get();
+        }
+    }
+
+    return nullptr;
+}
+
+ThreadCache *ThreadCaches::get(DisjointPool::AllocImpl *Pool) {
+    if (auto *Cache = find(Pool)) {
+        return Cache;
+    }
+
+    // Forget the caches of the pools which were already destroyed.
+    Caches.erase(std::remove_if(Caches.begin(), Caches.end(),
+                                [](auto &C) { return C->Pool.load() == nullptr; }),
+                 Caches.end());
+
+    Caches.push_back(Pool->createThreadCache());
+    return Caches.back().get();
+}
 
-            if (Bucket.getSize() <= Bucket.ChunkCutOff()) {
-                Bucket.freeChunk(Ptr, Slab, ToPool);
-            } else {
-                Bucket.freeSlab(Slab, ToPool);
+ThreadCaches::~ThreadCaches() {
+    for (auto &Cache : Caches) {
+        try { // cannot throw in destructor
+            std::lock_guard<std::mutex> Lg(Cache->Lock);
+            if (Cache->Pool.load()) {
+                Cache->flush();
             }
+        } catch (MemoryProviderError &e) {
+            LOG_ERR("DisjointPool: error from memory provider: %d", e.code);
+        } catch (std::exception &e) {
+            LOG_ERR("DisjointPool: unexpected error: %s", e.what());
+        }
+    }
+}
 
+std::chrono::steady_clock::time_point DisjointPool::AllocImpl::now() const {
+    if (auto *ClockFn = Clock.load(std::memory_order_relaxed)) {
+        return std::chrono::steady_clock::time_point(
+            std::chrono::milliseconds(ClockFn()));
+    }
+
+    return std::chrono::steady_clock::now();
+}
+
+void DisjointPool::AllocImpl::decayIfDue() {
+    if (!getParams().DecayMs) {
+        return;
+    }
+
+    // The countdown is kept per pool, so that the traffic of one pool
+    // does not decide when another one decays.
+    if (getParams().ThreadCacheSize) {
+        auto *Cache = TLSThreadCaches.get(this);
+        if (--Cache->DecayCountdown) {
+            return;
+        }
+        Cache->DecayCountdown = DecayCheckInterval;
+    } else {
+        // the buckets are locked by every operation anyway
+        if (DecayCountdown.fetch_sub(1, std::memory_order_relaxed) != 1) {
             return;
         }
+        DecayCountdown.fetch_add(DecayCheckInterval, std::memory_order_relaxed);
+    }
+
+    // Decay twice per DecayMs, by a single thread at a time.
+    auto Now = now();
+    auto Next = NextDecay.load(std::memory_order_relaxed);
+    if (Now.time_since_epoch().count() < Next) {
+        return;
+    }
+
+    auto NewNext = Now + std::chrono::milliseconds(getParams().DecayMs) / 2;
+    if (!NextDecay.compare_exchange_strong(
+            Next, NewNext.time_since_epoch().count())) {
+        return;
+    }
+
+    decayBuckets();
+}
+
+void DisjointPool::AllocImpl::decayBuckets() {
+    auto Now = now();
+    for (auto &B : Buckets) {
+        B->decay(Now);
+    }
+
+    for (size_t Exp = 0; Exp < AlignedBuckets.size(); Exp++) {
+        if (AlignedBucketsCreated[Exp].load(std::memory_order_acquire)) {
+            for (auto &B : AlignedBuckets[Exp]) {
+                B->decay(Now);
+            }
+        }
+    }
+}
+
+Slab *DisjointPool::AllocImpl::findSlab(void *Ptr) {
+    // Find the slab with the highest start address not above Ptr.
+    // The slab cannot be destroyed concurrently, because Ptr is still
+    // allocated from it, so no lock is needed here. If Ptr comes from
+    // a system allocation, the range check (using the slab size stored
+    // in the map) fails before the slab is dereferenced.
+    uintptr_t SlabAddr = 0;
+    uintptr_t SlabSize = 0;
+    void *Value = nullptr;
+    if (!critnib_find_aux(getKnownSlabs(), (uintptr_t)Ptr, FIND_LE, &SlabAddr,
+                          &Value, &SlabSize) ||
+        (uintptr_t)Ptr >= SlabAddr + SlabSize) {
+        return nullptr;
     }
 
-    Lk.unlock();
-    // There is a rare case when we have a pointer from system allocation next
-    // to some slab with an entry in the map. So we find a slab
-    // but the range checks fail.
-    memoryProviderFree(getMemHandle(), Ptr);
+    return static_cast<Slab *>(Value);
+}
+
+size_t DisjointPool::AllocImpl::getUsableSize(void *Ptr, Slab &Slab) {
+    // Aligned allocations may point into the middle of a chunk
+    // (or of a whole-slab allocation, which is a single chunk).
+    size_t ChunkSize = Slab.getBucket().getSize();
+    size_t Offset =
+        (static_cast<char *>(Ptr) - static_cast<char *>(Slab.getPtr())) %
+        ChunkSize;
+    return ChunkSize - Offset;
+}
+
+size_t DisjointPool::AllocImpl::getUsableSize(void *Ptr) {
+    if (auto *Slab = findSlab(Ptr)) {
+        return getUsableSize(Ptr, *Slab);
+    }
+
+    umf_alloc_info_t allocInfo = {NULL, 0, NULL};
+    if (umfMemoryTrackerGetAllocInfo(Ptr, &allocInfo) != UMF_RESULT_SUCCESS) {
+        return 0;
+    }
+
+    return allocInfo.baseSize -
+           (static_cast<char *>(Ptr) - static_cast<char *>(allocInfo.base));
+}
+
+void *DisjointPool::AllocImpl::reallocate(void *Ptr, size_t Size) {
+    bool FromPool, ToPool;
+
+    if (Ptr == nullptr) {
+        return allocate(Size, FromPool);
+    }
+
+    if (Size == 0) {
+        deallocate(Ptr, ToPool);
+        return nullptr;
+    }
+
+    size_t UsableSize;
+    if (auto *Slab = findSlab(Ptr)) {
+        UsableSize = getUsableSize(Ptr, *Slab);
+
+        // Keep the chunk only if the new size maps to the same bucket,
+        // so that shrinking to a smaller bucket releases the bigger chunk.
+        if (Size <= UsableSize && Size <= getParams().MaxPoolableSize &&
+            &findBucket(Size) == &Slab->getBucket()) {
+            VALGRIND_DO_MEMPOOL_CHANGE(this, Ptr, Ptr, Size);
+            return Ptr;
+        }
+    } else {
+        UsableSize = getUsableSize(Ptr);
+        if (UsableSize == 0) {
+            // the size of the allocation is not known (tracking is disabled)
+            umf::getPoolLastStatusRef<DisjointPool>() =
+                UMF_RESULT_ERROR_NOT_SUPPORTED;
+            return nullptr;
+        }
+
+        // Keep the provider allocation unless it would be pooled now.
+        if (Size <= UsableSize && Size > getParams().MaxPoolableSize) {
+            return Ptr;
+        }
+    }
+
+    void *NewPtr = allocate(Size, FromPool);
+    if (NewPtr == nullptr) {
+        // the old allocation is left untouched
+        return nullptr;
+    }
+
+    memcpy(NewPtr, Ptr, std::min(Size, UsableSize));
+
+    try {
+        deallocate(Ptr, ToPool);
+    } catch (MemoryProviderError &e) {
+        LOG_ERR("DisjointPool: realloc failed to free the old allocation, "
+                "error from memory provider: %d",
+                e.code);
+    }
+
+    return NewPtr;
+}
+
+void DisjointPool::AllocImpl::deallocate(void *Ptr, bool &ToPool) {
+    ToPool = false;
+
+    decayIfDue();
+
+    auto *SlabPtr = findSlab(Ptr);
+    if (SlabPtr == nullptr) {
+        memoryProviderFree(getMemHandle(), Ptr);
+        return;
+    }
+
+    auto &Slab = *SlabPtr;
+    auto &Bucket = Slab.getBucket();
+
+    VALGRIND_DO_MEMPOOL_FREE(this, Ptr);
+    utils_annotate_memory_inaccessible(Ptr, Bucket.getSize());
+
+    if (Bucket.getSize() <= Bucket.ChunkCutOff()) {
+        freeChunk(Bucket, Ptr, Slab, ToPool);
+    } else {
+        Bucket.countFree();
+        Bucket.freeSlab(Slab, ToPool);
+    }
 }
 
 void DisjointPool::AllocImpl::printStats(bool &TitlePrinted,
@@ -987,11 +1795,59 @@ void DisjointPool::AllocImpl::printStats(bool &TitlePrinted,
                                          const std::string &MTName) {
     HighBucketSize = 0;
     HighPeakSlabsInUse = 0;
+
+    std::vector<umf_disjoint_pool_bucket_stats_t> Stats;
+    getStats(Stats);
+    for (auto &BucketStats : Stats) {
+        printBucketStats(BucketStats, TitlePrinted, MTName);
+        HighPeakSlabsInUse =
+            std::max(BucketStats.PeakSlabsInUse, HighPeakSlabsInUse);
+        if (BucketStats.AllocCount) {
+            HighBucketSize = std::max(
+                std::max(BucketStats.Size, SlabMinSize()), HighBucketSize);
+        }
+    }
+}
+
+void DisjointPool::AllocImpl::getStats(
+    std::vector<umf_disjoint_pool_bucket_stats_t> &Stats) {
     for (auto &B : Buckets) {
-        (*B).printStats(TitlePrinted, MTName);
-        HighPeakSlabsInUse = std::max((*B).maxSlabsInUse, HighPeakSlabsInUse);
-        if ((*B).allocCount) {
-            HighBucketSize = std::max((*B).SlabAllocSize(), HighBucketSize);
+        Stats.emplace_back();
+        B->getStats(Stats.back());
+    }
+
+    // Add the allocations and frees served by the thread caches
+    // which were not flushed yet.
+    {
+        std::lock_guard<std::mutex> Lg(ThreadCachesLock);
+        for (auto &Cache : ThreadCachesList) {
+            std::lock_guard<std::mutex> CacheLg(Cache->Lock);
+            if (Cache->Pool.load() != this) {
+                continue;
+            }
+
+            for (size_t Idx = 0; Idx < Buckets.size(); Idx++) {
+                auto &Counts = Cache->BucketCounts[Idx];
+                auto PoolAllocs =
+                    Counts.PoolAllocs.load(std::memory_order_relaxed);
+                auto Allocs = Counts.Allocs.load(std::memory_order_relaxed);
+                Stats[Idx].AllocCount += Allocs;
+                Stats[Idx].PoolHits += PoolAllocs;
+                Stats[Idx].PoolMisses += Allocs - PoolAllocs;
+                Stats[Idx].FreeCount +=
+                    Counts.Frees.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (size_t Exp = 0; Exp < AlignedBuckets.size(); Exp++) {
+        if (!AlignedBucketsCreated[Exp].load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        for (auto &B : AlignedBuckets[Exp]) {
+            Stats.emplace_back();
+            B->getStats(Stats.back());
         }
     }
 }
@@ -1026,16 +1882,48 @@ void *DisjointPool::malloc(size_t size) { // For full-slab allocations indicates
     return Ptr;
 }
 
-void *DisjointPool::calloc(size_t, size_t) {
-    // Not supported
-    umf::getPoolLastStatusRef<DisjointPool>() = UMF_RESULT_ERROR_NOT_SUPPORTED;
-    return NULL;
+// calloc() and realloc() access the memory, so they work only
+// with memory providers returning host-accessible memory.
+void *DisjointPool::calloc(size_t num, size_t size) {
+    if (size && num > (std::numeric_limits<size_t>::max)() / size) {
+        umf::getPoolLastStatusRef<DisjointPool>() =
+            UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    bool FromPool, Zeroed;
+    auto Ptr = impl->allocate(num * size, FromPool, &Zeroed);
+
+    if (impl->getParams().PoolTrace > 2) {
+        auto MT = impl->getParams().Name;
+        std::cout << "Allocated " << std::setw(8) << num * size << " " << MT
+                  << " bytes from " << (FromPool ? "Pool" : "Provider") << " ->"
+                  << Ptr << std::endl;
+    }
+
+    if (Ptr) {
+        if (Zeroed) {
+            // fresh memory of the provider, do not touch its pages
+            utils_annotate_memory_defined(Ptr, num * size);
+        } else {
+            memset(Ptr, 0, num * size);
+        }
+    }
+    return Ptr;
 }
 
-void *DisjointPool::realloc(void *, size_t) {
-    // Not supported
-    umf::getPoolLastStatusRef<DisjointPool>() = UMF_RESULT_ERROR_NOT_SUPPORTED;
-    return NULL;
+void *DisjointPool::realloc(void *ptr, size_t size) try {
+    auto NewPtr = impl->reallocate(ptr, size);
+
+    if (impl->getParams().PoolTrace > 2) {
+        auto MT = impl->getParams().Name;
+        std::cout << "Reallocated " << ptr << " to " << std::setw(8) << size
+                  << " " << MT << " bytes ->" << NewPtr << std::endl;
+    }
+    return NewPtr;
+} catch (MemoryProviderError &e) {
+    umf::getPoolLastStatusRef<DisjointPool>() = e.code;
+    return nullptr;
 }
 
 void *DisjointPool::aligned_malloc(size_t size, size_t alignment) {
@@ -1052,9 +1940,12 @@ void *DisjointPool::aligned_malloc(size_t size, size_t alignment) {
     return Ptr;
 }
 
-size_t DisjointPool::malloc_usable_size(void *) {
-    // Not supported
-    return 0;
+size_t DisjointPool::malloc_usable_size(void *ptr) {
+    if (ptr == nullptr) {
+        return 0;
+    }
+
+    return impl->getUsableSize(ptr);
 }
 
 umf_result_t DisjointPool::free(void *ptr) try {
@@ -1079,6 +1970,18 @@ umf_result_t DisjointPool::get_last_allocation_error() {
     return umf::getPoolLastStatusRef<DisjointPool>();
 }
 
+umf_result_t DisjointPool::trim(size_t size, size_t *released) {
+    *released = impl->trim(size);
+    return UMF_RESULT_SUCCESS;
+}
+
+void DisjointPool::getStats(
+    std::vector<umf_disjoint_pool_bucket_stats_t> &Stats) {
+    impl->getStats(Stats);
+}
+
+void DisjointPool::setClock(uint64_t (*Clock)(void)) { impl->setClock(Clock); }
+
 DisjointPool::DisjointPool() {}
 
 // Define destructor for use with unique_ptr
@@ -1110,3 +2013,37 @@ static umf_memory_pool_ops_t UMF_DISJOINT_POOL_OPS =
 umf_memory_pool_ops_t *umfDisjointPoolOps(void) {
     return &UMF_DISJOINT_POOL_OPS;
 }
+
+umf_result_t umfDisjointPoolSetClock(umf_memory_pool_handle_t hPool,
+                                     uint64_t (*Clock)(void)) {
+    if (!hPool || hPool->ops.initialize != UMF_DISJOINT_POOL_OPS.initialize) {
+        LOG_ERR("umfDisjointPoolSetClock: not a disjoint pool");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    static_cast<DisjointPool *>(hPool->pool_priv)->setClock(Clock);
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfDisjointPoolGetStats(umf_memory_pool_handle_t hPool,
+                                     umf_disjoint_pool_bucket_stats_t *Stats,
+                                     size_t *NumBuckets) try {
+    if (!hPool || !NumBuckets || (!Stats && *NumBuckets)) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (hPool->ops.initialize != UMF_DISJOINT_POOL_OPS.initialize) {
+        LOG_ERR("umfDisjointPoolGetStats: not a disjoint pool");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::vector<umf_disjoint_pool_bucket_stats_t> AllStats;
+    static_cast<DisjointPool *>(hPool->pool_priv)->getStats(AllStats);
+
+    std::copy_n(AllStats.begin(), std::min(*NumBuckets, AllStats.size()),
+                Stats);
+    *NumBuckets = AllStats.size();
+    return UMF_RESULT_SUCCESS;
+} catch (std::bad_alloc &) {
+    return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+*/
+
+#ifndef UMF_DISJOINT_POOL_INTERNAL_H
+#define UMF_DISJOINT_POOL_INTERNAL_H 1
+
+#include <stdint.h>
+
+#include <umf/memory_pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Replaces the clock used by the decay of the pooled slabs
+///        of a disjoint pool (for testing).
+/// @param hPool handle to the disjoint pool
+/// @param Clock returns the current time in milliseconds,
+///        NULL restores the steady clock
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfDisjointPoolSetClock(umf_memory_pool_handle_t hPool,
+                                     uint64_t (*Clock)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UMF_DISJOINT_POOL_INTERNAL_H */
@@ -6,11 +6,13 @@
 */
 
 #include <assert.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "base_alloc_global.h"
+#include "pool_jemalloc_internal.h"
 #include "utils_common.h"
 #include "utils_concurrency.h"
 #include "utils_log.h"
@@ -34,13 +36,70 @@
 
 #define MALLOCX_ARENA_MAX (MALLCTL_ARENAS_ALL - 1)
 
+// jemalloc supports up to 4093 explicit tcaches
+#define TCACHES_MAX 4096
+
+// Maximum number of pools a thread can use with a tcache at the same time
+#define TCACHES_PER_THREAD 16
+
+// Maximum number of arenas of a pool when the number is not given explicitly
+#define AUTO_ARENAS_MAX 64
+
 typedef struct jemalloc_memory_pool_t {
     umf_memory_provider_handle_t provider;
-    unsigned int arena_index; // index of jemalloc arena
+    unsigned n_arenas;
+    unsigned *arenas; // indexes of the jemalloc arenas of the pool
+    umf_jemalloc_pool_arena_selection_t arena_selection;
+    int retain; // keep the freed extents instead of freeing them
+    // unique id of the pool (the address of a destroyed pool can be reused)
+    uint64_t id;
+    // bytes returned to the provider or force-purged by the extent hooks
+    size_t released_bytes;
 } jemalloc_memory_pool_t;
 
+// The automatic tcache of jemalloc is shared by all arenas, so it would mix
+// objects of different pools. Instead, each thread creates an explicit tcache
+// for each pool it uses, so the objects of a tcache come from a single arena.
+typedef struct jemalloc_tcache_t {
+    jemalloc_memory_pool_t *pool;
+    uint64_t pool_id; // 0 if the slot is unused
+    unsigned tcache_id;
+} jemalloc_tcache_t;
+
+typedef struct jemalloc_thread_tcaches_t {
+    jemalloc_tcache_t tcaches[TCACHES_PER_THREAD];
+    // tcaches_thread_exit() is being registered for this thread
+    // (registering it may allocate memory and so re-enter create_tcache())
+    int registering_exit;
+} jemalloc_thread_tcaches_t;
+
 static __TLS umf_result_t TLS_last_allocation_error;
 
+static __TLS jemalloc_thread_tcaches_t TLS_tcaches;
+
+// Index of the thread used for selecting arenas, 0 if not assigned yet
+static __TLS uint64_t TLS_thread_index;
+static uint64_t Last_thread_index;
+
+static UTIL_ONCE_FLAG Tcaches_initialized = UTIL_ONCE_FLAG_INIT;
+
+// Protects Tcache_owner, Last_pool_id, Live_pools and the thread exit key
+static os_mutex_t Tcaches_lock;
+
+// Id of the pool owning each explicit tcache, 0 if the tcache is not used
+static uint64_t Tcache_owner[TCACHES_MAX];
+static uint64_t Last_pool_id;
+
+// Number of existing pools, the thread exit key exists only while it is not 0
+static size_t Live_pools;
+
+#ifdef _WIN32
+static DWORD Thread_exit_index = FLS_OUT_OF_INDEXES;
+#else
+static pthread_key_t Thread_exit_key;
+static int Thread_exit_key_ret = -1;
+#endif
+
 static jemalloc_memory_pool_t *pool_by_arena_index[MALLCTL_ARENAS_ALL];
 
 static jemalloc_memory_pool_t *get_pool_by_arena_index(unsigned arena_ind) {
@@ -74,7 +133,9 @@ static void *arena_extent_alloc(extent_hooks_t *extent_hooks, void *new_addr,
     jemalloc_memory_pool_t *pool = get_pool_by_arena_index(arena_ind);
 
     void *ptr = new_addr;
-    ret = umfMemoryProviderAlloc(pool->provider, size, alignment, &ptr);
+    int zeroed = 0;
+    ret = umfMemoryProviderAllocWithZeroInfo(pool->provider, size, alignment,
+                                             &ptr, &zeroed);
     if (ret != UMF_RESULT_SUCCESS) {
         return NULL;
     }
@@ -92,7 +153,14 @@ static void *arena_extent_alloc(extent_hooks_t *extent_hooks, void *new_addr,
 
     if (*zero) {
         utils_annotate_memory_defined(ptr, size);
-        memset(ptr, 0, size); // TODO: device memory is not accessible by host
+        if (!zeroed) {
+            // TODO: device memory is not accessible by host
+            memset(ptr, 0, size);
+        }
+    } else {
+        // jemalloc does not zero (and touch) the extent again if it knows
+        // the extent is already zero-filled
+        *zero = zeroed;
     }
 
     *commit = true;
@@ -136,13 +204,20 @@ static bool arena_extent_dalloc(extent_hooks_t *extent_hooks, void *addr,
 
     jemalloc_memory_pool_t *pool = get_pool_by_arena_index(arena_ind);
 
+    if (pool->retain) {
+        // jemalloc purges the extent and keeps it for later reuse
+        return true;
+    }
+
     umf_result_t ret;
     ret = umfMemoryProviderFree(pool->provider, addr, size);
     if (ret != UMF_RESULT_SUCCESS) {
         LOG_ERR("umfMemoryProviderFree failed in dalloc");
+        return true; // true means failure
     }
 
-    return ret != UMF_RESULT_SUCCESS;
+    util_fetch_and_add64(&pool->released_bytes, size);
+    return false; // false means success
 }
 
 // arena_extent_commit - an extent commit function conforms to the extent_commit_t type and commits
@@ -156,14 +231,24 @@ static bool arena_extent_commit(extent_hooks_t *extent_hooks, void *addr,
                                 size_t size, size_t offset, size_t length,
                                 unsigned arena_ind) {
     (void)extent_hooks; // unused
-    (void)addr;         // unused
     (void)size;         // unused
-    (void)offset;       // unused
-    (void)length;       // unused
-    (void)arena_ind;    // unused
 
-    // TODO: add this function to the provider API to support Windows and USM
-    return false; // false means success (commit is a nop)
+    jemalloc_memory_pool_t *pool = get_pool_by_arena_index(arena_ind);
+
+    umf_result_t ret;
+    ret = umfMemoryProviderCommit(pool->provider, (char *)addr + offset,
+                                  length);
+    if (ret == UMF_RESULT_ERROR_NOT_SUPPORTED) {
+        // the provider cannot decommit memory, so it is always committed
+        return false;
+    }
+
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("umfMemoryProviderCommit failed");
+        return true; // true means failure
+    }
+
+    return false; // false means success
 }
 
 // arena_extent_decommit - an extent decommit function conforms to the extent_decommit_t type
@@ -177,14 +262,21 @@ static bool arena_extent_decommit(extent_hooks_t *extent_hooks, void *addr,
                                   size_t size, size_t offset, size_t length,
                                   unsigned arena_ind) {
     (void)extent_hooks; // unused
-    (void)addr;         // unused
     (void)size;         // unused
-    (void)offset;       // unused
-    (void)length;       // unused
-    (void)arena_ind;    // unused
 
-    // TODO: add this function to the provider API to support Windows and USM
-    return true; // true means failure (unsupported)
+    jemalloc_memory_pool_t *pool = get_pool_by_arena_index(arena_ind);
+
+    umf_result_t ret;
+    ret = umfMemoryProviderDecommit(pool->provider, (char *)addr + offset,
+                                    length);
+    if (ret != UMF_RESULT_SUCCESS) {
+        // opt-out (e.g. not supported by the provider), jemalloc purges
+        // the pages instead
+        return true; // true means failure
+    }
+
+    util_fetch_and_add64(&pool->released_bytes, length);
+    return false; // false means success
 }
 
 // arena_extent_purge_lazy - an extent purge function conforms to the extent_purge_t type and discards
@@ -222,8 +314,12 @@ static bool arena_extent_purge_forced(extent_hooks_t *extent_hooks, void *addr,
 
     umf_result_t ret = umfMemoryProviderPurgeForce(
         pool->provider, (char *)addr + offset, length);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return true; // true means failure
+    }
 
-    return (ret != UMF_RESULT_SUCCESS); // false means success
+    util_fetch_and_add64(&pool->released_bytes, length);
+    return false; // false means success
 }
 
 // arena_extent_split - an extent split function conforms to the extent_split_t type and optionally
@@ -289,12 +385,245 @@ static extent_hooks_t arena_extent_hooks = {
     .merge = arena_extent_merge,
 };
 
-static void *op_malloc(void *pool, size_t size) {
+// Should be called under Tcaches_lock
+static void tcache_destroy(unsigned tcache_id) {
+    // the cached objects are flushed to the arena
+    if (je_mallctl("tcache.destroy", NULL, NULL, (void *)&tcache_id,
+                   sizeof(unsigned))) {
+        LOG_ERR("Could not destroy tcache %u.", tcache_id);
+    }
+    Tcache_owner[tcache_id] = 0;
+}
+
+static void tcaches_thread_exit(void) {
+    jemalloc_thread_tcaches_t *cache = &TLS_tcaches;
+
+    util_mutex_lock(&Tcaches_lock);
+    for (int i = 0; i < TCACHES_PER_THREAD; i++) {
+        jemalloc_tcache_t *tc = &cache->tcaches[i];
+        // the tcaches of destroyed pools were destroyed together with the pool
+        if (tc->pool_id && Tcache_owner[tc->tcache_id] == tc->pool_id) {
+            tcache_destroy(tc->tcache_id);
+        }
+        tc->pool_id = 0;
+    }
+    util_mutex_unlock(&Tcaches_lock);
+}
+
+#ifdef _WIN32
+static VOID WINAPI tcaches_os_thread_exit(PVOID arg) {
+    if (arg) {
+        tcaches_thread_exit();
+    }
+}
+#else
+static void tcaches_os_thread_exit(void *arg) {
+    (void)arg; // unused
+    tcaches_thread_exit();
+}
+#endif
+
+static void tcaches_init(void) { util_mutex_init(&Tcaches_lock); }
+
+// Called by each created pool under Tcaches_lock,
+// the first one creates the thread exit key.
+static void tcaches_pool_created(void) {
+    if (Live_pools++) {
+        return;
+    }
+
+#ifdef _WIN32
+    Thread_exit_index = FlsAlloc(tcaches_os_thread_exit);
+#else
+    Thread_exit_key_ret =
+        pthread_key_create(&Thread_exit_key, tcaches_os_thread_exit);
+#endif
+}
+
+// Called by each destroyed pool, the last one deletes the thread exit key,
+// so that it is not leaked when the library is unloaded. The tcaches
+// of all threads were destroyed together with the pools already.
+static void tcaches_pool_destroyed(void) {
+    util_mutex_lock(&Tcaches_lock);
+    if (--Live_pools) {
+        util_mutex_unlock(&Tcaches_lock);
+        return;
+    }
+
+#ifdef _WIN32
+    DWORD index = Thread_exit_index;
+    Thread_exit_index = FLS_OUT_OF_INDEXES;
+#else
+    pthread_key_t key = Thread_exit_key;
+    int key_ret = Thread_exit_key_ret;
+    Thread_exit_key_ret = -1;
+#endif
+    util_mutex_unlock(&Tcaches_lock);
+
+    // FlsFree() calls the callback in the calling thread,
+    // which takes Tcaches_lock, so the key is deleted without it.
+#ifdef _WIN32
+    if (index != FLS_OUT_OF_INDEXES) {
+        FlsFree(index);
+    }
+#else
+    if (key_ret == 0) {
+        pthread_key_delete(key);
+    }
+#endif
+}
+
+// Registers tcaches_thread_exit() for the calling thread. The key cannot be
+// deleted meanwhile, because the caller uses an existing pool. It must not
+// be called under Tcaches_lock: pthread_setspecific() allocates memory
+// for keys beyond the first few ones, which with the proxy library comes
+// from a pool and re-enters create_tcache().
+static int tcaches_notify_on_thread_exit(jemalloc_thread_tcaches_t *cache) {
+#ifdef _WIN32
+    if (Thread_exit_index == FLS_OUT_OF_INDEXES) {
+        return -1;
+    }
+
+    if (FlsGetValue(Thread_exit_index) || cache->registering_exit) {
+        return 0;
+    }
+
+    // the callback is called only for non-NULL values
+    cache->registering_exit = 1;
+    int ret = FlsSetValue(Thread_exit_index, (PVOID)1) ? 0 : -1;
+    cache->registering_exit = 0;
+#else
+    if (Thread_exit_key_ret) {
+        return Thread_exit_key_ret;
+    }
+
+    if (pthread_getspecific(Thread_exit_key) || cache->registering_exit) {
+        return 0;
+    }
+
+    // the destructor is called only for non-NULL values
+    cache->registering_exit = 1;
+    int ret = pthread_setspecific(Thread_exit_key, (void *)1);
+    cache->registering_exit = 0;
+#endif
+
+    return ret;
+}
+
+// Returns the tcache of the calling thread for the given pool
+// or NULL if the thread has not created it yet.
+static jemalloc_tcache_t *find_tcache(jemalloc_memory_pool_t *pool) {
+    jemalloc_thread_tcaches_t *cache = &TLS_tcaches;
+
+    for (int i = 0; i < TCACHES_PER_THREAD; i++) {
+        jemalloc_tcache_t *tc = &cache->tcaches[i];
+        if (tc->pool == pool && tc->pool_id == pool->id) {
+            return tc;
+        }
+    }
+
+    return NULL;
+}
+
+// Creates a tcache of the calling thread for the given pool
+// and returns the flags selecting it (MALLOCX_TCACHE_NONE on failure).
+static int create_tcache(jemalloc_memory_pool_t *pool) {
+    jemalloc_thread_tcaches_t *cache = &TLS_tcaches;
+    jemalloc_tcache_t *unused = NULL;
+    int flags = MALLOCX_TCACHE_NONE;
+
+    if (tcaches_notify_on_thread_exit(cache)) {
+        // the tcache would be leaked on thread exit
+        return flags;
+    }
+
+    util_mutex_lock(&Tcaches_lock);
+
+    // the registration above may have re-entered and created the tcache
+    jemalloc_tcache_t *created = find_tcache(pool);
+    if (created) {
+        flags = MALLOCX_TCACHE(created->tcache_id);
+        goto err_unlock;
+    }
+
+    // Forget the tcaches of destroyed pools, they were already destroyed.
+    for (int i = 0; i < TCACHES_PER_THREAD; i++) {
+        jemalloc_tcache_t *tc = &cache->tcaches[i];
+        if (tc->pool_id && Tcache_owner[tc->tcache_id] != tc->pool_id) {
+            tc->pool_id = 0;
+        }
+        if (!unused && tc->pool_id == 0) {
+            unused = tc;
+        }
+    }
+
+    if (!unused) {
+        // the thread uses too many pools at once
+        goto err_unlock;
+    }
+
+    unsigned tcache_id;
+    size_t unsigned_size = sizeof(unsigned);
+    if (je_mallctl("tcache.create", (void *)&tcache_id, &unsigned_size, NULL,
+                   0)) {
+        // all explicit tcaches are in use
+        goto err_unlock;
+    }
+
+    if (tcache_id >= TCACHES_MAX) {
+        je_mallctl("tcache.destroy", NULL, NULL, (void *)&tcache_id,
+                   sizeof(unsigned));
+        goto err_unlock;
+    }
+
+    Tcache_owner[tcache_id] = pool->id;
+    unused->pool = pool;
+    unused->pool_id = pool->id;
+    unused->tcache_id = tcache_id;
+    flags = MALLOCX_TCACHE(tcache_id);
+
+err_unlock:
+    util_mutex_unlock(&Tcaches_lock);
+    return flags;
+}
+
+// Returns the flags selecting the tcache of the calling thread for the pool
+static int get_tcache_flags(jemalloc_memory_pool_t *pool) {
+    jemalloc_tcache_t *tc = find_tcache(pool);
+    if (tc) {
+        return MALLOCX_TCACHE(tc->tcache_id);
+    }
+
+    return create_tcache(pool);
+}
+
+// Returns the index of the arena of the pool to be used by the calling thread
+static unsigned get_arena_index(jemalloc_memory_pool_t *pool) {
+    if (pool->n_arenas == 1) {
+        return pool->arenas[0];
+    }
+
+    uint64_t i;
+    if (pool->arena_selection == UMF_JEMALLOC_POOL_ARENA_SELECTION_CPU) {
+        i = utils_get_current_cpu();
+    } else {
+        if (TLS_thread_index == 0) {
+            TLS_thread_index = util_fetch_and_add64(&Last_thread_index, 1) + 1;
+        }
+        i = TLS_thread_index - 1;
+    }
+
+    return pool->arenas[i % pool->n_arenas];
+}
+
+static int get_arena_flags(jemalloc_memory_pool_t *pool) {
+    return MALLOCX_ARENA(get_arena_index(pool)) | get_tcache_flags(pool);
+}
+
+static void *pool_mallocx(void *pool, size_t size, int flags) {
     assert(pool);
     jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
-    // MALLOCX_TCACHE_NONE is set, because jemalloc can mix objects from different arenas inside
-    // the tcache, so we wouldn't be able to guarantee isolation of different providers.
-    int flags = MALLOCX_ARENA(je_pool->arena_index) | MALLOCX_TCACHE_NONE;
+    flags |= get_arena_flags(je_pool);
     void *ptr = je_mallocx(size, flags);
     if (ptr == NULL) {
         TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
@@ -306,13 +635,16 @@ static void *op_malloc(void *pool, size_t size) {
     return ptr;
 }
 
+static void *op_malloc(void *pool, size_t size) {
+    return pool_mallocx(pool, size, 0);
+}
+
 static umf_result_t op_free(void *pool, void *ptr) {
-    (void)pool; // unused
     assert(pool);
 
     if (ptr != NULL) {
         VALGRIND_DO_MEMPOOL_FREE(pool, ptr);
-        je_dallocx(ptr, MALLOCX_TCACHE_NONE);
+        je_dallocx(ptr, get_tcache_flags((jemalloc_memory_pool_t *)pool));
     }
 
     return UMF_RESULT_SUCCESS;
@@ -321,22 +653,25 @@ static umf_result_t op_free(void *pool, void *ptr) {
 static void *op_calloc(void *pool, size_t num, size_t size) {
     assert(pool);
     size_t csize = num * size;
-    void *ptr = op_malloc(pool, csize);
+
+    // jemalloc zeroes only the memory that is not known to be zero-filled
+    // (e.g. it does not touch fresh extents reported as zeroed)
+    void *ptr = pool_mallocx(pool, csize, MALLOCX_ZERO);
     if (ptr == NULL) {
-        // TLS_last_allocation_error is set by op_malloc()
+        // TLS_last_allocation_error is set by pool_mallocx()
         return NULL;
     }
 
-    utils_annotate_memory_defined(ptr, num * size);
+    utils_annotate_memory_defined(ptr, csize);
 
-    memset(ptr, 0, csize); // TODO: device memory is not accessible by host
     return ptr;
 }
 
 static void *op_realloc(void *pool, void *ptr, size_t size) {
     assert(pool);
+    jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
     if (size == 0 && ptr != NULL) {
-        je_dallocx(ptr, MALLOCX_TCACHE_NONE);
+        je_dallocx(ptr, get_tcache_flags(je_pool));
         TLS_last_allocation_error = UMF_RESULT_SUCCESS;
         VALGRIND_DO_MEMPOOL_FREE(pool, ptr);
         return NULL;
@@ -344,10 +679,7 @@ static void *op_realloc(void *pool, void *ptr, size_t size) {
         return op_malloc(pool, size);
     }
 
-    jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
-    // MALLOCX_TCACHE_NONE is set, because jemalloc can mix objects from different arenas inside
-    // the tcache, so we wouldn't be able to guarantee isolation of different providers.
-    int flags = MALLOCX_ARENA(je_pool->arena_index) | MALLOCX_TCACHE_NONE;
+    int flags = get_arena_flags(je_pool);
     void *new_ptr = je_rallocx(ptr, size, flags);
     if (new_ptr == NULL) {
         TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
@@ -368,11 +700,7 @@ static void *op_realloc(void *pool, void *ptr, size_t size) {
 static void *op_aligned_alloc(void *pool, size_t size, size_t alignment) {
     assert(pool);
     jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
-    unsigned arena = je_pool->arena_index;
-    // MALLOCX_TCACHE_NONE is set, because jemalloc can mix objects from different arenas inside
-    // the tcache, so we wouldn't be able to guarantee isolation of different providers.
-    int flags =
-        MALLOCX_ALIGN(alignment) | MALLOCX_ARENA(arena) | MALLOCX_TCACHE_NONE;
+    int flags = MALLOCX_ALIGN(alignment) | get_arena_flags(je_pool);
     void *ptr = je_mallocx(size, flags);
     if (ptr == NULL) {
         TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
@@ -384,45 +712,163 @@ static void *op_aligned_alloc(void *pool, size_t size, size_t alignment) {
     return ptr;
 }
 
-static umf_result_t op_initialize(umf_memory_provider_handle_t provider,
-                                  void *params, void **out_pool) {
-    assert(provider);
-    assert(out_pool);
-    (void)params; // unused
+static void destroy_arena(unsigned arena_index) {
+    char cmd[64];
+    snprintf(cmd, sizeof(cmd), "arena.%u.destroy", arena_index);
+    je_mallctl(cmd, NULL, 0, NULL, 0);
+    pool_by_arena_index[arena_index] = NULL;
+}
 
-    extent_hooks_t *pHooks = &arena_extent_hooks;
-    size_t unsigned_size = sizeof(unsigned);
-    int err;
+static int set_arena_option(unsigned arena_index, const char *name,
+                            void *value, size_t value_size) {
+    char cmd[64];
+    snprintf(cmd, sizeof(cmd), "arena.%u.%s", arena_index, name);
+    int err = je_mallctl(cmd, NULL, NULL, value, value_size);
+    if (err && err != ENOENT) {
+        LOG_ERR("Could not set %s of arena %u.", name, arena_index);
+    }
 
-    jemalloc_memory_pool_t *pool =
-        umf_ba_global_alloc(sizeof(jemalloc_memory_pool_t));
-    if (!pool) {
-        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    return err;
+}
+
+static int set_arena_decay(unsigned arena_index, const char *name,
+                           int64_t decay_ms) {
+    if (decay_ms == UMF_JEMALLOC_POOL_DECAY_DEFAULT) {
+        return 0;
     }
 
-    pool->provider = provider;
+    // jemalloc uses ssize_t, which is not defined on Windows
+    intptr_t value = (intptr_t)decay_ms;
+    return set_arena_option(arena_index, name, &value, sizeof(value));
+}
+
+static int configure_arena(unsigned arena_index,
+                           umf_jemalloc_pool_params_t *params) {
+    int err = set_arena_decay(arena_index, "dirty_decay_ms",
+                              params->dirty_decay_ms);
+    if (err) {
+        return err;
+    }
 
-    unsigned arena_index;
-    err = je_mallctl("arenas.create", (void *)&arena_index, &unsigned_size,
-                     NULL, 0);
+    err = set_arena_decay(arena_index, "muzzy_decay_ms",
+                          params->muzzy_decay_ms);
+    if (err) {
+        return err;
+    }
+
+    if (params->retain_grow_limit) {
+        size_t limit = params->retain_grow_limit;
+        err = set_arena_option(arena_index, "retain_grow_limit", &limit,
+                               sizeof(limit));
+        if (err == ENOENT) {
+            // the limit does not exist if jemalloc is configured without
+            // opt.retain (e.g. by default on Windows)
+            LOG_INFO("retain_grow_limit of arena %u is ignored without "
+                     "opt.retain",
+                     arena_index);
+            err = 0;
+        }
+    }
+
+    return err;
+}
+
+static int create_arena(jemalloc_memory_pool_t *pool,
+                        umf_jemalloc_pool_params_t *params,
+                        unsigned *arena_index) {
+    extent_hooks_t *pHooks = &arena_extent_hooks;
+    size_t unsigned_size = sizeof(unsigned);
+
+    int err = je_mallctl("arenas.create", (void *)arena_index, &unsigned_size,
+                         NULL, 0);
     if (err) {
         LOG_ERR("Could not create arena.");
-        goto err_free_pool;
+        return err;
     }
 
+    pool_by_arena_index[*arena_index] = pool;
+
     // setup extent_hooks for newly created arena
     char cmd[64];
-    snprintf(cmd, sizeof(cmd), "arena.%u.extent_hooks", arena_index);
+    snprintf(cmd, sizeof(cmd), "arena.%u.extent_hooks", *arena_index);
     err = je_mallctl(cmd, NULL, NULL, (void *)&pHooks, sizeof(void *));
     if (err) {
-        snprintf(cmd, sizeof(cmd), "arena.%u.destroy", arena_index);
-        je_mallctl(cmd, NULL, 0, NULL, 0);
+        destroy_arena(*arena_index);
         LOG_ERR("Could not setup extent_hooks for newly created arena.");
-        goto err_free_pool;
+        return err;
+    }
+
+    err = configure_arena(*arena_index, params);
+    if (err) {
+        destroy_arena(*arena_index);
+        return err;
     }
 
-    pool->arena_index = arena_index;
-    pool_by_arena_index[arena_index] = pool;
+    return 0;
+}
+
+static int is_valid_decay(int64_t decay_ms) {
+    return decay_ms >= -1 || decay_ms == UMF_JEMALLOC_POOL_DECAY_DEFAULT;
+}
+
+static umf_result_t op_initialize(umf_memory_provider_handle_t provider,
+                                  void *params, void **out_pool) {
+    assert(provider);
+    assert(out_pool);
+
+    umf_jemalloc_pool_params_t default_params = umfJemallocPoolParamsDefault();
+    umf_jemalloc_pool_params_t *je_params =
+        params ? (umf_jemalloc_pool_params_t *)params : &default_params;
+
+    unsigned n_arenas = je_params->n_arenas;
+    if (n_arenas == 0) {
+        n_arenas = utils_get_num_cpus();
+        if (n_arenas > AUTO_ARENAS_MAX) {
+            n_arenas = AUTO_ARENAS_MAX;
+        }
+    }
+
+    umf_jemalloc_pool_arena_selection_t selection = je_params->arena_selection;
+    if (n_arenas > MALLOCX_ARENA_MAX ||
+        (selection != UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD &&
+         selection != UMF_JEMALLOC_POOL_ARENA_SELECTION_CPU) ||
+        !is_valid_decay(je_params->dirty_decay_ms) ||
+        !is_valid_decay(je_params->muzzy_decay_ms)) {
+        LOG_ERR("Invalid jemalloc pool params.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    util_init_once(&Tcaches_initialized, tcaches_init);
+
+    jemalloc_memory_pool_t *pool =
+        umf_ba_global_alloc(sizeof(jemalloc_memory_pool_t));
+    if (!pool) {
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    pool->arenas = umf_ba_global_alloc(n_arenas * sizeof(unsigned));
+    if (!pool->arenas) {
+        umf_ba_global_free(pool);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    pool->provider = provider;
+    pool->n_arenas = 0;
+    pool->arena_selection = selection;
+    pool->retain = je_params->retain;
+    pool->released_bytes = 0;
+
+    util_mutex_lock(&Tcaches_lock);
+    pool->id = ++Last_pool_id;
+    tcaches_pool_created();
+    util_mutex_unlock(&Tcaches_lock);
+
+    for (unsigned i = 0; i < n_arenas; i++) {
+        if (create_arena(pool, je_params, &pool->arenas[i])) {
+            goto err_destroy_arenas;
+        }
+        pool->n_arenas++;
+    }
 
     *out_pool = (umf_memory_pool_handle_t)pool;
 
@@ -430,7 +876,12 @@ static umf_result_t op_initialize(umf_memory_provider_handle_t provider,
 
     return UMF_RESULT_SUCCESS;
 
-err_free_pool:
+err_destroy_arenas:
+    for (unsigned i = 0; i < pool->n_arenas; i++) {
+        destroy_arena(pool->arenas[i]);
+    }
+    tcaches_pool_destroyed();
+    umf_ba_global_free(pool->arenas);
     umf_ba_global_free(pool);
     return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
 }
@@ -438,10 +889,23 @@ err_free_pool:
 static void op_finalize(void *pool) {
     assert(pool);
     jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
-    char cmd[64];
-    snprintf(cmd, sizeof(cmd), "arena.%u.destroy", je_pool->arena_index);
-    je_mallctl(cmd, NULL, 0, NULL, 0);
-    pool_by_arena_index[je_pool->arena_index] = NULL;
+
+    // The pool is not used anymore, so the tcaches of all threads
+    // can be destroyed here, before the arenas they cache objects of.
+    util_mutex_lock(&Tcaches_lock);
+    for (unsigned i = 0; i < TCACHES_MAX; i++) {
+        if (Tcache_owner[i] == je_pool->id) {
+            tcache_destroy(i);
+        }
+    }
+    util_mutex_unlock(&Tcaches_lock);
+
+    tcaches_pool_destroyed();
+
+    for (unsigned i = 0; i < je_pool->n_arenas; i++) {
+        destroy_arena(je_pool->arenas[i]);
+    }
+    umf_ba_global_free(je_pool->arenas);
     umf_ba_global_free(je_pool);
 
     VALGRIND_DO_DESTROY_MEMPOOL(pool);
@@ -457,6 +921,49 @@ static umf_result_t op_get_last_allocation_error(void *pool) {
     return TLS_last_allocation_error;
 }
 
+static umf_result_t op_trim(void *pool, size_t size, size_t *released) {
+    assert(pool);
+
+    jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
+
+    // The objects cached by the calling thread are returned to the arena.
+    // The tcaches of other threads cannot be flushed while they use them.
+    jemalloc_tcache_t *tc = find_tcache(je_pool);
+    if (tc) {
+        je_mallctl("tcache.flush", NULL, NULL, (void *)&tc->tcache_id,
+                   sizeof(unsigned));
+    }
+
+    size_t released_before;
+    util_atomic_load_acquire(&je_pool->released_bytes, &released_before);
+
+    // arena.<i>.purge purges all unused dirty and muzzy pages of the arena
+    // through the purge and dalloc extent hooks, which count the bytes
+    // actually released (concurrent decay of the arena is counted as well).
+    // jemalloc cannot purge only a part of an arena, so the arenas are
+    // purged one by one until at least 'size' bytes are released.
+    size_t released_after = released_before;
+    for (unsigned i = 0; i < je_pool->n_arenas; i++) {
+        if (size && released_after - released_before >= size) {
+            break;
+        }
+
+        char cmd[64];
+        snprintf(cmd, sizeof(cmd), "arena.%u.purge", je_pool->arenas[i]);
+        int err = je_mallctl(cmd, NULL, NULL, NULL, 0);
+        if (err) {
+            LOG_ERR("Could not purge arena %u.", je_pool->arenas[i]);
+            return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+        }
+
+        util_atomic_load_acquire(&je_pool->released_bytes, &released_after);
+    }
+
+    *released = released_after - released_before;
+
+    return UMF_RESULT_SUCCESS;
+}
+
 static umf_memory_pool_ops_t UMF_JEMALLOC_POOL_OPS = {
     .version = UMF_VERSION_CURRENT,
     .initialize = op_initialize,
@@ -468,8 +975,24 @@ static umf_memory_pool_ops_t UMF_JEMALLOC_POOL_OPS = {
     .malloc_usable_size = op_malloc_usable_size,
     .free = op_free,
     .get_last_allocation_error = op_get_last_allocation_error,
+    .trim = op_trim,
 };
 
 umf_memory_pool_ops_t *umfJemallocPoolOps(void) {
     return &UMF_JEMALLOC_POOL_OPS;
 }
+
+umf_result_t umfJemallocPoolGetArena(void *ptr, unsigned *arena) {
+    if (!ptr || !arena) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    size_t unsigned_size = sizeof(unsigned);
+    if (je_mallctl("arenas.lookup", (void *)arena, &unsigned_size,
+                   (void *)&ptr, sizeof(ptr))) {
+        LOG_ERR("Could not look up the arena of %p.", ptr);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+*/
+
+#ifndef UMF_JEMALLOC_POOL_INTERNAL_H
+#define UMF_JEMALLOC_POOL_INTERNAL_H 1
+
+#include <umf/base.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Retrieves the index of the jemalloc arena an allocation
+///        of a jemalloc pool was made from (for testing).
+/// @param ptr pointer to the allocated memory
+/// @param arena [out] index of the arena
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfJemallocPoolGetArena(void *ptr, unsigned *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UMF_JEMALLOC_POOL_INTERNAL_H */
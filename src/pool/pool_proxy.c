@@ -11,8 +11,10 @@
 #include <umf/pools/pool_proxy.h>
 
 #include <assert.h>
+#include <stdint.h>
 
 #include "base_alloc_global.h"
+#include "memory_provider_internal.h"
 #include "provider/provider_tracking.h"
 #include "utils_common.h"
 
@@ -20,6 +22,9 @@ static __TLS umf_result_t TLS_last_allocation_error;
 
 struct proxy_memory_pool {
     umf_memory_provider_handle_t hProvider;
+    // the provider reports whether the allocated memory is zero-filled,
+    // calloc() is not supported otherwise
+    int reports_zero_info;
 };
 
 static umf_result_t
@@ -34,6 +39,7 @@ proxy_pool_initialize(umf_memory_provider_handle_t hProvider, void *params,
     }
 
     pool->hProvider = hProvider;
+    pool->reports_zero_info = umfMemoryProviderReportsZeroInfo(hProvider);
     *ppPool = (void *)pool;
 
     return UMF_RESULT_SUCCESS;
@@ -67,14 +73,43 @@ static void *proxy_malloc(void *pool, size_t size) {
 static void *proxy_calloc(void *pool, size_t num, size_t size) {
     assert(pool);
 
-    (void)pool;
-    (void)num;
-    (void)size;
+    if (size && num > SIZE_MAX / size) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
 
-    // Currently we cannot implement calloc in a way that would
-    // work for memory that is inaccessible on the host
-    TLS_last_allocation_error = UMF_RESULT_ERROR_NOT_SUPPORTED;
-    return NULL;
+    size_t total_size = num * size;
+    if (total_size == 0) {
+        TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+        return NULL;
+    }
+
+    struct proxy_memory_pool *hPool = (struct proxy_memory_pool *)pool;
+    if (!hPool->reports_zero_info) {
+        // We cannot zero the memory in a way that would
+        // work for memory that is inaccessible on the host
+        TLS_last_allocation_error = UMF_RESULT_ERROR_NOT_SUPPORTED;
+        return NULL;
+    }
+
+    void *ptr;
+    int zeroed;
+    umf_result_t ret = umfMemoryProviderAllocWithZeroInfo(
+        hPool->hProvider, total_size, 0, &ptr, &zeroed);
+    if (ret != UMF_RESULT_SUCCESS) {
+        TLS_last_allocation_error = ret;
+        return NULL;
+    }
+
+    if (ptr && !zeroed) {
+        // the provider could not reuse the memory zeroed this time
+        umfMemoryProviderFree(hPool->hProvider, ptr, total_size);
+        TLS_last_allocation_error = UMF_RESULT_ERROR_NOT_SUPPORTED;
+        return NULL;
+    }
+
+    TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+    return ptr;
 }
 
 static void *proxy_realloc(void *pool, void *ptr, size_t size) {
@@ -122,6 +157,16 @@ static umf_result_t proxy_get_last_allocation_error(void *pool) {
     return TLS_last_allocation_error;
 }
 
+static umf_result_t proxy_trim(void *pool, size_t size, size_t *released) {
+    (void)pool; // not used
+    (void)size; // not used
+
+    // every allocation is freed directly to the memory provider,
+    // so the pool does not hold any free memory
+    *released = 0;
+    return UMF_RESULT_SUCCESS;
+}
+
 static umf_memory_pool_ops_t UMF_PROXY_POOL_OPS = {
     .version = UMF_VERSION_CURRENT,
     .initialize = proxy_pool_initialize,
@@ -132,6 +177,7 @@ static umf_memory_pool_ops_t UMF_PROXY_POOL_OPS = {
     .aligned_malloc = proxy_aligned_malloc,
     .malloc_usable_size = proxy_malloc_usable_size,
     .free = proxy_free,
-    .get_last_allocation_error = proxy_get_last_allocation_error};
+    .get_last_allocation_error = proxy_get_last_allocation_error,
+    .trim = proxy_trim};
 
 umf_memory_pool_ops_t *umfProxyPoolOps(void) { return &UMF_PROXY_POOL_OPS; }
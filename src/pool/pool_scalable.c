@@ -58,6 +58,8 @@ typedef struct tbb_callbacks_t {
 
 typedef struct tbb_memory_pool_t {
     umf_memory_provider_handle_t mem_provider;
+    // recommended page size of the provider, 0 if unknown
+    size_t page_size;
     void *tbb_pool;
     tbb_callbacks_t tbb_callbacks;
 } tbb_memory_pool_t;
@@ -147,8 +149,14 @@ static int init_tbb_callbacks(tbb_callbacks_t *tbb_callbacks) {
 static void *tbb_raw_alloc_wrapper(intptr_t pool_id, size_t *raw_bytes) {
     void *resPtr;
     tbb_memory_pool_t *pool = (tbb_memory_pool_t *)pool_id;
-    umf_result_t ret =
-        umfMemoryProviderAlloc(pool->mem_provider, *raw_bytes, 0, &resPtr);
+
+    // make the raw chunks start and end at page boundaries of the provider
+    if (pool->page_size) {
+        *raw_bytes = ALIGN_UP(*raw_bytes, pool->page_size);
+    }
+
+    umf_result_t ret = umfMemoryProviderAlloc(pool->mem_provider, *raw_bytes,
+                                              pool->page_size, &resPtr);
     if (ret != UMF_RESULT_SUCCESS) {
         TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
         return NULL;
@@ -169,15 +177,35 @@ static void tbb_raw_free_wrapper(intptr_t pool_id, void *ptr, size_t bytes) {
 
 static umf_result_t tbb_pool_initialize(umf_memory_provider_handle_t provider,
                                         void *params, void **pool) {
-    (void)params; // unused
+    umf_scalable_pool_params_t default_params = umfScalablePoolParamsDefault();
+    umf_scalable_pool_params_t *tbb_params =
+        params ? (umf_scalable_pool_params_t *)params : &default_params;
+
+    size_t granularity = tbb_params->granularity;
+    if (granularity == 0) {
+        granularity = UMF_SCALABLE_POOL_GRANULARITY_DEFAULT;
+    }
+
+    size_t page_size = 0;
+    umf_result_t umf_ret =
+        umfMemoryProviderGetRecommendedPageSize(provider, granularity,
+                                                &page_size);
+    if (umf_ret != UMF_RESULT_SUCCESS || page_size == 0 ||
+        (page_size & (page_size - 1))) {
+        LOG_DEBUG("cannot get the recommended page size of the memory "
+                  "provider, the chunks of the pool will not be aligned");
+        page_size = 0;
+    } else {
+        granularity = ALIGN_UP(granularity, page_size);
+    }
 
-    const size_t GRANULARITY = 2 * 1024 * 1024;
     tbb_mem_pool_policy_t policy = {.pAlloc = tbb_raw_alloc_wrapper,
                                     .pFree = tbb_raw_free_wrapper,
-                                    .granularity = GRANULARITY,
+                                    .granularity = granularity,
                                     .version = 1,
                                     .fixed_pool = false,
-                                    .keep_all_memory = false,
+                                    .keep_all_memory =
+                                        tbb_params->keep_all_memory != 0,
                                     .reserved = 0};
 
     tbb_memory_pool_t *pool_data =
@@ -190,19 +218,28 @@ static umf_result_t tbb_pool_initialize(umf_memory_provider_handle_t provider,
     int ret = init_tbb_callbacks(&pool_data->tbb_callbacks);
     if (ret != 0) {
         LOG_ERR("loading TBB symbols failed");
-        return UMF_RESULT_ERROR_UNKNOWN;
+        umf_ret = UMF_RESULT_ERROR_UNKNOWN;
+        goto err_free_pool_data;
     }
 
     pool_data->mem_provider = provider;
+    pool_data->page_size = page_size;
     ret = pool_data->tbb_callbacks.pool_create_v1((intptr_t)pool_data, &policy,
                                                   &(pool_data->tbb_pool));
     if (ret != 0 /* TBBMALLOC_OK */) {
-        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+        umf_ret = UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+        goto err_close_library;
     }
 
     *pool = (void *)pool_data;
 
     return UMF_RESULT_SUCCESS;
+
+err_close_library:
+    util_close_library(pool_data->tbb_callbacks.lib_handle);
+err_free_pool_data:
+    umf_ba_global_free(pool_data);
+    return umf_ret;
 }
 
 static void tbb_pool_finalize(void *pool) {
@@ -304,6 +341,8 @@ static umf_result_t tbb_get_last_allocation_error(void *pool) {
     return TLS_last_allocation_error;
 }
 
+// trim is not supported: the only way to make TBB release the memory
+// of a pool is pool_reset(), which frees the live allocations as well.
 static umf_memory_pool_ops_t UMF_SCALABLE_POOL_OPS = {
     .version = UMF_VERSION_CURRENT,
     .initialize = tbb_pool_initialize,
@@ -28,6 +28,9 @@
 
 #define TLS_MSG_BUF_LEN 1024
 
+// minimum size of a chunk of an allocation populated by a separate thread
+#define POPULATE_MIN_CHUNK_SIZE (16 * 1024 * 1024)
+
 typedef struct os_last_native_error_t {
     int32_t native_error;
     int errno_value;
@@ -52,6 +55,10 @@ static __TLS os_last_native_error_t TLS_last_native_error;
     (UMF_OS_RESULT_ERROR_PURGE_FORCE_FAILED - UMF_OS_RESULT_SUCCESS)
 #define _UMF_OS_RESULT_ERROR_TOPO_DISCOVERY_FAILED                             \
     (UMF_OS_RESULT_ERROR_TOPO_DISCOVERY_FAILED - UMF_OS_RESULT_SUCCESS)
+#define _UMF_OS_RESULT_ERROR_COMMIT_FAILED                                     \
+    (UMF_OS_RESULT_ERROR_COMMIT_FAILED - UMF_OS_RESULT_SUCCESS)
+#define _UMF_OS_RESULT_ERROR_DECOMMIT_FAILED                                   \
+    (UMF_OS_RESULT_ERROR_DECOMMIT_FAILED - UMF_OS_RESULT_SUCCESS)
 
 static const char *Native_error_str[] = {
     [_UMF_OS_RESULT_SUCCESS] = "success",
@@ -64,6 +71,8 @@ static const char *Native_error_str[] = {
     [_UMF_OS_RESULT_ERROR_PURGE_FORCE_FAILED] = "force purging failed",
     [_UMF_OS_RESULT_ERROR_TOPO_DISCOVERY_FAILED] =
         "HWLOC topology discovery failed",
+    [_UMF_OS_RESULT_ERROR_COMMIT_FAILED] = "committing memory failed",
+    [_UMF_OS_RESULT_ERROR_DECOMMIT_FAILED] = "decommitting memory failed",
 };
 
 static void os_store_last_native_error(int32_t native_error, int errno_value) {
@@ -209,11 +218,50 @@ static hwloc_membind_policy_t translate_numa_mode(umf_numa_mode_t mode,
     return -1;
 }
 
+// Returns 1 if the kernel's interleave policy (MPOL_INTERLEAVE) can replace
+// the manual interleaving with the given part size, so a single mbind() is
+// enough: the parts are single pages and the nodes are listed in the order
+// in which the kernel visits them (ascending). The kernel selects the node
+// of a page by its offset in the mapping, so the first page does not have to
+// land on numa_list[0] - the pages are spread over the nodes round-robin
+// as well, but starting from another node. The memory has to be advised not
+// to use transparent huge pages then (the system can use them for all
+// memory), each of which would land on a single node.
+static int
+kernel_interleave_possible(umf_os_memory_provider_params_t *in_params,
+                           os_memory_provider_t *provider) {
+    // transparent huge pages would be interleaved as whole huge pages
+    if (provider->page_size != provider->min_page_size ||
+        ALIGN_UP(in_params->part_size, provider->min_page_size) !=
+            provider->min_page_size) {
+        return 0;
+    }
+
+    for (unsigned i = 1; i < in_params->numa_list_len; i++) {
+        if (in_params->numa_list[i] <= in_params->numa_list[i - 1]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
 //return 1 if umf will bind memory directly to single NUMA node, based on internal algorithm
 //return 0 if umf will just set numa memory policy, and kernel will decide where to allocate memory
-static int dedicated_node_bind(umf_os_memory_provider_params_t *in_params) {
+static int dedicated_node_bind(umf_os_memory_provider_params_t *in_params,
+                               os_memory_provider_t *provider) {
     if (in_params->numa_mode == UMF_NUMA_MODE_INTERLEAVE) {
-        return in_params->part_size > 0;
+        if (in_params->part_size == 0) {
+            return 0;
+        }
+
+        if (kernel_interleave_possible(in_params, provider)) {
+            LOG_INFO("part size %zu is interleaved by the kernel",
+                     in_params->part_size);
+            return 0;
+        }
+
+        return 1;
     }
     if (in_params->numa_mode == UMF_NUMA_MODE_SPLIT) {
         return 1;
@@ -409,6 +457,183 @@ initializePartitions(os_memory_provider_t *provider,
     return UMF_RESULT_SUCCESS;
 }
 
+static umf_result_t
+initialize_huge_pages(umf_os_memory_provider_params_t *in_params,
+                      os_memory_provider_t *provider) {
+    size_t base_page_size = os_get_page_size();
+
+    provider->page_size = base_page_size;
+    provider->min_page_size = base_page_size;
+    provider->huge_page_flags = 0;
+    provider->huge_page_advise = 0;
+
+    umf_huge_pages_mode_t mode = in_params->huge_pages;
+    if (mode == UMF_HUGE_PAGES_NONE) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (mode != UMF_HUGE_PAGES_TRANSPARENT &&
+        mode != UMF_HUGE_PAGES_EXPLICIT) {
+        LOG_ERR("incorrect huge pages mode: %u", mode);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (mode == UMF_HUGE_PAGES_EXPLICIT &&
+        in_params->visibility == UMF_MEM_MAP_SHARED) {
+        LOG_ERR("explicit huge pages are not supported for the "
+                "UMF_MEM_MAP_SHARED memory visibility mode");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    size_t huge_page_size = in_params->huge_page_size;
+    if (huge_page_size &&
+        (huge_page_size < base_page_size ||
+         (huge_page_size & (huge_page_size - 1)))) {
+        LOG_ERR("incorrect huge page size: %zu (it has to be a power of 2 "
+                "not less than the page size (%zu))",
+                huge_page_size, base_page_size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (huge_page_size == 0) {
+        huge_page_size = os_get_huge_page_size();
+    }
+
+    if (huge_page_size == 0) {
+        LOG_WARN("huge pages are not supported, using regular pages");
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (mode == UMF_HUGE_PAGES_EXPLICIT) {
+        if (!os_huge_pages_reserved(huge_page_size)) {
+            LOG_WARN("no huge pages of size %zu are reserved, using "
+                     "transparent huge pages",
+                     huge_page_size);
+            mode = UMF_HUGE_PAGES_TRANSPARENT;
+        } else if (os_get_huge_page_flags(huge_page_size,
+                                          &provider->huge_page_flags)) {
+            LOG_WARN("explicit huge pages are not supported, using "
+                     "transparent huge pages");
+            mode = UMF_HUGE_PAGES_TRANSPARENT;
+        }
+    }
+
+    provider->page_size = huge_page_size;
+    if (mode == UMF_HUGE_PAGES_EXPLICIT) {
+        // mappings of huge pages cannot be split or unmapped partially
+        provider->min_page_size = huge_page_size;
+    }
+
+    // explicit huge pages fall back to transparent ones when
+    // there are no free huge pages, so the advise is always used
+    provider->huge_page_advise = 1;
+
+    LOG_INFO("using %s huge pages of size %zu",
+             (mode == UMF_HUGE_PAGES_EXPLICIT) ? "explicit" : "transparent",
+             huge_page_size);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t
+initialize_reservation(umf_os_memory_provider_params_t *in_params,
+                       os_memory_provider_t *provider) {
+    provider->reserved_addr = NULL;
+    provider->reserved_len = 0;
+    provider->reserved_ranges = NULL;
+    provider->reserved_uncommitted = NULL;
+
+    if (in_params->reserve_size == 0) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (in_params->huge_pages == UMF_HUGE_PAGES_EXPLICIT) {
+        LOG_ERR("reserving the address space is not supported for "
+                "the explicit huge pages");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    // the reservation is aligned to the (huge) page size
+    size_t alignment = provider->page_size;
+    size_t size = ALIGN_UP(in_params->reserve_size, alignment);
+    if (size < in_params->reserve_size || size + alignment < size) {
+        LOG_ERR("size of the address space reservation %zu is too big",
+                in_params->reserve_size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    provider->reserved_ranges = range_alloc_new();
+    if (!provider->reserved_ranges) {
+        LOG_ERR("creating the allocator of the reserved address space "
+                "failed");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    // the file is mapped into the reservation on every allocation,
+    // so only the private memory is committed once and tracked
+    if (provider->fd <= 0) {
+        provider->reserved_uncommitted = range_alloc_new();
+        if (!provider->reserved_uncommitted) {
+            LOG_ERR("creating the allocator of the reserved address space "
+                    "failed");
+            range_alloc_delete(provider->reserved_ranges);
+            provider->reserved_ranges = NULL;
+            return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    errno = 0;
+    provider->reserved_len = size + alignment;
+    provider->reserved_addr = os_reserve_memory(NULL, provider->reserved_len);
+    if (provider->reserved_addr == NULL) {
+        os_store_last_native_error(UMF_OS_RESULT_ERROR_ALLOC_FAILED, errno);
+        LOG_PERR("reserving %zu bytes of the address space failed",
+                 provider->reserved_len);
+        goto err_delete_ranges;
+    }
+
+    void *addr = (void *)ALIGN_UP((uintptr_t)provider->reserved_addr,
+                                  alignment);
+    if (range_alloc_free(provider->reserved_ranges, (uintptr_t)addr, size) ||
+        (provider->reserved_uncommitted &&
+         range_alloc_free(provider->reserved_uncommitted, (uintptr_t)addr,
+                          size))) {
+        goto err_release;
+    }
+
+    // the ranges mapped into the reservation later are advised again
+    if (provider->huge_page_advise && os_advise_huge_pages(addr, size)) {
+        // the memory can still be used with regular pages
+        LOG_PDEBUG("advising transparent huge pages failed");
+    }
+
+    LOG_INFO("reserved %zu bytes of the address space at %p", size, addr);
+
+    return UMF_RESULT_SUCCESS;
+
+err_release:
+    (void)os_munmap(provider->reserved_addr, provider->reserved_len);
+err_delete_ranges:
+    range_alloc_delete(provider->reserved_uncommitted);
+    provider->reserved_uncommitted = NULL;
+    range_alloc_delete(provider->reserved_ranges);
+    provider->reserved_ranges = NULL;
+    return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+}
+
+static void release_reservation(os_memory_provider_t *provider) {
+    if (provider->reserved_ranges == NULL) {
+        return;
+    }
+
+    // all memory carved from the reservation is released with it
+    (void)os_munmap(provider->reserved_addr, provider->reserved_len);
+    range_alloc_delete(provider->reserved_uncommitted);
+    provider->reserved_uncommitted = NULL;
+    range_alloc_delete(provider->reserved_ranges);
+    provider->reserved_ranges = NULL;
+}
+
 static umf_result_t translate_params(umf_os_memory_provider_params_t *in_params,
                                      os_memory_provider_t *provider) {
     umf_result_t result;
@@ -427,6 +652,11 @@ static umf_result_t translate_params(umf_os_memory_provider_params_t *in_params,
         return result;
     }
 
+    result = initialize_huge_pages(in_params, provider);
+    if (result != UMF_RESULT_SUCCESS) {
+        return result;
+    }
+
     // NUMA config
     int emptyNodeset = in_params->numa_list_len == 0;
     result = validate_numa_mode(in_params->numa_mode, emptyNodeset);
@@ -442,7 +672,7 @@ static umf_result_t translate_params(umf_os_memory_provider_params_t *in_params,
         return result;
     }
 
-    int is_dedicated_node_bind = dedicated_node_bind(in_params);
+    int is_dedicated_node_bind = dedicated_node_bind(in_params, provider);
     provider->numa_policy =
         translate_numa_mode(in_params->numa_mode, is_dedicated_node_bind);
 
@@ -450,6 +680,9 @@ static umf_result_t translate_params(umf_os_memory_provider_params_t *in_params,
 
     provider->numa_flags =
         getHwlocMembindFlags(in_params->numa_mode, is_dedicated_node_bind);
+    provider->no_huge_page_advise =
+        in_params->numa_mode == UMF_NUMA_MODE_INTERLEAVE &&
+        in_params->part_size && !is_dedicated_node_bind;
     provider->mode = in_params->numa_mode;
     provider->part_size = in_params->part_size;
 
@@ -463,6 +696,9 @@ static umf_result_t translate_params(umf_os_memory_provider_params_t *in_params,
 
     initializePartitions(provider, in_params);
 
+    provider->populate = in_params->populate;
+    provider->populate_threads = in_params->populate_threads;
+
     return UMF_RESULT_SUCCESS;
 }
 
@@ -515,16 +751,28 @@ static umf_result_t os_initialize(void *params, void **provider) {
         goto err_destroy_hwloc_topology;
     }
 
+    os_provider->fd_free_ranges = range_alloc_new();
+    if (!os_provider->fd_free_ranges) {
+        LOG_ERR("creating the allocator of file descriptor offsets failed");
+        ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        goto err_destroy_critnib;
+    }
+
     ret = translate_params(in_params, os_provider);
     if (ret != UMF_RESULT_SUCCESS) {
-        goto err_destroy_critnib;
+        goto err_destroy_range_alloc;
     }
 
-    ret = create_fd_for_mmap(in_params, os_provider);
+    ret = initialize_reservation(in_params, os_provider);
     if (ret != UMF_RESULT_SUCCESS) {
         goto err_destroy_bitmaps;
     }
 
+    ret = create_fd_for_mmap(in_params, os_provider);
+    if (ret != UMF_RESULT_SUCCESS) {
+        goto err_release_reservation;
+    }
+
     os_provider->nodeset_str_buf = umf_ba_global_alloc(NODESET_STR_BUF_LEN);
     if (!os_provider->nodeset_str_buf) {
         LOG_INFO("allocating memory for printing NUMA nodes failed");
@@ -543,8 +791,12 @@ static umf_result_t os_initialize(void *params, void **provider) {
 
     return UMF_RESULT_SUCCESS;
 
+err_release_reservation:
+    release_reservation(os_provider);
 err_destroy_bitmaps:
     free_bitmaps(os_provider);
+err_destroy_range_alloc:
+    range_alloc_delete(os_provider->fd_free_ranges);
 err_destroy_critnib:
     critnib_delete(os_provider->fd_offset_map);
 err_destroy_hwloc_topology:
@@ -562,6 +814,8 @@ static void os_finalize(void *provider) {
 
     os_memory_provider_t *os_provider = provider;
 
+    release_reservation(os_provider);
+    range_alloc_delete(os_provider->fd_free_ranges);
     critnib_delete(os_provider->fd_offset_map);
 
     free_bitmaps(os_provider);
@@ -622,11 +876,52 @@ static inline void assert_is_page_aligned(uintptr_t ptr, size_t page_size) {
     (void)page_size; // unused in Release build
 }
 
-static int os_mmap_aligned(void *hint_addr, size_t length, size_t alignment,
-                           size_t page_size, int prot, int flag, int fd,
-                           size_t max_fd_size, void **out_addr,
-                           size_t *fd_size) {
-    assert(out_addr);
+// Allocates a range of the file offsets of the given length. The freed
+// ranges are reused first and the file is grown only if none of them fits.
+static int fd_offset_alloc(os_memory_provider_t *provider, size_t length,
+                           size_t *fd_offset, int *reused) {
+    uintptr_t start;
+    if (range_alloc_alloc(provider->fd_free_ranges, length, 0, &start) == 0) {
+        *fd_offset = (size_t)start;
+        *reused = 1;
+        return 0;
+    }
+
+    size_t size_fd;
+    util_atomic_load_acquire(&provider->size_fd, &size_fd);
+    do {
+        if (length > provider->max_size_fd - size_fd) {
+            LOG_ERR("cannot grow a file size beyond %zu",
+                    provider->max_size_fd);
+            return -1;
+        }
+    } while (!util_compare_exchange((uint64_t *)&provider->size_fd,
+                                    (uint64_t *)&size_fd, size_fd + length));
+
+    *fd_offset = size_fd;
+    *reused = 0;
+    return 0;
+}
+
+static void fd_offset_free(os_memory_provider_t *provider, size_t fd_offset,
+                           size_t length) {
+    if (provider->fd <= 0 || length == 0) {
+        return;
+    }
+
+    int errno_saved = errno;
+    if (range_alloc_free(provider->fd_free_ranges, fd_offset, length)) {
+        LOG_ERR("cannot reuse the file range (offset=%zu, length=%zu)",
+                fd_offset, length);
+    }
+    errno = errno_saved;
+}
+
+static int os_mmap_aligned(os_memory_provider_t *provider, size_t length,
+                           size_t alignment, size_t page_size, int flag,
+                           void **out_addr, size_t *out_fd_offset,
+                           int *out_reused) {
+    assert(out_addr && out_fd_offset && out_reused);
 
     size_t extended_length = length;
 
@@ -639,20 +934,18 @@ static int os_mmap_aligned(void *hint_addr, size_t length, size_t alignment,
     }
 
     size_t fd_offset = 0;
+    *out_reused = 0;
 
-    if (fd > 0) {
-        if (*fd_size + extended_length > max_fd_size) {
-            LOG_ERR("cannot grow a file size beyond %zu", max_fd_size);
-            return -1;
-        }
-
-        fd_offset = *fd_size;
-        *fd_size += extended_length;
+    if (provider->fd > 0 && fd_offset_alloc(provider, extended_length,
+                                            &fd_offset, out_reused)) {
+        return -1;
     }
 
-    void *ptr = os_mmap(hint_addr, extended_length, prot, flag, fd, fd_offset);
+    void *ptr = os_mmap(NULL, extended_length, provider->protection, flag,
+                        provider->fd, fd_offset);
     if (ptr == NULL) {
         LOG_PDEBUG("memory mapping failed");
+        fd_offset_free(provider, fd_offset, extended_length);
         return -1;
     }
 
@@ -686,11 +979,115 @@ static int os_mmap_aligned(void *hint_addr, size_t length, size_t alignment,
             os_munmap((void *)tail, tail_len);
         }
 
+        // the unmapped parts of the file range can be reused
+        fd_offset_free(provider, fd_offset, head_len);
+        fd_offset_free(provider, fd_offset + (tail - addr), tail_len);
+
         *out_addr = (void *)aligned_addr;
+        *out_fd_offset = fd_offset + head_len;
         return 0;
     }
 
     *out_addr = ptr;
+    *out_fd_offset = fd_offset;
+    return 0;
+}
+
+static inline int is_reserved(os_memory_provider_t *provider, void *addr) {
+    return provider->reserved_ranges &&
+           (uintptr_t)addr >= (uintptr_t)provider->reserved_addr &&
+           (uintptr_t)addr <
+               (uintptr_t)provider->reserved_addr + provider->reserved_len;
+}
+
+// Carves the memory out of the reserved address space. The private memory
+// freed to the reservation stays committed (only its pages are released),
+// so only its first use (and the use after a decommit) changes the mapping.
+static int os_commit_reserved(os_memory_provider_t *provider, size_t size,
+                              size_t alignment, void **out_addr,
+                              size_t *out_fd_offset, int *out_reused) {
+    uintptr_t addr;
+
+    if (alignment < provider->min_page_size) {
+        alignment = provider->min_page_size;
+    }
+
+    if (range_alloc_alloc(provider->reserved_ranges, size, alignment,
+                          &addr)) {
+        LOG_DEBUG("no free range of size %zu in the reserved address space",
+                  size);
+        return -1;
+    }
+
+    if (provider->fd <= 0) {
+        // commit the never used or decommitted parts of the range
+        int uncommitted =
+            range_alloc_remove(provider->reserved_uncommitted, addr, size);
+        if (uncommitted < 0) {
+            goto err_free_range;
+        }
+
+        if (uncommitted) {
+            if (os_commit_memory((void *)addr, size, provider->protection,
+                                 provider->visibility)) {
+                LOG_PDEBUG("committing the reserved memory failed");
+                // a failed fixed mapping could have unmapped the range
+                if (os_reserve_memory((void *)addr, size) == NULL) {
+                    return -1;
+                }
+                (void)range_alloc_free(provider->reserved_uncommitted, addr,
+                                       size);
+                goto err_free_range;
+            }
+
+            // the new mapping does not inherit the advise of the reservation
+            if (provider->huge_page_advise &&
+                os_advise_huge_pages((void *)addr, size)) {
+                // the memory can still be used with regular pages
+                LOG_PDEBUG("advising transparent huge pages failed");
+            }
+        }
+
+        *out_addr = (void *)addr;
+        return 0;
+    }
+
+    if (fd_offset_alloc(provider, size, out_fd_offset, out_reused)) {
+        goto err_free_range;
+    }
+
+    if (os_mmap_fixed((void *)addr, size, provider->protection,
+                      provider->visibility, provider->fd, *out_fd_offset)) {
+        LOG_PDEBUG("mapping the file to the reserved address space failed");
+        fd_offset_free(provider, *out_fd_offset, size);
+        // a failed fixed mapping could have unmapped the reserved range
+        if (os_reserve_memory((void *)addr, size) == NULL) {
+            return -1;
+        }
+        goto err_free_range;
+    }
+
+    *out_addr = (void *)addr;
+    return 0;
+
+err_free_range:
+    (void)range_alloc_free(provider->reserved_ranges, addr, size);
+    return -1;
+}
+
+// Returns the memory to the reserved address space.
+static int os_release_reserved(os_memory_provider_t *provider, void *addr,
+                               size_t size) {
+    if (provider->fd > 0) {
+        // replace the mapping of the file with the reservation
+        if (os_reserve_memory(addr, size) == NULL) {
+            return -1;
+        }
+    } else if (os_purge(addr, size, UMF_PURGE_FORCE)) {
+        return -1;
+    }
+
+    (void)range_alloc_free(provider->reserved_ranges, (uintptr_t)addr, size);
     return 0;
 }
 
@@ -869,11 +1266,161 @@ static membind_t membindNext(os_memory_provider_t *provider,
     return membind;
 }
 
-static umf_result_t os_alloc(void *provider, size_t size, size_t alignment,
-                             void **resultPtr) {
+/// A chunk of an allocation populated by a separate thread
+typedef struct populate_task_t {
+    os_memory_provider_t *provider;
+    void *addr;
+    size_t size;
+    /// NUMA nodes the chunk is bound to (NULL or empty if it is not bound)
+    hwloc_bitmap_t nodeset;
+    int ret;
+    int err; // errno of the failure
+    os_thread_t thread;
+} populate_task_t;
+
+static void populate_tasks_delete(populate_task_t *tasks, unsigned n_tasks) {
+    if (tasks == NULL) {
+        return;
+    }
+
+    for (unsigned i = 0; i < n_tasks; i++) {
+        if (tasks[i].nodeset) {
+            hwloc_bitmap_free(tasks[i].nodeset);
+        }
+    }
+
+    umf_ba_global_free(tasks);
+}
+
+// Splits a large allocation into chunks populated in parallel. Returns NULL
+// if the allocation should be populated by the allocating thread alone.
+static populate_task_t *populate_tasks_new(os_memory_provider_t *provider,
+                                           void *addr, size_t size,
+                                           size_t page_size,
+                                           unsigned *n_tasks) {
+    size_t pages = size / page_size;
+    size_t n = size / POPULATE_MIN_CHUNK_SIZE;
+    if (n > provider->populate_threads) {
+        n = provider->populate_threads;
+    }
+    if (n > pages) {
+        n = pages;
+    }
+    if (n <= 1) {
+        return NULL;
+    }
+
+    populate_task_t *tasks = umf_ba_global_alloc(n * sizeof(*tasks));
+    if (tasks == NULL) {
+        LOG_DEBUG("allocation of the populate tasks failed, populating "
+                  "memory with a single thread");
+        return NULL;
+    }
+
+    char *chunk = addr;
+    for (size_t i = 0; i < n; i++) {
+        tasks[i].provider = provider;
+        tasks[i].addr = chunk;
+        tasks[i].size = (pages / n + (i < pages % n)) * page_size;
+        // if the allocation fails the thread is not pinned
+        tasks[i].nodeset = hwloc_bitmap_alloc();
+        tasks[i].ret = 0;
+        tasks[i].err = 0;
+        chunk += tasks[i].size;
+    }
+
+    *n_tasks = (unsigned)n;
+    return tasks;
+}
+
+// Adds the NUMA nodes a range of the allocation is bound to to the chunks
+// covering it. The ranges have to be added in the order of the addresses.
+static void populate_tasks_add_bind(populate_task_t *tasks, unsigned n_tasks,
+                                    unsigned *cursor, void *addr, size_t size,
+                                    hwloc_const_bitmap_t nodeset) {
+    uintptr_t start = (uintptr_t)addr;
+    uintptr_t end = start + size;
+
+    // skip the chunks ending before the range
+    while (*cursor < n_tasks &&
+           (uintptr_t)tasks[*cursor].addr + tasks[*cursor].size <= start) {
+        (*cursor)++;
+    }
+
+    for (unsigned i = *cursor; i < n_tasks && (uintptr_t)tasks[i].addr < end;
+         i++) {
+        if (tasks[i].nodeset) {
+            hwloc_bitmap_or(tasks[i].nodeset, tasks[i].nodeset, nodeset);
+        }
+    }
+}
+
+static void populate_task_run(populate_task_t *task) {
+    errno = 0;
+    task->ret =
+        os_populate(task->addr, task->size, task->provider->protection);
+    task->err = errno;
+}
+
+// a helper thread populating a chunk on the NUMA nodes it is bound to
+static void populate_thread(void *arg) {
+    populate_task_t *task = arg;
+    hwloc_topology_t topo = task->provider->topo;
+
+    if (task->nodeset && !hwloc_bitmap_iszero(task->nodeset)) {
+        hwloc_bitmap_t cpuset = hwloc_bitmap_alloc();
+        if (cpuset == NULL ||
+            hwloc_cpuset_from_nodeset(topo, cpuset, task->nodeset) ||
+            hwloc_set_cpubind(topo, cpuset, HWLOC_CPUBIND_THREAD)) {
+            // the chunk can be populated from any CPU
+            LOG_DEBUG("pinning a populating thread failed");
+        }
+        if (cpuset) {
+            hwloc_bitmap_free(cpuset);
+        }
+    }
+
+    populate_task_run(task);
+}
+
+static int os_populate_parallel(populate_task_t *tasks, unsigned n_tasks) {
+    // the allocating thread populates the first chunk itself
+    unsigned started = 1;
+    while (started < n_tasks) {
+        if (util_thread_create(&tasks[started].thread, populate_thread,
+                               &tasks[started])) {
+            LOG_DEBUG("starting a populating thread failed");
+            break;
+        }
+        started++;
+    }
+
+    // the chunks of the threads that could not be started are populated here
+    populate_task_run(&tasks[0]);
+    for (unsigned i = started; i < n_tasks; i++) {
+        populate_task_run(&tasks[i]);
+    }
+
+    for (unsigned i = 1; i < started; i++) {
+        util_thread_join(&tasks[i].thread);
+    }
+
+    for (unsigned i = 0; i < n_tasks; i++) {
+        if (tasks[i].ret) {
+            errno = tasks[i].err;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static umf_result_t os_alloc_with_zero_info(void *provider, size_t size,
+                                            size_t alignment, void **resultPtr,
+                                            int *zeroed) {
     int ret;
 
-    if (provider == NULL || resultPtr == NULL) {
+    if (provider == NULL || resultPtr == NULL || zeroed == NULL) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
@@ -893,18 +1440,65 @@ static umf_result_t os_alloc(void *provider, size_t size, size_t alignment,
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    size_t fd_offset = os_provider->size_fd; // needed for critnib_insert()
+    // mappings of explicit huge pages consist of whole huge pages
+    if (ALIGN_UP(size, page_size) < size) {
+        os_store_last_native_error(UMF_OS_RESULT_ERROR_ALLOC_FAILED, ENOMEM);
+        LOG_ERR("allocation size %zu is too big", size);
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+    size = ALIGN_UP(size, page_size);
+
+    // only allocations of at least one huge page can be backed by huge pages
+    int use_huge_pages =
+        os_provider->huge_page_advise && size >= os_provider->page_size;
+    if (use_huge_pages && alignment < os_provider->page_size) {
+        alignment = os_provider->page_size;
+    }
 
     void *addr = NULL;
-    errno = 0;
-    ret = os_mmap_aligned(NULL, size, alignment, page_size,
-                          os_provider->protection, os_provider->visibility,
-                          os_provider->fd, os_provider->max_size_fd, &addr,
-                          &os_provider->size_fd);
-    if (ret) {
-        os_store_last_native_error(UMF_OS_RESULT_ERROR_ALLOC_FAILED, errno);
-        LOG_PERR("memory allocation failed");
-        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    size_t fd_offset = 0; // needed for critnib_insert()
+    int reused = 0;
+
+    // the memory committed in the reserved address space is advised there
+    if (!os_provider->reserved_ranges ||
+        os_commit_reserved(os_provider, size, alignment, &addr, &fd_offset,
+                           &reused)) {
+        int flags = os_provider->visibility | os_provider->huge_page_flags;
+
+        errno = 0;
+        ret = os_mmap_aligned(os_provider, size, alignment, page_size, flags,
+                              &addr, &fd_offset, &reused);
+        int advise_huge_pages =
+            use_huge_pages && !os_provider->huge_page_flags;
+        if (ret && os_provider->huge_page_flags) {
+            // all reserved huge pages are in use
+            LOG_PDEBUG("mapping explicit huge pages failed, using transparent "
+                       "huge pages");
+            errno = 0;
+            ret = os_mmap_aligned(os_provider, size, alignment,
+                                  os_get_page_size(), os_provider->visibility,
+                                  &addr, &fd_offset, &reused);
+            advise_huge_pages = 1;
+        }
+        if (ret) {
+            os_store_last_native_error(UMF_OS_RESULT_ERROR_ALLOC_FAILED,
+                                       errno);
+            LOG_PERR("memory allocation failed");
+            return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+        }
+
+        if (advise_huge_pages && os_advise_huge_pages(addr, size)) {
+            // the memory can still be used with regular pages
+            LOG_PDEBUG("advising transparent huge pages failed");
+        }
+    }
+
+    // large allocations are populated in parallel
+    populate_task_t *tasks = NULL;
+    unsigned n_tasks = 0;
+    if (os_provider->populate) {
+        tasks = populate_tasks_new(os_provider, addr, size, page_size,
+                                   &n_tasks);
     }
 
     // verify the alignment
@@ -916,6 +1510,14 @@ static umf_result_t os_alloc(void *provider, size_t size, size_t alignment,
         goto err_unmap;
     }
 
+    // the pages interleaved by the kernel must not be merged into
+    // transparent huge pages (see kernel_interleave_possible())
+    if (os_provider->no_huge_page_advise &&
+        os_advise_no_huge_pages(addr, size)) {
+        LOG_PWARN("advising against transparent huge pages failed, the "
+                  "part size of the interleaving can be the huge page size");
+    }
+
     // Bind memory to NUMA nodes if numa_policy is other than DEFAULT
     if (os_provider->numa_policy != HWLOC_MEMBIND_DEFAULT) {
         membind_t membind = membindFirst(os_provider, addr, size, page_size);
@@ -923,6 +1525,8 @@ static umf_result_t os_alloc(void *provider, size_t size, size_t alignment,
             goto err_unmap;
         }
 
+        unsigned cursor = 0;
+
         do {
             errno = 0;
             ret = hwloc_set_area_membind(os_provider->topo, membind.addr,
@@ -943,10 +1547,28 @@ static umf_result_t os_alloc(void *provider, size_t size, size_t alignment,
                     goto err_unmap;
                 }
             }
+            if (tasks) {
+                populate_tasks_add_bind(tasks, n_tasks, &cursor, membind.addr,
+                                        membind.bind_size, membind.bitmap);
+            }
             membind = membindNext(os_provider, membind);
         } while (membind.alloc_size > 0);
     }
 
+    // populate the memory after it is bound to the NUMA nodes
+    if (os_provider->populate) {
+        errno = 0;
+        ret = tasks ? os_populate_parallel(tasks, n_tasks)
+                    : os_populate(addr, size, os_provider->protection);
+        if (ret) {
+            os_store_last_native_error(UMF_OS_RESULT_ERROR_ALLOC_FAILED,
+                                       errno);
+            LOG_PERR("populating memory failed");
+            goto err_unmap;
+        }
+        populate_tasks_delete(tasks, n_tasks);
+    }
+
     if (os_provider->fd > 0) {
         // store (fd_offset + 1) to be able to store fd_offset == 0
         ret =
@@ -959,15 +1581,37 @@ static umf_result_t os_alloc(void *provider, size_t size, size_t alignment,
         }
     }
 
+    // The memory is freshly mapped, so the OS has zero-filled it, unless
+    // it is backed by a reused file range that may not have been punched.
+    size_t punch_hole_failures = 0;
+    if (reused) {
+        util_atomic_load_acquire(&os_provider->fd_punch_hole_failures,
+                                 &punch_hole_failures);
+    }
+    *zeroed = (punch_hole_failures == 0);
+
     *resultPtr = addr;
 
     return UMF_RESULT_SUCCESS;
 
 err_unmap:
-    (void)os_munmap(addr, size);
+    populate_tasks_delete(tasks, n_tasks);
+    if (is_reserved(os_provider, addr)) {
+        (void)os_release_reserved(os_provider, addr, size);
+    } else {
+        (void)os_munmap(addr, size);
+    }
+    fd_offset_free(os_provider, fd_offset, size);
     return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
 }
 
+static umf_result_t os_alloc(void *provider, size_t size, size_t alignment,
+                             void **resultPtr) {
+    int zeroed;
+    return os_alloc_with_zero_info(provider, size, alignment, resultPtr,
+                                   &zeroed);
+}
+
 static umf_result_t os_free(void *provider, void *ptr, size_t size) {
     if (provider == NULL) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
@@ -979,12 +1623,17 @@ static umf_result_t os_free(void *provider, void *ptr, size_t size) {
 
     os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
 
+    void *value = NULL;
     if (os_provider->fd > 0) {
-        critnib_remove(os_provider->fd_offset_map, (uintptr_t)ptr);
+        value = critnib_remove(os_provider->fd_offset_map, (uintptr_t)ptr);
     }
 
+    size = ALIGN_UP(size, os_provider->min_page_size);
+
     errno = 0;
-    int ret = os_munmap(ptr, size);
+    int ret = is_reserved(os_provider, ptr)
+                  ? os_release_reserved(os_provider, ptr, size)
+                  : os_munmap(ptr, size);
     if (ret) {
         os_store_last_native_error(UMF_OS_RESULT_ERROR_FREE_FAILED, errno);
         LOG_PERR("memory deallocation failed");
@@ -992,6 +1641,19 @@ static umf_result_t os_free(void *provider, void *ptr, size_t size) {
         return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
     }
 
+    if (value) {
+        // Release the physical memory of the file range, so that the size
+        // of the shared memory tracks the allocated memory, and reuse it.
+        // All IPC handles of this memory have to be closed by now.
+        size_t fd_offset = (size_t)value - 1;
+        if (os_punch_hole(os_provider->fd, fd_offset, size)) {
+            LOG_PDEBUG("punching a hole in the file failed, the reused file "
+                       "ranges will not be reported as zeroed");
+            util_atomic_increment(&os_provider->fd_punch_hole_failures);
+        }
+        fd_offset_free(os_provider, fd_offset, size);
+    }
+
     return UMF_RESULT_SUCCESS;
 }
 
@@ -1038,7 +1700,8 @@ static umf_result_t os_get_recommended_page_size(void *provider, size_t size,
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    *page_size = os_get_page_size();
+    os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
+    *page_size = os_provider->page_size;
 
     return UMF_RESULT_SUCCESS;
 }
@@ -1047,7 +1710,14 @@ static umf_result_t os_get_min_page_size(void *provider, void *ptr,
                                          size_t *page_size) {
     (void)ptr; // unused
 
-    return os_get_recommended_page_size(provider, 0, page_size);
+    if (provider == NULL || page_size == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
+    *page_size = os_provider->min_page_size;
+
+    return UMF_RESULT_SUCCESS;
 }
 
 static umf_result_t os_purge_lazy(void *provider, void *ptr, size_t size) {
@@ -1055,8 +1725,14 @@ static umf_result_t os_purge_lazy(void *provider, void *ptr, size_t size) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
+    os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
+
+    // explicit huge pages cannot be purged lazily, so they are purged
+    // with force (the memory may come from transparent huge pages as well)
     errno = 0;
-    if (os_purge(ptr, size, UMF_PURGE_LAZY)) {
+    if (os_purge(ptr, size, UMF_PURGE_LAZY) &&
+        (!os_provider->huge_page_flags ||
+         os_purge(ptr, size, UMF_PURGE_FORCE))) {
         os_store_last_native_error(UMF_OS_RESULT_ERROR_PURGE_LAZY_FAILED,
                                    errno);
         LOG_PERR("lazy purging failed");
@@ -1081,6 +1757,148 @@ static umf_result_t os_purge_force(void *provider, void *ptr, size_t size) {
     return UMF_RESULT_SUCCESS;
 }
 
+// The decommitted private memory is remapped when committed again, which
+// loses the NUMA binding. It can be restored only if the whole provider
+// memory is bound to a single node set. The memory mapped from a file is
+// not supported, its pages are shared with the other mappings of the file.
+static int os_commit_supported(os_memory_provider_t *os_provider) {
+    return os_provider->fd <= 0 && os_provider->nodeset_len <= 1;
+}
+
+// The range to be (de)committed has to consist of whole pages. The provider
+// does not track the memory it allocated outside of the reservation, so only
+// a range of the reservation can be checked to belong to the provider -
+// it cannot cross the boundary of the reservation.
+static umf_result_t os_check_commit_range(os_memory_provider_t *os_provider,
+                                          void *ptr, size_t size) {
+    if ((uintptr_t)ptr % os_provider->min_page_size ||
+        size % os_provider->min_page_size) {
+        LOG_ERR("range (ptr=%p, size=%zu) is not aligned to the minimum page "
+                "size %zu",
+                ptr, size, os_provider->min_page_size);
+        return UMF_RESULT_ERROR_INVALID_ALIGNMENT;
+    }
+
+    if (size == 0) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    void *last = (char *)ptr + size - 1;
+    if (is_reserved(os_provider, ptr) != is_reserved(os_provider, last)) {
+        LOG_ERR("range (ptr=%p, size=%zu) crosses the boundary of "
+                "the reserved address space",
+                ptr, size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t os_commit(void *provider, void *ptr, size_t size) {
+    if (provider == NULL || ptr == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
+    if (!os_commit_supported(os_provider)) {
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    umf_result_t umf_result = os_check_commit_range(os_provider, ptr, size);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    int flag = os_provider->visibility | os_provider->huge_page_flags;
+
+    errno = 0;
+    int ret = os_commit_memory(ptr, size, os_provider->protection, flag);
+    if (ret && os_provider->huge_page_flags) {
+        // all reserved huge pages are in use (like in os_alloc())
+        errno = 0;
+        ret = os_commit_memory(ptr, size, os_provider->protection,
+                               os_provider->visibility);
+    }
+    if (ret) {
+        os_store_last_native_error(UMF_OS_RESULT_ERROR_COMMIT_FAILED, errno);
+        LOG_PERR("committing memory failed");
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    if (os_provider->huge_page_advise && os_advise_huge_pages(ptr, size)) {
+        // the memory can still be used with regular pages
+        LOG_PDEBUG("advising transparent huge pages failed");
+    }
+
+    if (os_provider->no_huge_page_advise &&
+        os_advise_no_huge_pages(ptr, size)) {
+        LOG_PWARN("advising against transparent huge pages failed, the "
+                  "part size of the interleaving can be the huge page size");
+    }
+
+    if (os_provider->numa_policy != HWLOC_MEMBIND_DEFAULT &&
+        os_provider->nodeset_len) {
+        errno = 0;
+        ret = hwloc_set_area_membind(os_provider->topo, ptr, size,
+                                     os_provider->nodeset[0],
+                                     os_provider->numa_policy,
+                                     os_provider->numa_flags);
+        // ENOSYS - memory binding is not implemented (like in os_alloc())
+        if (ret && errno != ENOSYS && errno != 0) {
+            os_store_last_native_error(UMF_OS_RESULT_ERROR_BIND_FAILED,
+                                       errno);
+            LOG_PERR("binding committed memory to NUMA node failed");
+            (void)os_decommit_memory(ptr, size);
+            return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+        }
+    }
+
+    if (is_reserved(os_provider, ptr)) {
+        (void)range_alloc_remove(os_provider->reserved_uncommitted,
+                                 (uintptr_t)ptr, size);
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t os_decommit(void *provider, void *ptr, size_t size) {
+    if (provider == NULL || ptr == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
+    if (!os_commit_supported(os_provider)) {
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    umf_result_t umf_result = os_check_commit_range(os_provider, ptr, size);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    errno = 0;
+    if (os_decommit_memory(ptr, size)) {
+        os_store_last_native_error(UMF_OS_RESULT_ERROR_DECOMMIT_FAILED, errno);
+        LOG_PERR("decommitting memory failed");
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    // the reserved range has to be committed again when it is reused
+    if (is_reserved(os_provider, ptr)) {
+        (void)range_alloc_remove(os_provider->reserved_uncommitted,
+                                 (uintptr_t)ptr, size);
+        if (range_alloc_free(os_provider->reserved_uncommitted,
+                             (uintptr_t)ptr, size)) {
+            LOG_ERR("cannot track the decommitted reserved memory");
+            (void)os_commit_memory(ptr, size, os_provider->protection,
+                                   os_provider->visibility);
+            return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
 static const char *os_get_name(void *provider) {
     (void)provider; // unused
     return "OS";
@@ -1093,6 +1911,15 @@ static umf_result_t os_allocation_split(void *provider, void *ptr,
     (void)totalSize;
 
     os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
+
+    // mappings of explicit huge pages can be unmapped only by whole pages
+    if (firstSize % os_provider->min_page_size) {
+        LOG_DEBUG("os_allocation_split(): the split size %zu is not "
+                  "a multiple of the minimum page size %zu",
+                  firstSize, os_provider->min_page_size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
     if (os_provider->fd <= 0) {
         return UMF_RESULT_SUCCESS;
     }
@@ -1300,6 +2127,9 @@ static umf_memory_provider_ops_t UMF_OS_MEMORY_PROVIDER_OPS = {
     .ext.purge_force = os_purge_force,
     .ext.allocation_merge = os_allocation_merge,
     .ext.allocation_split = os_allocation_split,
+    .ext.commit = os_commit,
+    .ext.decommit = os_decommit,
+    .ext.alloc_with_zero_info = os_alloc_with_zero_info,
     .ipc.get_ipc_handle_size = os_get_ipc_handle_size,
     .ipc.get_ipc_handle = os_get_ipc_handle,
     .ipc.put_ipc_handle = os_put_ipc_handle,
@@ -11,6 +11,7 @@
 #include <umf/providers/provider_os_memory.h>
 
 #include "critnib.h"
+#include "range_alloc.h"
 #include "umf_hwloc.h"
 #include "utils_common.h"
 
@@ -33,6 +34,12 @@ typedef struct os_memory_provider_t {
     int fd;             // file descriptor for memory mapping
     size_t size_fd;     // size of file used for memory mapping
     size_t max_size_fd; // maximum size of file used for memory mapping
+    // The freed ranges of the file offsets, reused before the file is grown.
+    // Their physical memory is released by punching holes in the file.
+    range_alloc_t *fd_free_ranges;
+    // the number of failed hole punches - when non-zero the reused file
+    // ranges cannot be assumed to be zero-filled
+    size_t fd_punch_hole_failures;
     // A critnib map storing (ptr, fd_offset + 1) pairs. We add 1 to fd_offset
     // in order to be able to store fd_offset equal 0, because
     // critnib_get() returns value or NULL, so a value cannot equal 0.
@@ -59,6 +66,27 @@ typedef struct os_memory_provider_t {
     size_t partitions_weight_sum;
 
     hwloc_topology_t topo;
+
+    // huge pages config
+    size_t page_size;     // recommended page size (the huge page size if used)
+    size_t min_page_size; // minimum page size of the allocations
+    int huge_page_flags;  // mmap flags requesting explicit huge pages
+    int huge_page_advise; // advise the kernel to use transparent huge pages
+    // advise the kernel not to use transparent huge pages, so that they
+    // do not defeat the single pages interleaved by the kernel
+    int no_huge_page_advise;
+
+    // address space reservation the allocations are carved from
+    void *reserved_addr; // NULL if the address space is not reserved
+    size_t reserved_len;
+    range_alloc_t *reserved_ranges; // the free ranges of the reservation
+    // the ranges of the reservation that are not committed (mapped
+    // accessible) - never used yet or decommitted (private memory only)
+    range_alloc_t *reserved_uncommitted;
+
+    // populating (prefaulting) the allocations
+    int populate;
+    unsigned populate_threads; // threads populating large allocations
 } os_memory_provider_t;
 
 umf_result_t os_translate_flags(unsigned in_flags, unsigned max,
@@ -86,15 +114,40 @@ int os_get_file_size(int fd, size_t *size);
 
 int os_set_file_size(int fd, size_t size);
 
+int os_punch_hole(int fd, size_t offset, size_t length);
+
 void *os_mmap(void *hint_addr, size_t length, int prot, int flag, int fd,
               size_t fd_offset);
 
 int os_munmap(void *addr, size_t length);
 
+void *os_reserve_memory(void *addr, size_t length);
+
+int os_mmap_fixed(void *addr, size_t length, int prot, int flag, int fd,
+                  size_t fd_offset);
+
 int os_purge(void *addr, size_t length, int advice);
 
+// Commits the private memory reserved or decommitted before,
+// 'flag' are the mmap flags of the new mapping (ignored on Windows).
+int os_commit_memory(void *addr, size_t length, int prot, int flag);
+
+int os_decommit_memory(void *addr, size_t length);
+
+int os_populate(void *addr, size_t length, int prot);
+
 size_t os_get_page_size(void);
 
+size_t os_get_huge_page_size(void);
+
+int os_huge_pages_reserved(size_t huge_page_size);
+
+int os_get_huge_page_flags(size_t huge_page_size, int *flags);
+
+int os_advise_huge_pages(void *addr, size_t length);
+
+int os_advise_no_huge_pages(void *addr, size_t length);
+
 void os_strerror(int errnum, char *buf, size_t buflen);
 
 #ifdef __cplusplus
@@ -5,8 +5,13 @@
  * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1 // for fallocate()
+#endif
+
 #include <errno.h>
 #include <fcntl.h>
+#include <stdio.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
@@ -17,6 +22,7 @@
 
 #include "provider_os_memory_internal.h"
 #include "utils_log.h"
+#include "utils_math.h"
 
 umf_result_t os_translate_mem_visibility_flag(umf_memory_visibility_t in_flag,
                                               unsigned *out_flag) {
@@ -152,3 +158,95 @@ int os_set_file_size(int fd, size_t size) {
     }
     return ret;
 }
+
+// release the physical memory backing the given range of a file
+int os_punch_hole(int fd, size_t offset, size_t length) {
+    errno = 0;
+    int ret = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                        (off_t)offset, (off_t)length);
+    if (ret) {
+        LOG_PDEBUG("fallocate(%i, PUNCH_HOLE, %zu, %zu) failed", fd, offset,
+                   length);
+    }
+    return ret;
+}
+
+// get the default huge page size of the system, 0 if it is unknown
+size_t os_get_huge_page_size(void) {
+    FILE *file = fopen("/proc/meminfo", "r");
+    if (file == NULL) {
+        LOG_PDEBUG("cannot open /proc/meminfo");
+        return 0;
+    }
+
+    char line[256];
+    size_t size_kB = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "Hugepagesize: %zu kB", &size_kB) == 1) {
+            break;
+        }
+    }
+
+    fclose(file);
+
+    return size_kB * 1024;
+}
+
+static size_t read_huge_pages_count(size_t huge_page_size, const char *name) {
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/kernel/mm/hugepages/hugepages-%zukB/%s",
+             huge_page_size / 1024, name);
+
+    // the file does not exist if the huge page size is not supported
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+
+    size_t count = 0;
+    if (fscanf(file, "%zu", &count) != 1) {
+        count = 0;
+    }
+
+    fclose(file);
+
+    return count;
+}
+
+// check if any huge pages of the given size are reserved in the system
+// (or can be allocated as surplus huge pages)
+int os_huge_pages_reserved(size_t huge_page_size) {
+    return read_huge_pages_count(huge_page_size, "nr_hugepages") > 0 ||
+           read_huge_pages_count(huge_page_size, "nr_overcommit_hugepages") > 0;
+}
+
+int os_get_huge_page_flags(size_t huge_page_size, int *flags) {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    *flags = MAP_HUGETLB | (int)(log2Utils(huge_page_size) << MAP_HUGE_SHIFT);
+    return 0;
+#else
+    (void)huge_page_size; // unused
+    (void)flags;          // unused
+    return -1;
+#endif
+}
+
+int os_advise_huge_pages(void *addr, size_t length) {
+#ifdef MADV_HUGEPAGE
+    return madvise(addr, length, MADV_HUGEPAGE);
+#else
+    (void)addr;   // unused
+    (void)length; // unused
+    return 0;
+#endif
+}
+
+int os_advise_no_huge_pages(void *addr, size_t length) {
+#ifdef MADV_NOHUGEPAGE
+    return madvise(addr, length, MADV_NOHUGEPAGE);
+#else
+    (void)addr;   // unused
+    (void)length; // unused
+    return 0;
+#endif
+}
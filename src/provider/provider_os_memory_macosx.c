@@ -59,3 +59,37 @@ int os_set_file_size(int fd, size_t size) {
     (void)size; // unused
     return 0;   // ignored on MacOSX
 }
+
+int os_punch_hole(int fd, size_t offset, size_t length) {
+    (void)fd;     // unused
+    (void)offset; // unused
+    (void)length; // unused
+    return -1;    // not supported on MacOSX
+}
+
+size_t os_get_huge_page_size(void) {
+    return 0; // not supported on MacOSX
+}
+
+int os_huge_pages_reserved(size_t huge_page_size) {
+    (void)huge_page_size; // unused
+    return 0;             // not supported on MacOSX
+}
+
+int os_get_huge_page_flags(size_t huge_page_size, int *flags) {
+    (void)huge_page_size; // unused
+    (void)flags;          // unused
+    return -1;            // not supported on MacOSX
+}
+
+int os_advise_huge_pages(void *addr, size_t length) {
+    (void)addr;   // unused
+    (void)length; // unused
+    return 0;     // ignored on MacOSX
+}
+
+int os_advise_no_huge_pages(void *addr, size_t length) {
+    (void)addr;   // unused
+    (void)length; // unused
+    return 0;     // ignored on MacOSX
+}
@@ -80,12 +80,103 @@ void *os_mmap(void *hint_addr, size_t length, int prot, int flag, int fd,
 
 int os_munmap(void *addr, size_t length) { return munmap(addr, length); }
 
+// reserve an inaccessible address range (at the given address if not NULL,
+// replacing the current mapping)
+void *os_reserve_memory(void *addr, size_t length) {
+    int flag = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+    if (addr) {
+        flag |= MAP_FIXED;
+    }
+
+    void *ptr = mmap(addr, length, PROT_NONE, flag, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+
+    return ptr;
+}
+
+int os_mmap_fixed(void *addr, size_t length, int prot, int flag, int fd,
+                  size_t fd_offset) {
+    void *ptr = os_mmap(addr, length, prot, flag | MAP_FIXED, fd, fd_offset);
+    return (ptr == NULL);
+}
+
 size_t os_get_page_size(void) { return sysconf(_SC_PAGE_SIZE); }
 
 int os_purge(void *addr, size_t length, int advice) {
     return madvise(addr, length, os_translate_purge_advise(advice));
 }
 
+// mmap() rounds the length up to whole pages, so an unaligned range
+// would change also the mapping of the rest of its last page
+static int os_is_page_aligned(void *addr, size_t length) {
+    size_t page_size = os_get_page_size();
+    if ((uintptr_t)addr % page_size || length % page_size) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    return 1;
+}
+
+int os_commit_memory(void *addr, size_t length, int prot, int flag) {
+    if (!os_is_page_aligned(addr, length)) {
+        return -1;
+    }
+
+    // replace the reservation with a new private anonymous mapping,
+    // which is zero-filled and charged to the commit limit again
+    return os_mmap_fixed(addr, length, prot, flag, -1, 0);
+}
+
+int os_decommit_memory(void *addr, size_t length) {
+    if (!os_is_page_aligned(addr, length)) {
+        return -1;
+    }
+
+    // Replace the mapping with an inaccessible MAP_NORESERVE one. Unlike
+    // madvise() and mprotect(), it releases both the physical pages and
+    // the commit charge of private memory.
+    return (os_reserve_memory(addr, length) == NULL);
+}
+
+// touch every page of the range to fault it in (keeping its content)
+static void os_touch_pages(void *addr, size_t length, int prot) {
+    size_t page_size = os_get_page_size();
+    volatile char *end = (char *)addr + length;
+    for (volatile char *p = addr; p < end; p += page_size) {
+        if (prot & PROT_WRITE) {
+            *p = *p;
+        } else {
+            (void)*p;
+        }
+    }
+}
+
+int os_populate(void *addr, size_t length, int prot) {
+    if (!(prot & (PROT_READ | PROT_WRITE))) {
+        return 0; // inaccessible memory cannot be populated
+    }
+
+#if defined(MADV_POPULATE_READ) && defined(MADV_POPULATE_WRITE)
+    // supported since Linux 5.14, fails with ENOMEM instead of a SIGBUS
+    // if the memory cannot be populated
+    int advice =
+        (prot & PROT_WRITE) ? MADV_POPULATE_WRITE : MADV_POPULATE_READ;
+    if (madvise(addr, length, advice) == 0) {
+        return 0;
+    }
+
+    if (errno != EINVAL) {
+        return -1;
+    }
+#endif
+
+    os_touch_pages(addr, length, prot);
+    return 0;
+}
+
 void os_strerror(int errnum, char *buf, size_t buflen) {
 // 'strerror_r' implementation is XSI-compliant (returns 0 on success)
 #if (_POSIX_C_SOURCE >= 200112L || _XOPEN_SOURCE >= 600) && !_GNU_SOURCE
@@ -103,6 +103,13 @@ int os_set_file_size(int fd, size_t size) {
     return 0;   // ignored on Windows
 }
 
+int os_punch_hole(int fd, size_t offset, size_t length) {
+    (void)fd;     // unused
+    (void)offset; // unused
+    (void)length; // unused
+    return -1;    // not supported on Windows
+}
+
 void *os_mmap(void *hint_addr, size_t length, int prot, int flag, int fd,
               size_t fd_offset) {
     (void)flag;      // ignored on Windows
@@ -118,6 +125,25 @@ int os_munmap(void *addr, size_t length) {
     return (VirtualFree(addr, 0, MEM_RELEASE) == 0);
 }
 
+void *os_reserve_memory(void *addr, size_t length) {
+    if (addr) {
+        return NULL; // replacing a mapping is not supported on Windows
+    }
+
+    return VirtualAlloc(NULL, length, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+int os_mmap_fixed(void *addr, size_t length, int prot, int flag, int fd,
+                  size_t fd_offset) {
+    (void)addr;      // unused
+    (void)length;    // unused
+    (void)prot;      // unused
+    (void)flag;      // unused
+    (void)fd;        // unused
+    (void)fd_offset; // unused
+    return -1;       // not supported on Windows
+}
+
 int os_purge(void *addr, size_t length, int advice) {
     // If VirtualFree() succeeds, the return value is nonzero.
     // If VirtualFree() fails, the return value is 0 (zero).
@@ -137,6 +163,25 @@ int os_purge(void *addr, size_t length, int advice) {
 #endif // _MSC_VER
 }
 
+int os_commit_memory(void *addr, size_t length, int prot, int flag) {
+    (void)flag; // unused
+
+    // If VirtualAlloc() succeeds, the return value is the base address.
+    // If VirtualAlloc() fails, the return value is NULL.
+    return (VirtualAlloc(addr, length, MEM_COMMIT, prot) == NULL);
+}
+
+int os_decommit_memory(void *addr, size_t length) {
+    return os_purge(addr, length, UMF_PURGE_FORCE);
+}
+
+int os_populate(void *addr, size_t length, int prot) {
+    (void)addr;   // unused
+    (void)length; // unused
+    (void)prot;   // unused
+    return 0;     // ignored on Windows
+}
+
 static void _os_get_page_size(void) {
     SYSTEM_INFO SystemInfo;
     GetSystemInfo(&SystemInfo);
@@ -148,6 +193,35 @@ size_t os_get_page_size(void) {
     return Page_size;
 }
 
+// large pages require the SeLockMemoryPrivilege privilege on Windows,
+// so they are not used for now
+size_t os_get_huge_page_size(void) {
+    return 0; // not supported on Windows
+}
+
+int os_huge_pages_reserved(size_t huge_page_size) {
+    (void)huge_page_size; // unused
+    return 0;             // not supported on Windows
+}
+
+int os_get_huge_page_flags(size_t huge_page_size, int *flags) {
+    (void)huge_page_size; // unused
+    (void)flags;          // unused
+    return -1;            // not supported on Windows
+}
+
+int os_advise_huge_pages(void *addr, size_t length) {
+    (void)addr;   // unused
+    (void)length; // unused
+    return 0;     // ignored on Windows
+}
+
+int os_advise_no_huge_pages(void *addr, size_t length) {
+    (void)addr;   // unused
+    (void)length; // unused
+    return 0;     // ignored on Windows
+}
+
 void os_strerror(int errnum, char *buf, size_t buflen) {
     strerror_s(buf, buflen, errnum);
 }
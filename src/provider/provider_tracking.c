@@ -11,6 +11,7 @@
 #include "base_alloc_global.h"
 #include "critnib.h"
 #include "ipc_internal.h"
+#include "memory_provider_internal.h"
 #include "utils_common.h"
 #include "utils_concurrency.h"
 #include "utils_log.h"
@@ -25,27 +26,112 @@
 #include <stdlib.h>
 #include <string.h>
 
-typedef struct tracker_value_t {
-    umf_memory_pool_handle_t pool;
+// Each tracked region is stored in a critnib as a single leaf:
+// the key is the base address, the value is the pool handle and
+// the auxiliary word is the size of the region, so no separate allocation
+// is needed to track a region.
+//
+// The tracker is split into UMF_TRACKER_SHARDS shards, each with its own
+// critnib and split/merge lock, so concurrent inserts and removes of regions
+// from different address chunks do not contend with each other. A region is
+// stored in the shard of its base address only, so a region may cover chunks
+// of other shards (see tracker_find()).
+
+static inline size_t tracker_chunk(uintptr_t addr) {
+    return (size_t)(addr >> UMF_TRACKER_SHARD_SHIFT);
+}
+
+static inline size_t tracker_shard_idx(uintptr_t addr) {
+    return tracker_chunk(addr) & (UMF_TRACKER_SHARDS - 1);
+}
+
+static inline umf_memory_tracker_shard_t *
+tracker_shard(umf_memory_tracker_handle_t hTracker, const void *ptr) {
+    return &hTracker->shards[tracker_shard_idx((uintptr_t)ptr)];
+}
+
+// Has to be called before a region of the given size is stored in the shard.
+static void tracker_shard_update_max_size(umf_memory_tracker_shard_t *shard,
+                                          size_t size) {
+    uint64_t max_size;
+    util_atomic_load_acquire(&shard->max_size, &max_size);
+    while (max_size < size &&
+           !util_compare_exchange(&shard->max_size, &max_size, size)) {
+    }
+}
+
+// Number of recently resolved regions remembered by each thread
+#define TRACKER_TLS_CACHE_SIZE 4
+
+// A region resolved by umfMemoryTrackerGetAllocInfo() and remembered
+// by the calling thread, so that subsequent lookups of pointers from the same
+// region (e.g. umfFree() of many small objects from one slab) do not have
+// to walk the critnib tree.
+typedef struct tracker_cache_entry_t {
+    uintptr_t base;
     size_t size;
-} tracker_value_t;
+    umf_memory_pool_handle_t pool;
+    // generation of the stripe of 'base' observed after the region was
+    // looked up, but before it was verified to be still tracked
+    uint64_t generation;
+} tracker_cache_entry_t;
+
+typedef struct tracker_cache_t {
+    tracker_cache_entry_t entries[TRACKER_TLS_CACHE_SIZE];
+    unsigned next; // index of the entry to be replaced next
+} tracker_cache_t;
+
+static __TLS tracker_cache_t TLS_tracker_cache;
+
+// Number of generation counters (a power of 2)
+#define TRACKER_GENERATIONS_SHIFT 8
+#define TRACKER_GENERATIONS (1 << TRACKER_GENERATIONS_SHIFT)
+
+// The base addresses of the tracked regions are hashed into
+// TRACKER_GENERATIONS stripes, each with its own generation counter,
+// incremented every time a region based in that stripe is removed, split
+// or merged (after the change is made in the critnib). A cached entry is
+// valid only if the generation of its stripe did not change since it was
+// looked up, so the caches of all threads are invalidated without any
+// cross-thread communication, but only for the regions sharing the stripe
+// of the changed one. The generations are never reset, so the caches stay
+// invalid also when the tracker is destroyed and created again. Each one has
+// its own cache line, so frees of unrelated regions do not contend.
+typedef struct tracker_generation_t {
+    uint64_t value;
+    char padding[64 - sizeof(uint64_t)];
+} tracker_generation_t;
+
+static tracker_generation_t Tracker_generation[TRACKER_GENERATIONS];
+
+static inline uint64_t *tracker_generation(uintptr_t base) {
+    // Fibonacci hashing of the page number, so that regions aligned
+    // to big powers of 2 (e.g. slabs) are spread over all the stripes
+    uint64_t h = (uint64_t)(base >> 12) * 0x9e3779b97f4a7c15ULL;
+    return &Tracker_generation[h >> (64 - TRACKER_GENERATIONS_SHIFT)].value;
+}
+
+static inline void tracker_invalidate_caches(const void *base) {
+    util_atomic_increment(tracker_generation((uintptr_t)base));
+}
+
+static inline void tracker_invalidate_all_caches(void) {
+    for (size_t i = 0; i < TRACKER_GENERATIONS; i++) {
+        util_atomic_increment(&Tracker_generation[i].value);
+    }
+}
 
 static umf_result_t umfMemoryTrackerAdd(umf_memory_tracker_handle_t hTracker,
                                         umf_memory_pool_handle_t pool,
                                         const void *ptr, size_t size) {
     assert(ptr);
+    assert(pool);
 
-    tracker_value_t *value = umf_ba_alloc(hTracker->tracker_allocator);
-    if (value == NULL) {
-        LOG_ERR("failed to allocate tracker value, ptr=%p, size=%zu", ptr,
-                size);
-        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
-    }
-
-    value->pool = pool;
-    value->size = size;
+    umf_memory_tracker_shard_t *shard = tracker_shard(hTracker, ptr);
+    tracker_shard_update_max_size(shard, size);
 
-    int ret = critnib_insert(hTracker->map, (uintptr_t)ptr, value, 0);
+    int ret = critnib_insert_aux(shard->map, (uintptr_t)ptr, pool,
+                                 (uintptr_t)size, 0);
 
     if (ret == 0) {
         LOG_DEBUG("memory region is added, tracker=%p, ptr=%p, size=%zu",
@@ -56,8 +142,6 @@ static umf_result_t umfMemoryTrackerAdd(umf_memory_tracker_handle_t hTracker,
     LOG_ERR("failed to insert tracker value, ret=%d, ptr=%p, size=%zu", ret,
             ptr, size);
 
-    umf_ba_free(hTracker->tracker_allocator, value);
-
     if (ret == ENOMEM) {
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
@@ -74,17 +158,71 @@ static umf_result_t umfMemoryTrackerRemove(umf_memory_tracker_handle_t hTracker,
     // Every umfMemoryTrackerAdd(..., ptr, ...) should have a corresponding
     // umfMemoryTrackerRemove call with the same ptr value.
 
-    void *value = critnib_remove(hTracker->map, (uintptr_t)ptr);
+    void *value =
+        critnib_remove(tracker_shard(hTracker, ptr)->map, (uintptr_t)ptr);
     if (!value) {
         LOG_ERR("pointer %p not found in the map", ptr);
         return UMF_RESULT_ERROR_UNKNOWN;
     }
 
-    umf_ba_free(hTracker->tracker_allocator, value);
+    tracker_invalidate_caches(ptr);
 
     return UMF_RESULT_SUCCESS;
 }
 
+// Finds the tracked region containing ptr.
+// Returns 1 if found and 0 otherwise.
+static int tracker_find(umf_memory_tracker_handle_t hTracker, const void *ptr,
+                        uintptr_t *rkey, umf_memory_pool_handle_t *rpool,
+                        uintptr_t *rsize) {
+    uintptr_t addr = (uintptr_t)ptr;
+    size_t chunk = tracker_chunk(addr);
+
+    // All keys of the chunk of ptr are in its shard and each of
+    // the preceding UMF_TRACKER_SHARDS - 1 chunks belongs to another shard,
+    // so the shards of the consecutive chunks are checked going down from
+    // the chunk of ptr. The first region found based in the checked chunk
+    // decides - the regions do not overlap, so if it does not contain ptr,
+    // no region based below it can. A shard is not looked into at all if even
+    // its largest region based in the checked chunk could not reach ptr,
+    // so a pointer not tracked usually costs a single critnib lookup.
+    for (size_t i = 0; i < UMF_TRACKER_SHARDS && i <= chunk; i++) {
+        uintptr_t chunk_base = (uintptr_t)(chunk - i)
+                               << UMF_TRACKER_SHARD_SHIFT;
+        uintptr_t chunk_last =
+            chunk_base + ((uintptr_t)1 << UMF_TRACKER_SHARD_SHIFT) - 1;
+        umf_memory_tracker_shard_t *shard =
+            tracker_shard(hTracker, (void *)chunk_base);
+
+        uint64_t max_size;
+        util_atomic_load_acquire(&shard->max_size, &max_size);
+        if (i > 0 && addr - chunk_last >= max_size) {
+            continue;
+        }
+
+        uintptr_t key;
+        umf_memory_pool_handle_t pool;
+        uintptr_t size;
+        if (!critnib_find_aux(shard->map, addr, FIND_LE, &key, (void **)&pool,
+                              &size)) {
+            continue;
+        }
+
+        if (addr - key < size) {
+            *rkey = key;
+            *rpool = pool;
+            *rsize = size;
+            return 1;
+        }
+
+        if (key >= chunk_base) {
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
 umf_memory_pool_handle_t umfMemoryTrackerGetPool(const void *ptr) {
     umf_alloc_info_t allocInfo = {NULL, 0, NULL};
     umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
@@ -105,16 +243,34 @@ umf_result_t umfMemoryTrackerGetAllocInfo(const void *ptr,
         return UMF_RESULT_ERROR_NOT_SUPPORTED;
     }
 
-    if (TRACKER->map == NULL) {
+    if (TRACKER->shards[0].map == NULL) {
         LOG_ERR("tracker's map is not created");
         return UMF_RESULT_ERROR_NOT_SUPPORTED;
     }
 
+    tracker_cache_t *cache = &TLS_tracker_cache;
+    for (unsigned i = 0; i < TRACKER_TLS_CACHE_SIZE; i++) {
+        tracker_cache_entry_t *entry = &cache->entries[i];
+        if ((uintptr_t)ptr - entry->base < entry->size) {
+            uint64_t generation;
+            util_atomic_load_acquire(tracker_generation(entry->base),
+                                     &generation);
+            if (entry->generation != generation) {
+                continue;
+            }
+
+            pAllocInfo->base = (void *)entry->base;
+            pAllocInfo->baseSize = entry->size;
+            pAllocInfo->pool = entry->pool;
+            return UMF_RESULT_SUCCESS;
+        }
+    }
+
     uintptr_t rkey;
-    tracker_value_t *rvalue;
-    int found = critnib_find(TRACKER->map, (uintptr_t)ptr, FIND_LE,
-                             (void *)&rkey, (void **)&rvalue);
-    if (!found || (uintptr_t)ptr >= rkey + rvalue->size) {
+    umf_memory_pool_handle_t rpool;
+    uintptr_t rsize;
+    int found = tracker_find(TRACKER, ptr, &rkey, &rpool, &rsize);
+    if (!found) {
         LOG_WARN("pointer %p not found in the "
                  "tracker, TRACKER=%p",
                  ptr, (void *)TRACKER);
@@ -122,8 +278,28 @@ umf_result_t umfMemoryTrackerGetAllocInfo(const void *ptr,
     }
 
     pAllocInfo->base = (void *)rkey;
-    pAllocInfo->baseSize = rvalue->size;
-    pAllocInfo->pool = rvalue->pool;
+    pAllocInfo->baseSize = rsize;
+    pAllocInfo->pool = rpool;
+
+    // The stripe of the region is known only after the lookup, so
+    // the region is cached only if it is still tracked unchanged after its
+    // generation was read - a region removed, split or merged later
+    // bumps the generation read here.
+    uint64_t generation;
+    util_atomic_load_acquire(tracker_generation(rkey), &generation);
+    uintptr_t size;
+    if (critnib_get_aux(tracker_shard(TRACKER, (void *)rkey)->map, rkey,
+                        &size) != rpool ||
+        size != rsize) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    tracker_cache_entry_t *entry = &cache->entries[cache->next];
+    entry->base = rkey;
+    entry->size = rsize;
+    entry->pool = rpool;
+    entry->generation = generation;
+    cache->next = (cache->next + 1) % TRACKER_TLS_CACHE_SIZE;
 
     return UMF_RESULT_SUCCESS;
 }
@@ -145,6 +321,18 @@ typedef struct umf_tracking_memory_provider_t {
 
 typedef struct umf_tracking_memory_provider_t umf_tracking_memory_provider_t;
 
+// Adds a region just allocated from the upstream provider to the tracker.
+// A failure is only logged, the allocation itself is still valid.
+static void trackingAdd(umf_tracking_memory_provider_t *p, void *ptr,
+                        size_t size) {
+    umf_result_t ret = umfMemoryTrackerAdd(p->hTracker, p->pool, ptr, size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("failed to add allocated region to the tracker, ptr = %p, size "
+                "= %zu, ret = %d",
+                ptr, size, ret);
+    }
+}
+
 static umf_result_t trackingAlloc(void *hProvider, size_t size,
                                   size_t alignment, void **ptr) {
     umf_tracking_memory_provider_t *p =
@@ -158,91 +346,138 @@ static umf_result_t trackingAlloc(void *hProvider, size_t size,
         return ret;
     }
 
-    umf_result_t ret2 = umfMemoryTrackerAdd(p->hTracker, p->pool, *ptr, size);
-    if (ret2 != UMF_RESULT_SUCCESS) {
-        LOG_ERR("failed to add allocated region to the tracker, ptr = %p, size "
-                "= %zu, ret = %d",
-                *ptr, size, ret2);
+    trackingAdd(p, *ptr, size);
+
+    return ret;
+}
+
+static umf_result_t trackingAllocWithZeroInfo(void *hProvider, size_t size,
+                                              size_t alignment, void **ptr,
+                                              int *zeroed) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)hProvider;
+    umf_result_t ret = UMF_RESULT_SUCCESS;
+
+    assert(p->hUpstream);
+
+    ret = umfMemoryProviderAllocWithZeroInfo(p->hUpstream, size, alignment, ptr,
+                                             zeroed);
+    if (ret != UMF_RESULT_SUCCESS || !*ptr) {
+        return ret;
     }
 
+    trackingAdd(p, *ptr, size);
+
     return ret;
 }
 
+// Locks the split/merge mutexes of the shards of both given regions,
+// always in the same order to avoid deadlocks.
+static int tracker_lock_shards(umf_memory_tracker_handle_t hTracker,
+                               const void *ptr1, const void *ptr2) {
+    size_t idx1 = tracker_shard_idx((uintptr_t)ptr1);
+    size_t idx2 = tracker_shard_idx((uintptr_t)ptr2);
+    if (idx1 > idx2) {
+        size_t tmp = idx1;
+        idx1 = idx2;
+        idx2 = tmp;
+    }
+
+    int r = util_mutex_lock(&hTracker->shards[idx1].splitMergeMutex);
+    if (r || idx1 == idx2) {
+        return r;
+    }
+
+    r = util_mutex_lock(&hTracker->shards[idx2].splitMergeMutex);
+    if (r) {
+        util_mutex_unlock(&hTracker->shards[idx1].splitMergeMutex);
+    }
+
+    return r;
+}
+
+static void tracker_unlock_shards(umf_memory_tracker_handle_t hTracker,
+                                  const void *ptr1, const void *ptr2) {
+    size_t idx1 = tracker_shard_idx((uintptr_t)ptr1);
+    size_t idx2 = tracker_shard_idx((uintptr_t)ptr2);
+
+    util_mutex_unlock(&hTracker->shards[idx1].splitMergeMutex);
+    if (idx1 != idx2) {
+        util_mutex_unlock(&hTracker->shards[idx2].splitMergeMutex);
+    }
+}
+
 static umf_result_t trackingAllocationSplit(void *hProvider, void *ptr,
                                             size_t totalSize,
                                             size_t firstSize) {
     umf_result_t ret = UMF_RESULT_ERROR_UNKNOWN;
     umf_tracking_memory_provider_t *provider =
         (umf_tracking_memory_provider_t *)hProvider;
+    critnib *map = tracker_shard(provider->hTracker, ptr)->map;
+    void *highPtr = (void *)(((uintptr_t)ptr) + firstSize);
 
-    tracker_value_t *splitValue =
-        umf_ba_alloc(provider->hTracker->tracker_allocator);
-    if (!splitValue) {
-        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
-    }
-
-    splitValue->pool = provider->pool;
-    splitValue->size = firstSize;
-
-    int r = util_mutex_lock(&provider->hTracker->splitMergeMutex);
+    int r = tracker_lock_shards(provider->hTracker, ptr, highPtr);
     if (r) {
-        goto err_lock;
+        return ret;
     }
 
-    tracker_value_t *value =
-        (tracker_value_t *)critnib_get(provider->hTracker->map, (uintptr_t)ptr);
-    if (!value) {
+    uintptr_t size;
+    void *pool = critnib_get_aux(map, (uintptr_t)ptr, &size);
+    if (!pool) {
         LOG_ERR("region for split is not found in the tracker");
         ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
         goto err;
     }
-    if (value->size != totalSize) {
+    if (size != totalSize) {
         LOG_ERR("tracked size %zu does not match requested size to split: %zu",
-                value->size, totalSize);
+                (size_t)size, totalSize);
         ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
         goto err;
     }
 
-    ret = umfMemoryProviderAllocationSplit(provider->hUpstream, ptr, totalSize,
-                                           firstSize);
-    if (ret != UMF_RESULT_SUCCESS) {
-        LOG_ERR("upstream provider failed to split the region");
-        goto err;
-    }
-
-    void *highPtr = (void *)(((uintptr_t)ptr) + firstSize);
     size_t secondSize = totalSize - firstSize;
 
-    // We'll have a duplicate entry for the range [highPtr, highValue->size] but this is fine,
-    // the value is the same anyway and we forbid removing that range concurrently
+    // The second part is added before the upstream provider splits
+    // the region, because adding it is the only step that can fail (ENOMEM)
+    // and it can be rolled back. Until the size of the first part is updated
+    // we'll have a duplicate entry for the range [highPtr, secondSize]
+    // but this is fine, the value is the same anyway and we forbid removing
+    // that range concurrently.
     ret = umfMemoryTrackerAdd(provider->hTracker, provider->pool, highPtr,
                               secondSize);
     if (ret != UMF_RESULT_SUCCESS) {
         LOG_ERR("failed to add split region to the tracker, ptr = %p, size "
                 "= %zu, ret = %d",
                 highPtr, secondSize, ret);
-        // TODO: what now? should we rollback the split? This can only happen due to ENOMEM
-        // so it's unlikely but probably the best solution would be to try to preallocate everything
-        // (value and critnib nodes) before calling umfMemoryProviderAllocationSplit.
         goto err;
     }
 
-    int cret = critnib_insert(provider->hTracker->map, (uintptr_t)ptr,
-                              (void *)splitValue, 1 /* update */);
-    // this cannot fail since we know the element exists (nothing to allocate)
+    ret = umfMemoryProviderAllocationSplit(provider->hUpstream, ptr, totalSize,
+                                           firstSize);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("upstream provider failed to split the region");
+        void *erasedhighPool = critnib_remove(
+            tracker_shard(provider->hTracker, highPtr)->map,
+            (uintptr_t)highPtr);
+        assert(erasedhighPool == provider->pool);
+        (void)erasedhighPool;
+        tracker_invalidate_caches(highPtr);
+        goto err;
+    }
+
+    // updating in place cannot fail, the region is there
+    int cret = critnib_update_aux(map, (uintptr_t)ptr, (uintptr_t)firstSize);
     assert(cret == 0);
     (void)cret;
 
-    // free the original value
-    umf_ba_free(provider->hTracker->tracker_allocator, value);
-    util_mutex_unlock(&provider->hTracker->splitMergeMutex);
+    tracker_invalidate_caches(ptr);
+
+    tracker_unlock_shards(provider->hTracker, ptr, highPtr);
 
     return UMF_RESULT_SUCCESS;
 
 err:
-    util_mutex_unlock(&provider->hTracker->splitMergeMutex);
-err_lock:
-    umf_ba_free(provider->hTracker->tracker_allocator, splitValue);
+    tracker_unlock_shards(provider->hTracker, ptr, highPtr);
     return ret;
 }
 
@@ -252,42 +487,35 @@ static umf_result_t trackingAllocationMerge(void *hProvider, void *lowPtr,
     umf_tracking_memory_provider_t *provider =
         (umf_tracking_memory_provider_t *)hProvider;
 
-    tracker_value_t *mergedValue =
-        umf_ba_alloc(provider->hTracker->tracker_allocator);
-
-    if (!mergedValue) {
-        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
-    }
-
-    mergedValue->pool = provider->pool;
-    mergedValue->size = totalSize;
+    critnib *lowMap = tracker_shard(provider->hTracker, lowPtr)->map;
+    critnib *highMap = tracker_shard(provider->hTracker, highPtr)->map;
 
-    int r = util_mutex_lock(&provider->hTracker->splitMergeMutex);
+    int r = tracker_lock_shards(provider->hTracker, lowPtr, highPtr);
     if (r) {
-        goto err_lock;
+        return ret;
     }
 
-    tracker_value_t *lowValue = (tracker_value_t *)critnib_get(
-        provider->hTracker->map, (uintptr_t)lowPtr);
-    if (!lowValue) {
+    uintptr_t lowSize;
+    void *lowPool = critnib_get_aux(lowMap, (uintptr_t)lowPtr, &lowSize);
+    if (!lowPool) {
         LOG_ERR("no left value");
         ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
         goto err;
     }
-    tracker_value_t *highValue = (tracker_value_t *)critnib_get(
-        provider->hTracker->map, (uintptr_t)highPtr);
-    if (!highValue) {
+    uintptr_t highSize;
+    void *highPool = critnib_get_aux(highMap, (uintptr_t)highPtr, &highSize);
+    if (!highPool) {
         LOG_ERR("no right value");
         ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
         goto err;
     }
-    if (lowValue->pool != highValue->pool) {
+    if (lowPool != highPool) {
         LOG_ERR("pool mismatch");
         ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
         goto err;
     }
-    if (lowValue->size + highValue->size != totalSize) {
-        LOG_ERR("lowValue->size + highValue->size != totalSize");
+    if (lowSize + highSize != totalSize) {
+        LOG_ERR("lowSize + highSize != totalSize");
         ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
         goto err;
     }
@@ -299,31 +527,32 @@ static umf_result_t trackingAllocationMerge(void *hProvider, void *lowPtr,
         goto err;
     }
 
-    // We'll have a duplicate entry for the range [highPtr, highValue->size] but this is fine,
-    // the value is the same anyway and we forbid removing that range concurrently
-    int cret = critnib_insert(provider->hTracker->map, (uintptr_t)lowPtr,
-                              (void *)mergedValue, 1 /* update */);
-    // this cannot fail since we know the element exists (nothing to allocate)
+    tracker_shard_update_max_size(tracker_shard(provider->hTracker, lowPtr),
+                                  totalSize);
+
+    // Neither updating in place nor removing can fail, so the tracker
+    // cannot get out of sync with the upstream provider here.
+    // We'll have a duplicate entry for the range [highPtr, highSize] until
+    // it is removed, but this is fine, the value is the same anyway and
+    // we forbid removing that range concurrently.
+    int cret =
+        critnib_update_aux(lowMap, (uintptr_t)lowPtr, (uintptr_t)totalSize);
     assert(cret == 0);
     (void)cret;
 
-    // free old value that we just replaced with mergedValue
-    umf_ba_free(provider->hTracker->tracker_allocator, lowValue);
-
-    void *erasedhighValue =
-        critnib_remove(provider->hTracker->map, (uintptr_t)highPtr);
-    assert(erasedhighValue == highValue);
+    void *erasedhighPool = critnib_remove(highMap, (uintptr_t)highPtr);
+    assert(erasedhighPool == highPool);
+    (void)erasedhighPool;
 
-    umf_ba_free(provider->hTracker->tracker_allocator, erasedhighValue);
+    tracker_invalidate_caches(lowPtr);
+    tracker_invalidate_caches(highPtr);
 
-    util_mutex_unlock(&provider->hTracker->splitMergeMutex);
+    tracker_unlock_shards(provider->hTracker, lowPtr, highPtr);
 
     return UMF_RESULT_SUCCESS;
 
 err:
-    util_mutex_unlock(&provider->hTracker->splitMergeMutex);
-err_lock:
-    umf_ba_free(provider->hTracker->tracker_allocator, mergedValue);
+    tracker_unlock_shards(provider->hTracker, lowPtr, highPtr);
     return ret;
 }
 
@@ -398,16 +627,18 @@ static void check_if_tracker_is_empty(umf_memory_tracker_handle_t hTracker,
     uintptr_t rkey;
     void *rvalue;
     size_t n_items = 0;
-    uintptr_t last_key = 0;
 
-    while (1 == critnib_find((critnib *)hTracker->map, last_key, FIND_G, &rkey,
-                             &rvalue)) {
-        tracker_value_t *value = (tracker_value_t *)rvalue;
-        if (value->pool == pool || pool == NULL) {
-            n_items++;
-        }
+    for (size_t i = 0; i < UMF_TRACKER_SHARDS; i++) {
+        uintptr_t last_key = 0;
+
+        while (1 == critnib_find(hTracker->shards[i].map, last_key, FIND_G,
+                                 &rkey, &rvalue)) {
+            if (rvalue == pool || pool == NULL) {
+                n_items++;
+            }
 
-        last_key = rkey;
+            last_key = rkey;
+        }
     }
 
     if (n_items) {
@@ -474,6 +705,53 @@ static umf_result_t trackingPurgeForce(void *provider, void *ptr, size_t size) {
     return umfMemoryProviderPurgeForce(p->hUpstream, ptr, size);
 }
 
+// Checks if the range is covered by the (adjacent) regions of the pool,
+// so that a pool cannot (de)commit memory it does not own.
+static int trackingOwnsRange(umf_tracking_memory_provider_t *p, void *ptr,
+                             size_t size) {
+    uintptr_t addr = (uintptr_t)ptr;
+    uintptr_t end = addr + size;
+    if (end < addr) {
+        return 0;
+    }
+
+    while (addr < end) {
+        uintptr_t rkey;
+        umf_memory_pool_handle_t rpool;
+        uintptr_t rsize;
+        if (!tracker_find(p->hTracker, (void *)addr, &rkey, &rpool,
+                          &rsize) ||
+            rpool != p->pool) {
+            LOG_ERR("range (ptr=%p, size=%zu) is not owned by the pool %p",
+                    ptr, size, (void *)p->pool);
+            return 0;
+        }
+        addr = rkey + rsize;
+    }
+
+    return 1;
+}
+
+static umf_result_t trackingCommit(void *provider, void *ptr, size_t size) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)provider;
+    if (!trackingOwnsRange(p, ptr, size)) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return umfMemoryProviderCommit(p->hUpstream, ptr, size);
+}
+
+static umf_result_t trackingDecommit(void *provider, void *ptr, size_t size) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)provider;
+    if (!trackingOwnsRange(p, ptr, size)) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return umfMemoryProviderDecommit(p->hUpstream, ptr, size);
+}
+
 static const char *trackingName(void *provider) {
     umf_tracking_memory_provider_t *p =
         (umf_tracking_memory_provider_t *)provider;
@@ -653,6 +931,9 @@ umf_memory_provider_ops_t UMF_TRACKING_MEMORY_PROVIDER_OPS = {
     .ext.purge_lazy = trackingPurgeLazy,
     .ext.allocation_split = trackingAllocationSplit,
     .ext.allocation_merge = trackingAllocationMerge,
+    .ext.commit = trackingCommit,
+    .ext.decommit = trackingDecommit,
+    .ext.alloc_with_zero_info = trackingAllocWithZeroInfo,
     .ipc.get_ipc_handle_size = trackingGetIpcHandleSize,
     .ipc.get_ipc_handle = trackingGetIpcHandle,
     .ipc.put_ipc_handle = trackingPutIpcHandle,
@@ -682,8 +963,14 @@ umf_result_t umfTrackingMemoryProviderCreate(
               (void *)params.hUpstream, (void *)params.hTracker,
               (void *)params.pool, (void *)params.ipcCache);
 
-    return umfMemoryProviderCreate(&UMF_TRACKING_MEMORY_PROVIDER_OPS, &params,
-                                   hTrackingProvider);
+    // the zero info is reported only if the upstream provider reports it,
+    // so that the pools can check it once
+    umf_memory_provider_ops_t ops = UMF_TRACKING_MEMORY_PROVIDER_OPS;
+    if (!umfMemoryProviderReportsZeroInfo(hUpstream)) {
+        ops.ext.alloc_with_zero_info = NULL;
+    }
+
+    return umfMemoryProviderCreate(&ops, &params, hTrackingProvider);
 }
 
 void umfTrackingMemoryProviderGetUpstreamProvider(
@@ -702,34 +989,34 @@ umf_memory_tracker_handle_t umfMemoryTrackerCreate(void) {
         return NULL;
     }
 
-    umf_ba_pool_t *tracker_allocator =
-        umf_ba_create(sizeof(struct tracker_value_t));
-    if (!tracker_allocator) {
-        goto err_free_handle;
-    }
+    size_t i;
+    for (i = 0; i < UMF_TRACKER_SHARDS; i++) {
+        umf_memory_tracker_shard_t *shard = &handle->shards[i];
 
-    handle->tracker_allocator = tracker_allocator;
+        void *mutex_ptr = util_mutex_init(&shard->splitMergeMutex);
+        if (!mutex_ptr) {
+            goto err_destroy_shards;
+        }
 
-    void *mutex_ptr = util_mutex_init(&handle->splitMergeMutex);
-    if (!mutex_ptr) {
-        goto err_destroy_tracker_allocator;
-    }
+        shard->map = critnib_new();
+        if (!shard->map) {
+            util_mutex_destroy_not_free(&shard->splitMergeMutex);
+            goto err_destroy_shards;
+        }
 
-    handle->map = critnib_new();
-    if (!handle->map) {
-        goto err_destroy_mutex;
+        shard->max_size = 0;
     }
 
-    LOG_DEBUG("tracker created, handle=%p, segment map=%p", (void *)handle,
-              (void *)handle->map);
+    LOG_DEBUG("tracker created, handle=%p, shards=%d", (void *)handle,
+              UMF_TRACKER_SHARDS);
 
     return handle;
 
-err_destroy_mutex:
-    util_mutex_destroy_not_free(&handle->splitMergeMutex);
-err_destroy_tracker_allocator:
-    umf_ba_destroy(tracker_allocator);
-err_free_handle:
+err_destroy_shards:
+    while (i--) {
+        critnib_delete(handle->shards[i].map);
+        util_mutex_destroy_not_free(&handle->shards[i].splitMergeMutex);
+    }
     umf_ba_global_free(handle);
     return NULL;
 }
@@ -750,13 +1037,15 @@ void umfMemoryTrackerDestroy(umf_memory_tracker_handle_t handle) {
     check_if_tracker_is_empty(handle, NULL);
 #endif /* NDEBUG */
 
+    tracker_invalidate_all_caches();
+
     // We have to zero all inner pointers,
     // because the tracker handle can be copied
     // and used in many places.
-    critnib_delete(handle->map);
-    handle->map = NULL;
-    util_mutex_destroy_not_free(&handle->splitMergeMutex);
-    umf_ba_destroy(handle->tracker_allocator);
-    handle->tracker_allocator = NULL;
+    for (size_t i = 0; i < UMF_TRACKER_SHARDS; i++) {
+        critnib_delete(handle->shards[i].map);
+        handle->shards[i].map = NULL;
+        util_mutex_destroy_not_free(&handle->shards[i].splitMergeMutex);
+    }
     umf_ba_global_free(handle);
 }
@@ -25,10 +25,28 @@
 extern "C" {
 #endif
 
-struct umf_memory_tracker_t {
-    umf_ba_pool_t *tracker_allocator;
+// Number of shards of the memory tracker, must be a power of 2
+#define UMF_TRACKER_SHARDS 8
+
+// The shard of an address is selected by its bits starting from
+// UMF_TRACKER_SHARD_SHIFT, i.e. the address space is divided into 2 MiB
+// chunks and consecutive chunks are assigned to consecutive shards (modulo
+// UMF_TRACKER_SHARDS). The regions of pools allocated close to each other
+// (e.g. from the same provider) are spread over all the shards this way,
+// so concurrent inserts and removes rarely go to the same shard.
+#define UMF_TRACKER_SHARD_SHIFT 21
+
+typedef struct umf_memory_tracker_shard_t {
     critnib *map;
     os_mutex_t splitMergeMutex;
+    // size of the largest region ever tracked in this shard (it never
+    // decreases), it bounds how far below a pointer its region can start
+    uint64_t max_size;
+} umf_memory_tracker_shard_t;
+
+// A region is tracked in the shard of its base address.
+struct umf_memory_tracker_t {
+    umf_memory_tracker_shard_t shards[UMF_TRACKER_SHARDS];
 };
 
 typedef struct umf_memory_tracker_t *umf_memory_tracker_handle_t;
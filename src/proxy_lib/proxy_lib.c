@@ -146,8 +146,18 @@ void proxy_lib_create_common(void) {
         exit(-1);
     }
 
+    void *pool_params = NULL;
+#if (defined PROXY_LIB_USES_JEMALLOC_POOL)
+    // the proxy pool backs malloc() of the whole process,
+    // so give its threads one arena per CPU to not contend on a single one
+    umf_jemalloc_pool_params_t jemalloc_params =
+        umfJemallocPoolParamsDefault();
+    jemalloc_params.n_arenas = 0;
+    pool_params = &jemalloc_params;
+#endif
+
     umf_result =
-        umfPoolCreate(umfPoolManagerOps(), OS_memory_provider, NULL,
+        umfPoolCreate(umfPoolManagerOps(), OS_memory_provider, pool_params,
                       UMF_POOL_CREATE_FLAG_DISABLE_TRACKING, &Proxy_pool);
     if (umf_result != UMF_RESULT_SUCCESS) {
         LOG_ERR("creating UMF pool manager failed");
@@ -0,0 +1,374 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#include <assert.h>
+#include <inttypes.h>
+
+#include "base_alloc.h"
+#include "base_alloc_global.h"
+#include "critnib.h"
+#include "range_alloc.h"
+#include "utils_concurrency.h"
+#include "utils_log.h"
+
+// A free range. The free ranges of the same size are linked
+// into a list, the head of which is stored in range_alloc_t.by_size.
+typedef struct free_range_t {
+    uintptr_t start;
+    size_t size;
+    struct free_range_t *next;
+    struct free_range_t *prev;
+} free_range_t;
+
+struct range_alloc_t {
+    os_mutex_t lock;
+    critnib *by_start; // start -> free_range_t
+    critnib *by_size;  // size -> list of free_range_t of that size
+    umf_ba_pool_t *nodes;
+};
+
+range_alloc_t *range_alloc_new(void) {
+    range_alloc_t *ra = umf_ba_global_alloc(sizeof(*ra));
+    if (!ra) {
+        return NULL;
+    }
+
+    if (!util_mutex_init(&ra->lock)) {
+        goto err_free_ra;
+    }
+
+    ra->by_start = critnib_new();
+    if (!ra->by_start) {
+        goto err_destroy_mutex;
+    }
+
+    ra->by_size = critnib_new();
+    if (!ra->by_size) {
+        goto err_delete_by_start;
+    }
+
+    ra->nodes = umf_ba_create(sizeof(free_range_t));
+    if (!ra->nodes) {
+        goto err_delete_by_size;
+    }
+
+    return ra;
+
+err_delete_by_size:
+    critnib_delete(ra->by_size);
+err_delete_by_start:
+    critnib_delete(ra->by_start);
+err_destroy_mutex:
+    util_mutex_destroy_not_free(&ra->lock);
+err_free_ra:
+    umf_ba_global_free(ra);
+    return NULL;
+}
+
+static int free_node_cb(uintptr_t key, void *value, void *privdata) {
+    (void)key; // unused
+    umf_ba_free((umf_ba_pool_t *)privdata, value);
+    return 0;
+}
+
+void range_alloc_delete(range_alloc_t *ra) {
+    if (!ra) {
+        return;
+    }
+
+    critnib_iter(ra->by_start, 0, UINTPTR_MAX, free_node_cb, ra->nodes);
+    umf_ba_destroy(ra->nodes);
+    critnib_delete(ra->by_size);
+    critnib_delete(ra->by_start);
+    util_mutex_destroy_not_free(&ra->lock);
+    umf_ba_global_free(ra);
+}
+
+// must be called with the lock held
+static int insert_range(range_alloc_t *ra, free_range_t *r) {
+    int ret = critnib_insert(ra->by_start, r->start, r, 0 /* update */);
+    if (ret) {
+        return -1;
+    }
+
+    free_range_t *head = critnib_get(ra->by_size, r->size);
+    r->prev = NULL;
+    r->next = head;
+    if (head) {
+        head->prev = r;
+    }
+
+    // replacing the value of an existing key does not allocate
+    ret = critnib_insert(ra->by_size, r->size, r, 1 /* update */);
+    if (ret) {
+        if (head) {
+            head->prev = NULL;
+        }
+        critnib_remove(ra->by_start, r->start);
+        return -1;
+    }
+
+    return 0;
+}
+
+// must be called with the lock held
+static void remove_range(range_alloc_t *ra, free_range_t *r) {
+    if (r->prev) {
+        r->prev->next = r->next;
+    } else if (r->next) {
+        critnib_insert(ra->by_size, r->size, r->next, 1 /* update */);
+    } else {
+        critnib_remove(ra->by_size, r->size);
+    }
+
+    if (r->next) {
+        r->next->prev = r->prev;
+    }
+
+    critnib_remove(ra->by_start, r->start);
+}
+
+// the alignment does not have to be a power of 2
+static inline size_t align_offset(uintptr_t start, size_t alignment) {
+    size_t rest = start % alignment;
+    return rest ? alignment - rest : 0;
+}
+
+// must be called with the lock held
+static free_range_t *find_best_fit(range_alloc_t *ra, size_t size,
+                                   size_t alignment) {
+    uintptr_t key = size;
+    uintptr_t rkey;
+    void *rvalue;
+
+    while (critnib_find(ra->by_size, key, FIND_GE, &rkey, &rvalue)) {
+        for (free_range_t *r = rvalue; r; r = r->next) {
+            if (align_offset(r->start, alignment) <= r->size - size) {
+                return r;
+            }
+        }
+
+        // none of the ranges of this size can be aligned, try bigger ones
+        if (rkey == UINTPTR_MAX) {
+            break;
+        }
+        key = rkey + 1;
+    }
+
+    return NULL;
+}
+
+int range_alloc_alloc(range_alloc_t *ra, size_t size, size_t alignment,
+                      uintptr_t *start) {
+    assert(ra && start);
+
+    if (size == 0) {
+        return -1;
+    }
+
+    if (alignment == 0) {
+        alignment = 1;
+    }
+
+    int ret = -1;
+    util_mutex_lock(&ra->lock);
+
+    free_range_t *r = find_best_fit(ra, size, alignment);
+    if (!r) {
+        goto err_unlock;
+    }
+
+    size_t head_size = align_offset(r->start, alignment);
+    uintptr_t aligned = r->start + head_size;
+    size_t tail_size = r->size - head_size - size;
+
+    // splitting the range in three needs one more node -
+    // allocate it before anything is modified
+    free_range_t *tail = r;
+    if (head_size && tail_size) {
+        tail = umf_ba_alloc(ra->nodes);
+        if (!tail) {
+            LOG_ERR("allocation of a free range node failed");
+            goto err_unlock;
+        }
+    }
+
+    remove_range(ra, r);
+
+    if (head_size) {
+        r->size = head_size;
+        if (insert_range(ra, r)) {
+            LOG_ERR("cannot insert a free range, %zu bytes at 0x%" PRIxPTR
+                    " are lost",
+                    head_size, r->start);
+            umf_ba_free(ra->nodes, r);
+        }
+    }
+
+    if (tail_size) {
+        tail->start = aligned + size;
+        tail->size = tail_size;
+        if (insert_range(ra, tail)) {
+            LOG_ERR("cannot insert a free range, %zu bytes at 0x%" PRIxPTR
+                    " are lost",
+                    tail_size, tail->start);
+            umf_ba_free(ra->nodes, tail);
+        }
+    }
+
+    if (!head_size && !tail_size) {
+        umf_ba_free(ra->nodes, r);
+    }
+
+    *start = aligned;
+    ret = 0;
+
+err_unlock:
+    util_mutex_unlock(&ra->lock);
+    return ret;
+}
+
+int range_alloc_free(range_alloc_t *ra, uintptr_t start, size_t size) {
+    assert(ra);
+
+    if (size == 0) {
+        return 0;
+    }
+
+    int ret = 0;
+    free_range_t *node = NULL;
+    uintptr_t rkey;
+    void *rvalue;
+
+    util_mutex_lock(&ra->lock);
+
+    // coalesce with the preceding free range
+    if (critnib_find(ra->by_start, start, FIND_L, &rkey, &rvalue)) {
+        free_range_t *prev = rvalue;
+        assert(prev->start + prev->size <= start);
+        if (prev->start + prev->size == start) {
+            remove_range(ra, prev);
+            start = prev->start;
+            size += prev->size;
+            node = prev;
+        }
+    }
+
+    // coalesce with the following free range
+    free_range_t *next = critnib_get(ra->by_start, start + size);
+    if (next) {
+        remove_range(ra, next);
+        size += next->size;
+        if (node) {
+            umf_ba_free(ra->nodes, next);
+        } else {
+            node = next;
+        }
+    }
+
+    if (!node) {
+        node = umf_ba_alloc(ra->nodes);
+        if (!node) {
+            LOG_ERR("allocation of a free range node failed");
+            ret = -1;
+            goto err_unlock;
+        }
+    }
+
+    node->start = start;
+    node->size = size;
+    if (insert_range(ra, node)) {
+        LOG_ERR("cannot insert a free range, %zu bytes at 0x%" PRIxPTR
+                " are lost",
+                size, start);
+        umf_ba_free(ra->nodes, node);
+        ret = -1;
+    }
+
+err_unlock:
+    util_mutex_unlock(&ra->lock);
+    return ret;
+}
+
+int range_alloc_remove(range_alloc_t *ra, uintptr_t start, size_t size) {
+    assert(ra);
+
+    if (size == 0) {
+        return 0;
+    }
+
+    int ret = 0;
+    uintptr_t end = start + size;
+    uintptr_t key = end;
+    uintptr_t rkey;
+    void *rvalue;
+
+    util_mutex_lock(&ra->lock);
+
+    // the free ranges are disjoint, so they are visited from the last one
+    // starting below the end of the removed range down to its start
+    while (critnib_find(ra->by_start, key, FIND_L, &rkey, &rvalue)) {
+        free_range_t *r = rvalue;
+        uintptr_t r_end = r->start + r->size;
+        if (r_end <= start) {
+            break;
+        }
+
+        size_t head_size = (r->start < start) ? start - r->start : 0;
+        size_t tail_size = (r_end > end) ? r_end - end : 0;
+
+        // splitting the range in two needs one more node -
+        // allocate it before anything is modified
+        free_range_t *tail = r;
+        if (head_size && tail_size) {
+            tail = umf_ba_alloc(ra->nodes);
+            if (!tail) {
+                LOG_ERR("allocation of a free range node failed");
+                ret = -1;
+                break;
+            }
+        }
+
+        key = r->start;
+        remove_range(ra, r);
+
+        if (head_size) {
+            r->size = head_size;
+            if (insert_range(ra, r)) {
+                LOG_ERR("cannot insert a free range, %zu bytes at 0x%" PRIxPTR
+                        " are lost",
+                        head_size, r->start);
+                umf_ba_free(ra->nodes, r);
+            }
+        }
+
+        if (tail_size) {
+            tail->start = end;
+            tail->size = tail_size;
+            if (insert_range(ra, tail)) {
+                LOG_ERR("cannot insert a free range, %zu bytes at 0x%" PRIxPTR
+                        " are lost",
+                        tail_size, tail->start);
+                umf_ba_free(ra->nodes, tail);
+            }
+        }
+
+        if (!head_size && !tail_size) {
+            umf_ba_free(ra->nodes, r);
+        }
+
+        ret = 1;
+        if (head_size || key == 0) {
+            break; // no other free range overlaps the removed one
+        }
+    }
+
+    util_mutex_unlock(&ra->lock);
+    return ret;
+}
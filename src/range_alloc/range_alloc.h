@@ -0,0 +1,50 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#ifndef UMF_RANGE_ALLOC_H
+#define UMF_RANGE_ALLOC_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// An allocator of ranges of an address space (e.g. of a reserved virtual
+// address range or of the offsets of a file). It keeps track of the free
+// ranges only - they are added with range_alloc_free(), coalesced with
+// the adjacent free ranges and handed out best-fit by range_alloc_alloc().
+// All functions are thread-safe.
+typedef struct range_alloc_t range_alloc_t;
+
+range_alloc_t *range_alloc_new(void);
+void range_alloc_delete(range_alloc_t *ra);
+
+// Allocates a range of the given size aligned to the given alignment
+// (0 means no alignment) from the free ranges. Returns 0 on success
+// and -1 if there is no free range big enough.
+int range_alloc_alloc(range_alloc_t *ra, size_t size, size_t alignment,
+                      uintptr_t *start);
+
+// Adds the range to the free ranges. Returns 0 on success and -1
+// if the metadata of the range could not be allocated.
+int range_alloc_free(range_alloc_t *ra, uintptr_t start, size_t size);
+
+// Removes the given range from the free ranges (its parts that are not free
+// are skipped). Returns 1 if any part of it was free, 0 if none was and -1
+// if the metadata of a split free range could not be allocated (nothing
+// is removed then).
+int range_alloc_remove(range_alloc_t *ra, uintptr_t start, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UMF_RANGE_ALLOC_H */
@@ -79,6 +79,13 @@ int utils_getpid(void);
 // get the current thread ID
 int utils_gettid(void);
 
+// get the number of the CPU the calling thread is running on
+// (0 if it cannot be determined)
+unsigned utils_get_current_cpu(void);
+
+// get the number of online CPUs
+unsigned utils_get_num_cpus(void);
+
 // close file descriptor
 int utils_close_fd(int fd);
 
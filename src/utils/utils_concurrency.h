@@ -10,6 +10,7 @@
 #ifndef UMF_UTILS_CONCURRENCY_H
 #define UMF_UTILS_CONCURRENCY_H 1
 
+#include <stdint.h>
 #include <stdio.h>
 
 #ifdef _WIN32
@@ -46,6 +47,21 @@ void util_mutex_destroy_not_free(os_mutex_t *m);
 int util_mutex_lock(os_mutex_t *mutex);
 int util_mutex_unlock(os_mutex_t *mutex);
 
+typedef struct os_thread_t {
+    void (*func)(void *arg);
+    void *arg;
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t thread;
+#endif
+} os_thread_t;
+
+// starts a thread running func(arg), returns 0 on success
+int util_thread_create(os_thread_t *thread, void (*func)(void *arg),
+                       void *arg);
+int util_thread_join(os_thread_t *thread);
+
 #if defined(_WIN32)
 #define UTIL_ONCE_FLAG INIT_ONCE
 #define UTIL_ONCE_FLAG_INIT INIT_ONCE_STATIC_INIT
@@ -78,8 +94,23 @@ static __inline unsigned char util_mssb_index(long long value) {
     InterlockedExchange64((LONG64 volatile *)object, (LONG64)desired)
 #define util_atomic_increment(object)                                          \
     InterlockedIncrement64((LONG64 volatile *)object)
+#define util_atomic_decrement(object)                                          \
+    InterlockedDecrement64((LONG64 volatile *)object)
 #define util_fetch_and_add64(ptr, value)                                       \
     InterlockedExchangeAdd64((LONG64 *)(ptr), value)
+
+// returns non-zero if *object was equal to *expected and was replaced
+// with desired, otherwise stores the current value of *object in *expected
+static __inline int util_compare_exchange(uint64_t *object, uint64_t *expected,
+                                          uint64_t desired) {
+    uint64_t prev = (uint64_t)InterlockedCompareExchange64(
+        (LONG64 volatile *)object, (LONG64)desired, (LONG64)*expected);
+    if (prev == *expected) {
+        return 1;
+    }
+    *expected = prev;
+    return 0;
+}
 #else
 #define util_lssb_index(x) ((unsigned char)__builtin_ctzll(x))
 #define util_mssb_index(x) ((unsigned char)(63 - __builtin_clzll(x)))
@@ -97,7 +128,12 @@ static __inline unsigned char util_mssb_index(long long value) {
 
 #define util_atomic_increment(object)                                          \
     __atomic_add_fetch(object, 1, __ATOMIC_ACQ_REL)
+#define util_atomic_decrement(object)                                          \
+    __atomic_sub_fetch(object, 1, __ATOMIC_ACQ_REL)
 #define util_fetch_and_add64 __sync_fetch_and_add
+#define util_compare_exchange(object, expected, desired)                       \
+    __atomic_compare_exchange_n(object, expected, desired, 0 /* strong */,     \
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
 #endif
 
 #ifdef __cplusplus
@@ -7,7 +7,14 @@
  *
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1 // for sched_getcpu()
+#endif
+
 #include <errno.h>
+#ifndef __APPLE__
+#include <sched.h>
+#endif
 #include <stdlib.h>
 #include <string.h>
 #include <sys/syscall.h>
@@ -49,6 +56,20 @@ int utils_gettid(void) {
 #endif
 }
 
+unsigned utils_get_current_cpu(void) {
+#ifdef __APPLE__
+    return 0;
+#else
+    int cpu = sched_getcpu();
+    return (cpu < 0) ? 0 : (unsigned)cpu;
+#endif
+}
+
+unsigned utils_get_num_cpus(void) {
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return (num_cpus < 1) ? 1 : (unsigned)num_cpus;
+}
+
 int utils_close_fd(int fd) { return close(fd); }
 
 #ifndef __APPLE__
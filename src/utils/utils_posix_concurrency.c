@@ -34,6 +34,23 @@ int util_mutex_unlock(os_mutex_t *m) {
     return pthread_mutex_unlock((pthread_mutex_t *)m);
 }
 
+static void *thread_start(void *arg) {
+    os_thread_t *thread = (os_thread_t *)arg;
+    thread->func(thread->arg);
+    return NULL;
+}
+
+int util_thread_create(os_thread_t *thread, void (*func)(void *arg),
+                       void *arg) {
+    thread->func = func;
+    thread->arg = arg;
+    return pthread_create(&thread->thread, NULL, thread_start, thread);
+}
+
+int util_thread_join(os_thread_t *thread) {
+    return pthread_join(thread->thread, NULL);
+}
+
 void util_init_once(UTIL_ONCE_FLAG *flag, void (*oneCb)(void)) {
     pthread_once(flag, oneCb);
 }
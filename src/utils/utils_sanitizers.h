@@ -68,6 +68,7 @@
 #define VALGRIND_DO_DESTROY_MEMPOOL VALGRIND_DESTROY_MEMPOOL
 #define VALGRIND_DO_MEMPOOL_ALLOC VALGRIND_MEMPOOL_ALLOC
 #define VALGRIND_DO_MEMPOOL_FREE VALGRIND_MEMPOOL_FREE
+#define VALGRIND_DO_MEMPOOL_CHANGE VALGRIND_MEMPOOL_CHANGE
 #else
 #define VALGRIND_DO_MALLOCLIKE_BLOCK(ptr, size, rzB, is_zeroed)                \
     do {                                                                       \
@@ -107,6 +108,14 @@
         (void)(pool);                                                          \
         (void)(ptr);                                                           \
     } while (0)
+
+#define VALGRIND_DO_MEMPOOL_CHANGE(pool, ptrA, ptrB, size)                     \
+    do {                                                                       \
+        (void)(pool);                                                          \
+        (void)(ptrA);                                                          \
+        (void)(ptrB);                                                          \
+        (void)(size);                                                          \
+    } while (0)
 #endif
 
 #ifdef __cplusplus
@@ -35,6 +35,14 @@ int utils_getpid(void) { return GetCurrentProcessId(); }
 
 int utils_gettid(void) { return GetCurrentThreadId(); }
 
+unsigned utils_get_current_cpu(void) { return GetCurrentProcessorNumber(); }
+
+unsigned utils_get_num_cpus(void) {
+    SYSTEM_INFO SystemInfo;
+    GetSystemInfo(&SystemInfo);
+    return SystemInfo.dwNumberOfProcessors;
+}
+
 int utils_close_fd(int fd) {
     (void)fd; // unused
     return -1;
@@ -40,6 +40,26 @@ int util_mutex_unlock(os_mutex_t *mutex) {
     return 0;
 }
 
+static DWORD WINAPI thread_start(LPVOID arg) {
+    os_thread_t *thread = (os_thread_t *)arg;
+    thread->func(thread->arg);
+    return 0;
+}
+
+int util_thread_create(os_thread_t *thread, void (*func)(void *arg),
+                       void *arg) {
+    thread->func = func;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, thread_start, thread, 0, NULL);
+    return (thread->handle == NULL) ? -1 : 0;
+}
+
+int util_thread_join(os_thread_t *thread) {
+    DWORD ret = WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    return (ret == WAIT_OBJECT_0) ? 0 : -1;
+}
+
 static BOOL CALLBACK initOnceCb(PINIT_ONCE InitOnce, PVOID Parameter,
                                 PVOID *lpContext) {
     (void)InitOnce;  // unused
@@ -12,6 +12,10 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <sstream>
+#include <string>
+
 namespace umf_test {
 
 #define NOEXCEPT_COND(cond, val, expected_val)                                                                   \
@@ -32,6 +36,36 @@ struct test : ::testing::Test {
     void TearDown() override { ::testing::Test::TearDown(); }
 };
 
+// Returns whether the mapping containing the given address has the given
+// flag in the VmFlags field of /proc/self/smaps
+inline bool has_vm_flag(void *ptr, const std::string &flag) {
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool in_mapping = false;
+    while (std::getline(smaps, line)) {
+        uintptr_t start, end;
+        char dash;
+        std::istringstream header(line);
+        if (header >> std::hex >> start >> dash >> end && dash == '-') {
+            in_mapping = (uintptr_t)ptr >= start && (uintptr_t)ptr < end;
+            continue;
+        }
+
+        if (in_mapping && line.rfind("VmFlags:", 0) == 0) {
+            std::istringstream flags(line.substr(8));
+            std::string f;
+            while (flags >> f) {
+                if (f == flag) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    return false;
+}
+
 template <typename T> T generateArg() { return T{}; }
 
 // returns Ret (*f)(void) that calls the original function
@@ -89,6 +89,13 @@ static umf_result_t traceGetLastStatus(void *pool) {
     return umfPoolGetLastAllocationError(trace_pool->params.hUpstreamPool);
 }
 
+static umf_result_t traceTrim(void *pool, size_t size, size_t *released) {
+    trace_pool_t *trace_pool = (trace_pool_t *)pool;
+
+    trace_pool->params.trace_handler(trace_pool->params.trace_context, "trim");
+    return umfPoolTrim(trace_pool->params.hUpstreamPool, size, released);
+}
+
 umf_memory_pool_ops_t UMF_TRACE_POOL_OPS = {
     .version = UMF_VERSION_CURRENT,
     .initialize = traceInitialize,
@@ -100,4 +107,5 @@ umf_memory_pool_ops_t UMF_TRACE_POOL_OPS = {
     .malloc_usable_size = traceMallocUsableSize,
     .free = traceFree,
     .get_last_allocation_error = traceGetLastStatus,
+    .trim = traceTrim,
 };
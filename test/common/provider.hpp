@@ -71,6 +71,14 @@ typedef struct provider_base_t {
                                   [[maybe_unused]] size_t firstSize) {
         return UMF_RESULT_ERROR_UNKNOWN;
     }
+    umf_result_t commit([[maybe_unused]] void *ptr,
+                        [[maybe_unused]] size_t size) noexcept {
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+    umf_result_t decommit([[maybe_unused]] void *ptr,
+                          [[maybe_unused]] size_t size) noexcept {
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
     umf_result_t get_ipc_handle_size([[maybe_unused]] size_t *size) noexcept {
         return UMF_RESULT_ERROR_UNKNOWN;
     }
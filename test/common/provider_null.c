@@ -75,6 +75,20 @@ static umf_result_t nullPurgeForce(void *provider, void *ptr, size_t size) {
     return UMF_RESULT_SUCCESS;
 }
 
+static umf_result_t nullCommit(void *provider, void *ptr, size_t size) {
+    (void)provider;
+    (void)ptr;
+    (void)size;
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t nullDecommit(void *provider, void *ptr, size_t size) {
+    (void)provider;
+    (void)ptr;
+    (void)size;
+    return UMF_RESULT_SUCCESS;
+}
+
 static umf_result_t nullAllocationMerge(void *provider, void *lowPtr,
                                         void *highPtr, size_t totalSize) {
     (void)provider;
@@ -143,6 +157,8 @@ umf_memory_provider_ops_t UMF_NULL_PROVIDER_OPS = {
     .ext.purge_force = nullPurgeForce,
     .ext.allocation_merge = nullAllocationMerge,
     .ext.allocation_split = nullAllocationSplit,
+    .ext.commit = nullCommit,
+    .ext.decommit = nullDecommit,
     .ipc.get_ipc_handle_size = nullGetIpcHandleSize,
     .ipc.get_ipc_handle = nullGetIpcHandle,
     .ipc.put_ipc_handle = nullPutIpcHandle,
@@ -47,6 +47,18 @@ static umf_result_t traceAlloc(void *provider, size_t size, size_t alignment,
                                   alignment, ptr);
 }
 
+static umf_result_t traceAllocWithZeroInfo(void *provider, size_t size,
+                                           size_t alignment, void **ptr,
+                                           int *zeroed) {
+    umf_provider_trace_params_t *traceProvider =
+        (umf_provider_trace_params_t *)provider;
+
+    traceProvider->trace_handler(traceProvider->trace_context,
+                                 "alloc_with_zero_info");
+    return umfMemoryProviderAllocWithZeroInfo(
+        traceProvider->hUpstreamProvider, size, alignment, ptr, zeroed);
+}
+
 static umf_result_t traceFree(void *provider, void *ptr, size_t size) {
     umf_provider_trace_params_t *traceProvider =
         (umf_provider_trace_params_t *)provider;
@@ -115,6 +127,24 @@ static umf_result_t tracePurgeForce(void *provider, void *ptr, size_t size) {
                                        size);
 }
 
+static umf_result_t traceCommit(void *provider, void *ptr, size_t size) {
+    umf_provider_trace_params_t *traceProvider =
+        (umf_provider_trace_params_t *)provider;
+
+    traceProvider->trace_handler(traceProvider->trace_context, "commit");
+    return umfMemoryProviderCommit(traceProvider->hUpstreamProvider, ptr,
+                                   size);
+}
+
+static umf_result_t traceDecommit(void *provider, void *ptr, size_t size) {
+    umf_provider_trace_params_t *traceProvider =
+        (umf_provider_trace_params_t *)provider;
+
+    traceProvider->trace_handler(traceProvider->trace_context, "decommit");
+    return umfMemoryProviderDecommit(traceProvider->hUpstreamProvider, ptr,
+                                     size);
+}
+
 static umf_result_t traceAllocationMerge(void *provider, void *lowPtr,
                                          void *highPtr, size_t totalSize) {
     umf_provider_trace_params_t *traceProvider =
@@ -204,6 +234,9 @@ umf_memory_provider_ops_t UMF_TRACE_PROVIDER_OPS = {
     .ext.purge_force = tracePurgeForce,
     .ext.allocation_merge = traceAllocationMerge,
     .ext.allocation_split = traceAllocationSplit,
+    .ext.commit = traceCommit,
+    .ext.decommit = traceDecommit,
+    .ext.alloc_with_zero_info = traceAllocWithZeroInfo,
     .ipc.get_ipc_handle_size = traceGetIpcHandleSize,
     .ipc.get_ipc_handle = traceGetIpcHandle,
     .ipc.put_ipc_handle = tracePutIpcHandle,
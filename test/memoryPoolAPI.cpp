@@ -89,10 +89,20 @@ TEST_P(umfPoolWithCreateFlagsTest, memoryPoolTrace) {
     ASSERT_EQ(providerCalls["free"], 1);
     ASSERT_EQ(providerCalls.size(), ++provider_call_count);
 
+    // an empty calloc() does not reach the provider
     umfPoolCalloc(tracingPool.get(), 0, 0);
     ASSERT_EQ(poolCalls["calloc"], 1);
     ASSERT_EQ(poolCalls.size(), ++pool_call_count);
 
+    ASSERT_EQ(providerCalls.size(), provider_call_count);
+
+    umfPoolCalloc(tracingPool.get(), 1, 1);
+    ASSERT_EQ(poolCalls["calloc"], 2);
+    ASSERT_EQ(poolCalls.size(), pool_call_count);
+
+    ASSERT_EQ(providerCalls["alloc_with_zero_info"], 1);
+    ASSERT_EQ(providerCalls.size(), ++provider_call_count);
+
     umfPoolRealloc(tracingPool.get(), nullptr, 0);
     ASSERT_EQ(poolCalls["realloc"], 1);
     ASSERT_EQ(poolCalls.size(), ++pool_call_count);
@@ -109,6 +119,15 @@ TEST_P(umfPoolWithCreateFlagsTest, memoryPoolTrace) {
     ASSERT_EQ(poolCalls["get_last_native_error"], 1);
     ASSERT_EQ(poolCalls.size(), ++pool_call_count);
 
+    size_t released = 1;
+    ret = umfPoolTrim(tracingPool.get(), 0, &released);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(released, 0);
+    ASSERT_EQ(poolCalls["trim"], 1);
+    ASSERT_EQ(poolCalls.size(), ++pool_call_count);
+
+    ASSERT_EQ(providerCalls.size(), provider_call_count);
+
     if (manuallyDestroyProvider) {
         umfMemoryProviderDestroy(provider);
     }
@@ -139,7 +158,8 @@ TEST_P(umfPoolWithCreateFlagsTest, memoryPoolWithCustomProvider) {
 }
 
 TEST_F(test, retrieveMemoryProvider) {
-    umf_memory_provider_handle_t provider = (umf_memory_provider_handle_t)0x1;
+    auto nullProvider = umf_test::wrapProviderUnique(nullProviderCreate());
+    umf_memory_provider_handle_t provider = nullProvider.get();
 
     auto pool =
         wrapPoolUnique(createPoolChecked(umfProxyPoolOps(), provider, nullptr));
@@ -177,6 +197,161 @@ TEST_F(test, BasicPoolByPtrTest) {
     ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
 }
 
+// A provider handing out a single region of address space that is never
+// accessed, so it does not have to be backed by any memory.
+struct provider_fake_region : public provider_base_t {
+    // above the usual mmap and heap addresses of 64-bit Linux and Windows
+    static constexpr uintptr_t BASE = (uintptr_t)0x400000000000 - 4096;
+
+    umf_result_t alloc(size_t, size_t, void **ptr) noexcept {
+        *ptr = (void *)BASE;
+        return UMF_RESULT_SUCCESS;
+    }
+    umf_result_t free(void *, size_t) noexcept { return UMF_RESULT_SUCCESS; }
+    const char *get_name() noexcept { return "fake_region"; }
+};
+
+umf_memory_provider_ops_t FAKE_REGION_PROVIDER_OPS =
+    umf::providerMakeCOps<provider_fake_region, void>();
+
+// Looks up the pool in a new thread, so that the per-thread cache of
+// the memory tracker is empty and the region is looked up in the shards.
+static umf_memory_pool_handle_t poolByPtrUncached(void *ptr) {
+    umf_memory_pool_handle_t hPool = nullptr;
+    std::thread([&] { hPool = umfPoolByPtr(ptr); }).join();
+    return hPool;
+}
+
+TEST_F(test, PoolByPtrLargeRegionTest) {
+    // much larger than all shards of the memory tracker together (8 chunks
+    // of 2 MiB), so the region covers address chunks of every shard
+    // and starts just below a chunk boundary
+    constexpr size_t SIZE = 16ull * 1024 * 1024 * 1024;
+    constexpr size_t STEP = 256ull * 1024 * 1024;
+
+    umf_memory_provider_handle_t provider;
+    umf_result_t ret =
+        umfMemoryProviderCreate(&FAKE_REGION_PROVIDER_OPS, NULL, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto pool =
+        wrapPoolUnique(createPoolChecked(umfProxyPoolOps(), provider, nullptr,
+                                         UMF_POOL_CREATE_FLAG_OWN_PROVIDER));
+    auto expected_pool = pool.get();
+    char *ptr = (char *)umfPoolMalloc(expected_pool, SIZE);
+    ASSERT_EQ((uintptr_t)ptr, provider_fake_region::BASE);
+
+    for (size_t offset = 0; offset < SIZE; offset += STEP) {
+        ASSERT_EQ(poolByPtrUncached(ptr + offset), expected_pool);
+    }
+
+    EXPECT_EQ(poolByPtrUncached(ptr + 4096), expected_pool);
+    EXPECT_EQ(poolByPtrUncached(ptr + SIZE - 1), expected_pool);
+    EXPECT_EQ(poolByPtrUncached(ptr + SIZE), nullptr);
+    EXPECT_EQ(poolByPtrUncached(ptr - 1), nullptr);
+
+    // the same lookups served by the per-thread cache
+    EXPECT_EQ(umfPoolByPtr(ptr + SIZE / 2), expected_pool);
+    EXPECT_EQ(umfPoolByPtr(ptr + SIZE - 1), expected_pool);
+
+    ret = umfFree(ptr);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    EXPECT_EQ(umfPoolByPtr(ptr), nullptr);
+    EXPECT_EQ(umfPoolByPtr(ptr + SIZE / 2), nullptr);
+    EXPECT_EQ(poolByPtrUncached(ptr + SIZE / 2), nullptr);
+}
+
+// The proxy pool supports calloc() only with a provider reporting whether
+// the allocated memory is zero-filled, others are not even called.
+TEST_F(test, proxyPoolCallocWithoutZeroInfo) {
+    static size_t numAllocs;
+    struct provider : public provider_malloc {
+        umf_result_t alloc(size_t size, size_t align, void **ptr) noexcept {
+            numAllocs++;
+            return provider_malloc::alloc(size, align, ptr);
+        }
+    };
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<provider, void>();
+
+    numAllocs = 0;
+    umf_memory_provider_handle_t hProvider;
+    umf_result_t ret = umfMemoryProviderCreate(&provider_ops, NULL, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto pool =
+        wrapPoolUnique(createPoolChecked(umfProxyPoolOps(), hProvider, nullptr,
+                                         UMF_POOL_CREATE_FLAG_OWN_PROVIDER));
+
+    EXPECT_EQ(umfPoolCalloc(pool.get(), 2, 64), nullptr);
+    EXPECT_EQ(umfPoolGetLastAllocationError(pool.get()),
+              UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    EXPECT_EQ(umfPoolCalloc(pool.get(), SIZE_MAX, 2), nullptr);
+    EXPECT_EQ(umfPoolGetLastAllocationError(pool.get()),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    EXPECT_EQ(umfPoolCalloc(pool.get(), 0, 64), nullptr);
+    EXPECT_EQ(umfPoolGetLastAllocationError(pool.get()), UMF_RESULT_SUCCESS);
+
+    EXPECT_EQ(numAllocs, 0u);
+}
+
+// The pool (through its tracking provider) can (de)commit only the memory
+// allocated from its provider.
+TEST_F(test, CommitRangeNotOwnedByPool) {
+    constexpr size_t SIZE = 16 * 4096;
+
+    struct provider : public provider_fake_region {
+        umf_result_t commit(void *, size_t) noexcept {
+            return UMF_RESULT_SUCCESS;
+        }
+        umf_result_t decommit(void *, size_t) noexcept {
+            return UMF_RESULT_SUCCESS;
+        }
+    };
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<provider, void>();
+
+    static umf_memory_provider_handle_t poolProvider;
+    struct pool : public umf_test::pool_base_t {
+        umf_result_t
+        initialize(umf_memory_provider_handle_t provider) noexcept {
+            poolProvider = provider;
+            return UMF_RESULT_SUCCESS;
+        }
+    };
+    umf_memory_pool_ops_t pool_ops = umf::poolMakeCOps<pool, void>();
+
+    umf_memory_provider_handle_t hProvider;
+    umf_result_t ret = umfMemoryProviderCreate(&provider_ops, NULL, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto pool = wrapPoolUnique(createPoolChecked(
+        &pool_ops, hProvider, nullptr, UMF_POOL_CREATE_FLAG_OWN_PROVIDER));
+
+    void *ptr = nullptr;
+    ret = umfMemoryProviderAlloc(poolProvider, SIZE, 0, &ptr);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    char *base = (char *)ptr;
+
+    EXPECT_EQ(umfMemoryProviderDecommit(poolProvider, base, SIZE),
+              UMF_RESULT_SUCCESS);
+    EXPECT_EQ(umfMemoryProviderCommit(poolProvider, base + 4096, 4096),
+              UMF_RESULT_SUCCESS);
+
+    EXPECT_EQ(umfMemoryProviderDecommit(poolProvider, base, 2 * SIZE),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(umfMemoryProviderCommit(poolProvider, base - 4096, 4096),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(umfMemoryProviderCommit(poolProvider, base + SIZE, 4096),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ret = umfMemoryProviderFree(poolProvider, ptr, SIZE);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    EXPECT_EQ(umfMemoryProviderDecommit(poolProvider, base, SIZE),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     mallocPoolTest, umfPoolTest,
     ::testing::Values(poolCreateExtParams{&MALLOC_POOL_OPS, nullptr,
@@ -193,8 +368,50 @@ INSTANTIATE_TEST_SUITE_P(umfPoolWithCreateFlagsTest, umfPoolWithCreateFlagsTest,
                          ::testing::Values(0,
                                            UMF_POOL_CREATE_FLAG_OWN_PROVIDER));
 
+// The trim op was added in the version 0.10 of the ops.
+TEST_F(test, poolOpsVersion0_9) {
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t ret =
+        umfMemoryProviderCreate(&UMF_NULL_PROVIDER_OPS, nullptr, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    umf_memory_pool_ops_t ops = *umfProxyPoolOps();
+    ops.version = UMF_MAKE_VERSION(0, 9);
+    umf_memory_pool_handle_t pool = nullptr;
+    ret = umfPoolCreate(&ops, provider, nullptr, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    size_t released = 1;
+    ret = umfPoolTrim(pool, 0, &released);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(released, 0);
+
+    umfPoolDestroy(pool);
+    umfMemoryProviderDestroy(provider);
+}
+
 ////////////////// Negative test cases /////////////////
 
+TEST_F(test, poolOpsUnsupportedVersion) {
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t ret =
+        umfMemoryProviderCreate(&UMF_NULL_PROVIDER_OPS, nullptr, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    umf_memory_pool_ops_t ops = *umfProxyPoolOps();
+    umf_memory_pool_handle_t pool = nullptr;
+
+    ops.version = UMF_MAKE_VERSION(0, 8);
+    ret = umfPoolCreate(&ops, provider, nullptr, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ops.version = UMF_VERSION_CURRENT + 1;
+    ret = umfPoolCreate(&ops, provider, nullptr, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umfMemoryProviderDestroy(provider);
+}
+
 TEST_P(umfPoolWithCreateFlagsTest, umfPoolCreateFlagsNullOps) {
     umf_memory_provider_handle_t provider = nullptr;
     umf_result_t ret =
@@ -258,7 +475,8 @@ TEST_P(poolInitializeTest, errorPropagation) {
 }
 
 TEST_F(test, retrieveMemoryProvidersError) {
-    umf_memory_provider_handle_t provider = (umf_memory_provider_handle_t)0x1;
+    auto nullProvider = umf_test::wrapProviderUnique(nullProviderCreate());
+    umf_memory_provider_handle_t provider = nullProvider.get();
 
     auto pool =
         wrapPoolUnique(createPoolChecked(umfProxyPoolOps(), provider, nullptr));
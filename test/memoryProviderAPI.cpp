@@ -7,9 +7,12 @@
 #include "provider_null.h"
 #include "test_helpers.h"
 
+#include <cstddef>
+#include <cstring>
 #include <string>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 using umf_test::test;
 
@@ -70,6 +73,26 @@ TEST_F(test, memoryProviderTrace) {
     ASSERT_EQ(calls["purge_force"], 1);
     ASSERT_EQ(calls.size(), ++call_count);
 
+    ret = umfMemoryProviderDecommit(tracingProvider.get(), nullptr, 0);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(calls["decommit"], 1);
+    ASSERT_EQ(calls.size(), ++call_count);
+
+    ret = umfMemoryProviderCommit(tracingProvider.get(), nullptr, 0);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(calls["commit"], 1);
+    ASSERT_EQ(calls.size(), ++call_count);
+
+    // the null provider does not report zero-filled memory,
+    // so the call falls back to alloc()
+    int zeroed = 1;
+    ret = umfMemoryProviderAllocWithZeroInfo(tracingProvider.get(), 0, 0, &ptr,
+                                             &zeroed);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(zeroed, 0);
+    ASSERT_EQ(calls["alloc_with_zero_info"], 1);
+    ASSERT_EQ(calls.size(), ++call_count);
+
     void *lowPtr = (void *)0xBAD;
     void *highPtr = (void *)((uintptr_t)lowPtr + 4096);
     ret = umfMemoryProviderAllocationMerge(tracingProvider.get(), lowPtr,
@@ -112,6 +135,23 @@ TEST_F(test, memoryProviderOpsNullPurgeForceField) {
     umfMemoryProviderDestroy(hProvider);
 }
 
+TEST_F(test, memoryProviderOpsNullCommitDecommitFields) {
+    umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
+    provider_ops.ext.commit = nullptr;
+    provider_ops.ext.decommit = nullptr;
+    umf_memory_provider_handle_t hProvider;
+    auto ret = umfMemoryProviderCreate(&provider_ops, nullptr, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfMemoryProviderCommit(hProvider, nullptr, 0);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    ret = umfMemoryProviderDecommit(hProvider, nullptr, 0);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    umfMemoryProviderDestroy(hProvider);
+}
+
 TEST_F(test, memoryProviderOpsNullAllocationSplitAllocationMergeFields) {
     umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
     provider_ops.ext.allocation_split = nullptr;
@@ -133,8 +173,52 @@ TEST_F(test, memoryProviderOpsNullAllocationSplitAllocationMergeFields) {
     umfMemoryProviderDestroy(hProvider);
 }
 
+// The ext ops of the version 0.9 ended with allocation_split,
+// so the IPC ops directly followed it.
+TEST_F(test, memoryProviderOpsVersion0_9) {
+    umf_memory_provider_ops_t ops = UMF_NULL_PROVIDER_OPS;
+    ops.version = UMF_MAKE_VERSION(0, 9);
+
+    size_t extOffset = offsetof(umf_memory_provider_ops_t, ext);
+    size_t oldExtSize = offsetof(umf_memory_provider_ext_ops_t, commit);
+    std::vector<umf_memory_provider_ops_t> oldOps(1);
+    memset(oldOps.data(), 0, sizeof(ops));
+    memcpy(oldOps.data(), &ops, extOffset + oldExtSize);
+    memcpy((char *)oldOps.data() + extOffset + oldExtSize, &ops.ipc,
+           sizeof(ops.ipc));
+
+    umf_memory_provider_handle_t hProvider;
+    auto ret = umfMemoryProviderCreate(oldOps.data(), nullptr, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // the ops added in the version 0.10 are not supported
+    ret = umfMemoryProviderCommit(hProvider, nullptr, 0);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ret = umfMemoryProviderDecommit(hProvider, nullptr, 0);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    size_t size = 0;
+    ret = umfMemoryProviderGetIPCHandleSize(hProvider, &size);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    umfMemoryProviderDestroy(hProvider);
+}
+
 ////////////////// Negative test cases /////////////////
 
+TEST_F(test, memoryProviderOpsUnsupportedVersion) {
+    umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
+    umf_memory_provider_handle_t hProvider;
+
+    provider_ops.version = UMF_MAKE_VERSION(0, 8);
+    auto ret = umfMemoryProviderCreate(&provider_ops, nullptr, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    provider_ops.version = UMF_VERSION_CURRENT + 1;
+    ret = umfMemoryProviderCreate(&provider_ops, nullptr, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
 TEST_F(test, memoryProviderCreateNullOps) {
     umf_memory_provider_handle_t hProvider;
     auto ret = umfMemoryProviderCreate(nullptr, nullptr, &hProvider);
@@ -310,4 +394,7 @@ INSTANTIATE_TEST_SUITE_P(
         umf_test::withGeneratedArgs(umfMemoryProviderGetMinPageSize),
         umf_test::withGeneratedArgs(umfMemoryProviderPurgeLazy),
         umf_test::withGeneratedArgs(umfMemoryProviderPurgeForce),
+        umf_test::withGeneratedArgs(umfMemoryProviderCommit),
+        umf_test::withGeneratedArgs(umfMemoryProviderDecommit),
+        umf_test::withGeneratedArgs(umfMemoryProviderAllocWithZeroInfo),
         umf_test::withGeneratedArgs(umfMemoryProviderGetName)));
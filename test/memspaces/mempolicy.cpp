@@ -4,8 +4,12 @@
 
 #include "memory_provider_internal.h"
 #include "memspace_helpers.hpp"
+#include "numa_helpers.h"
 #include "provider_os_memory_internal.h"
 
+#include <algorithm>
+#include <unistd.h>
+
 os_memory_provider_t *providerGetPriv(umf_memory_provider_handle_t hProvider) {
     // hack to have access to fields in structure defined in memory_provider.c
     struct umf_memory_provider_t {
@@ -89,7 +93,8 @@ TEST_F(test, mempolicyDefaultInterleave) {
 }
 
 TEST_F(test, mempolicyInterleavePartSize) {
-    const size_t part_size = 100;
+    // the parts bigger than a page are interleaved manually
+    const size_t part_size = 4 * sysconf(_SC_PAGE_SIZE) + 100;
     umf_memory_provider_handle_t hProvider = nullptr;
     umf_mempolicy_handle_t hPolicy = nullptr;
 
@@ -116,6 +121,70 @@ TEST_F(test, mempolicyInterleavePartSize) {
     umfMemoryProviderDestroy(hProvider);
 }
 
+TEST_F(test, mempolicyInterleavePageSizePartSize) {
+    // the parts of a page are interleaved by the kernel
+    const size_t part_size = 100;
+    umf_memory_provider_handle_t hProvider = nullptr;
+    umf_mempolicy_handle_t hPolicy = nullptr;
+
+    umf_result_t ret = umfMempolicyCreate(UMF_MEMPOLICY_INTERLEAVE, &hPolicy);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ret = umfMempolicySetInterleavePartSize(hPolicy, part_size);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfMemoryProviderCreateFromMemspace(umfMemspaceHostAllGet(), hPolicy,
+                                              &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_NE(hProvider, nullptr);
+    ret = umfMempolicyDestroy(hPolicy);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    os_memory_provider_t *ProviderInternal =
+        (os_memory_provider_t *)providerGetPriv(hProvider);
+    ASSERT_NE(ProviderInternal, nullptr);
+    EXPECT_EQ(ProviderInternal->numa_policy, HWLOC_MEMBIND_INTERLEAVE);
+    EXPECT_EQ(ProviderInternal->numa_flags, HWLOC_MEMBIND_BYNODESET);
+    EXPECT_EQ(ProviderInternal->nodeset_len, 1u);
+    EXPECT_EQ(ProviderInternal->part_size, part_size);
+    EXPECT_EQ(ProviderInternal->mode, UMF_NUMA_MODE_INTERLEAVE);
+
+    constexpr size_t pages_num = 1024;
+    const size_t page_size = sysconf(_SC_PAGE_SIZE);
+    void *ptr = nullptr;
+    ret = umfMemoryProviderAlloc(hProvider, pages_num * page_size, 0, &ptr);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xFF, pages_num * page_size);
+
+    // the whole range has the kernel's interleave policy and it cannot use
+    // transparent huge pages, which would not be interleaved page by page
+    int mode = -1;
+    ASSERT_EQ(get_mempolicy(&mode, nullptr, 0, ptr, MPOL_F_ADDR), 0);
+    EXPECT_EQ(mode, MPOL_INTERLEAVE);
+    EXPECT_TRUE(umf_test::has_vm_flag(ptr, "nh"));
+
+    // each next page is on the next node (in ascending order), the kernel
+    // selects the node of the first page by its offset
+    std::vector<int> nodes;
+    for (int node = 0; node <= numa_max_node(); node++) {
+        if (numa_bitmask_isbitset(numa_all_nodes_ptr, node)) {
+            nodes.push_back(node);
+        }
+    }
+
+    auto it = std::find(nodes.begin(), nodes.end(), getNumaNodeByPtr(ptr));
+    ASSERT_NE(it, nodes.end());
+    size_t index = it - nodes.begin();
+    for (size_t i = 1; i < pages_num; i++) {
+        index = (index + 1) % nodes.size();
+        ASSERT_EQ(nodes[index], getNumaNodeByPtr((char *)ptr + i * page_size));
+    }
+
+    ret = umfMemoryProviderFree(hProvider, ptr, pages_num * page_size);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    umfMemoryProviderDestroy(hProvider);
+}
+
 TEST_F(test, mempolicyDefaultSplit) {
     umf_memory_provider_handle_t hProvider = nullptr;
     umf_mempolicy_handle_t hPolicy = nullptr;
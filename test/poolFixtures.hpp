@@ -14,6 +14,7 @@
 #include <random>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "../malloc_compliance_tests.hpp"
 
@@ -168,6 +169,43 @@ TEST_P(umfPoolTest, pow2AlignedAlloc) {
 #endif
 }
 
+TEST_P(umfPoolTest, trim) {
+    static constexpr size_t numAllocs = 64;
+    std::vector<void *> allocs;
+    for (size_t i = 0; i < numAllocs; i++) {
+        allocs.push_back(umfPoolMalloc(pool.get(), (i + 1) * 64));
+        ASSERT_NE(allocs.back(), nullptr);
+    }
+
+    // release every other allocation, so that the pool has free memory
+    for (size_t i = 0; i < numAllocs; i += 2) {
+        ASSERT_EQ(umfPoolFree(pool.get(), allocs[i]), UMF_RESULT_SUCCESS);
+        allocs[i] = nullptr;
+    }
+
+    auto ret = umfPoolTrim(pool.get(), 0, nullptr);
+    if (ret == UMF_RESULT_ERROR_NOT_SUPPORTED) {
+        for (auto *ptr : allocs) {
+            umfPoolFree(pool.get(), ptr);
+        }
+        GTEST_SKIP();
+    }
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // the live allocations are not affected
+    for (auto *ptr : allocs) {
+        if (ptr) {
+            ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+        }
+    }
+
+    // everything is free now
+    size_t released = 0;
+    ASSERT_EQ(umfPoolTrim(pool.get(), 0, &released), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfPoolTrim(pool.get(), 0, &released), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(released, 0);
+}
+
 TEST_P(umfPoolTest, freeNullptr) {
     void *ptr = nullptr;
     auto ret = umfPoolFree(pool.get(), ptr);
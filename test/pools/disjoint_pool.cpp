@@ -2,7 +2,13 @@
 // Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+
 #include "pool.hpp"
+#include "pool/pool_disjoint_internal.h"
 #include "poolFixtures.hpp"
 #include "pool_disjoint.h"
 #include "provider.hpp"
@@ -144,12 +150,610 @@ TEST_F(test, sharedLimits) {
     EXPECT_EQ(MaxSize / SlabMinSize * 2, numFrees);
 }
 
+TEST_F(test, threadCacheFlush) {
+    static std::atomic<size_t> numAllocs = 0;
+    static std::atomic<size_t> numFrees = 0;
+
+    struct memory_provider : public umf_test::provider_base_t {
+        umf_result_t alloc(size_t size, size_t, void **ptr) noexcept {
+            *ptr = malloc(size);
+            numAllocs++;
+            return UMF_RESULT_SUCCESS;
+        }
+        umf_result_t free(void *ptr, [[maybe_unused]] size_t size) noexcept {
+            ::free(ptr);
+            numFrees++;
+            return UMF_RESULT_SUCCESS;
+        }
+    };
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<memory_provider, void>();
+
+    static constexpr size_t SlabMinSize = 4096;
+    static constexpr size_t AllocSize = 64;
+    static constexpr size_t NumAllocs = 10 * SlabMinSize / AllocSize;
+
+    auto config = poolConfig();
+    config.SlabMinSize = SlabMinSize;
+    config.ThreadCacheSize = 32;
+
+    auto provider =
+        wrapProviderUnique(createProviderChecked(&provider_ops, nullptr));
+
+    auto allocFree = [](umf_memory_pool_handle_t pool) {
+        std::vector<void *> ptrs;
+        for (size_t i = 0; i < NumAllocs; i++) {
+            ptrs.push_back(umfPoolMalloc(pool, AllocSize));
+            ASSERT_NE(ptrs.back(), nullptr);
+        }
+        for (auto ptr : ptrs) {
+            ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+        }
+    };
+
+    // the cache is flushed when the thread exits
+    umf_memory_pool_handle_t pool = nullptr;
+    auto ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                             (void *)&config, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    std::thread(allocFree, pool).join();
+
+    // only the single slab kept in the pool is still allocated
+    EXPECT_EQ(numAllocs - numFrees, 1);
+
+    umfPoolDestroy(pool);
+    EXPECT_EQ(numAllocs, numFrees);
+
+    // the cache of a still running thread is flushed when the pool
+    // is destroyed
+    ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(), (void *)&config,
+                        0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool filled = false;
+    bool destroyed = false;
+
+    std::thread thread([&] {
+        allocFree(pool);
+
+        std::unique_lock<std::mutex> lock(mtx);
+        filled = true;
+        cv.notify_one();
+        cv.wait(lock, [&] { return destroyed; });
+        lock.unlock();
+
+        // another pool at (possibly) the same address must not reuse
+        // the flushed cache
+        umf_memory_pool_handle_t pool2 = nullptr;
+        ASSERT_EQ(umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                                (void *)&config, 0, &pool2),
+                  UMF_RESULT_SUCCESS);
+        allocFree(pool2);
+        umfPoolDestroy(pool2);
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&] { return filled; });
+
+        // the thread still caches some chunks
+        EXPECT_GT(numAllocs - numFrees, 1);
+
+        umfPoolDestroy(pool);
+        EXPECT_EQ(numAllocs, numFrees);
+        destroyed = true;
+    }
+    cv.notify_one();
+    thread.join();
+
+    EXPECT_EQ(numAllocs, numFrees);
+}
+
+TEST_F(test, freeAlignedFromLargeSlab) {
+    static std::set<void *> allocated;
+
+    struct memory_provider : public umf_test::provider_malloc {
+        umf_result_t alloc(size_t size, size_t align, void **ptr) noexcept {
+            umf_result_t ret = provider_malloc::alloc(size, align, ptr);
+            if (ret == UMF_RESULT_SUCCESS) {
+                allocated.insert(*ptr);
+            }
+            return ret;
+        }
+        umf_result_t free(void *ptr, size_t size) noexcept {
+            // reject pointers the provider did not return
+            if (allocated.erase(ptr) == 0) {
+                return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+            }
+            return provider_malloc::free(ptr, size);
+        }
+    };
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<memory_provider, void>();
+
+    static constexpr size_t SlabMinSize = 4096;
+    static constexpr size_t Alignment = 8 * SlabMinSize;
+    static constexpr size_t NumAllocs = 16;
+
+    // aligned allocations bigger than SlabMinSize are served
+    // from whole slabs of the aligned buckets
+    auto config = poolConfig();
+    config.SlabMinSize = SlabMinSize;
+    config.MaxPoolableSize = 2 * Alignment;
+
+    auto provider =
+        wrapProviderUnique(createProviderChecked(&provider_ops, nullptr));
+
+    umf_memory_pool_handle_t pool = nullptr;
+    auto ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                             (void *)&config, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto poolHandle = umf_test::wrapPoolUnique(pool);
+
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < NumAllocs; i++) {
+        void *ptr = umfPoolAlignedMalloc(pool, 8, Alignment);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ((uintptr_t)ptr % Alignment, 0);
+        ptrs.push_back(ptr);
+    }
+
+    for (auto ptr : ptrs) {
+        EXPECT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+    }
+
+    poolHandle.reset();
+    EXPECT_TRUE(allocated.empty());
+}
+
+TEST_F(test, alignedSlabs) {
+    static std::vector<std::pair<size_t, size_t>> providerAllocs;
+
+    struct memory_provider : public umf_test::provider_malloc {
+        umf_result_t alloc(size_t size, size_t align, void **ptr) noexcept {
+            providerAllocs.emplace_back(size, align);
+            return provider_malloc::alloc(size, align, ptr);
+        }
+    };
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<memory_provider, void>();
+
+    static constexpr size_t SlabMinSize = 64 * 1024;
+    static constexpr size_t MB = 1024 * 1024;
+
+    auto config = poolConfig();
+    config.SlabMinSize = SlabMinSize;
+    config.MaxPoolableSize = 4 * MB;
+
+    auto provider =
+        wrapProviderUnique(createProviderChecked(&provider_ops, nullptr));
+
+    umf_memory_pool_handle_t pool = nullptr;
+    auto ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                             (void *)&config, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto poolHandle = umf_test::wrapPoolUnique(pool);
+
+    // a whole-slab allocation is not padded to fit the alignment
+    void *ptr = umfPoolAlignedMalloc(pool, MB, 2 * MB);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ((uintptr_t)ptr % (2 * MB), 0);
+    ASSERT_EQ(providerAllocs.size(), 1);
+    EXPECT_EQ(providerAllocs[0].first, MB);
+    EXPECT_EQ(providerAllocs[0].second, 2 * MB);
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+
+    // the slab is reused from the pool
+    ptr = umfPoolAlignedMalloc(pool, MB, 2 * MB);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ((uintptr_t)ptr % (2 * MB), 0);
+    EXPECT_EQ(providerAllocs.size(), 1);
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+
+    // small aligned allocations share an aligned slab
+    providerAllocs.clear();
+    static constexpr size_t Alignment = 8 * 1024;
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < SlabMinSize / Alignment; i++) {
+        ptrs.push_back(umfPoolAlignedMalloc(pool, 100, Alignment));
+        ASSERT_NE(ptrs.back(), nullptr);
+        ASSERT_EQ((uintptr_t)ptrs.back() % Alignment, 0);
+    }
+    ASSERT_EQ(providerAllocs.size(), 1);
+    EXPECT_EQ(providerAllocs[0].first, SlabMinSize);
+    EXPECT_EQ(providerAllocs[0].second, Alignment);
+
+    for (auto p : ptrs) {
+        ASSERT_EQ(umfPoolFree(pool, p), UMF_RESULT_SUCCESS);
+    }
+}
+
+TEST_F(test, reallocInPlace) {
+    auto provider = wrapProviderUnique(
+        createProviderChecked(&MALLOC_PROVIDER_OPS, nullptr));
+
+    auto config = poolConfig();
+    umf_memory_pool_handle_t pool = nullptr;
+    auto ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                             (void *)&config, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto poolHandle = umf_test::wrapPoolUnique(pool);
+
+    // buckets are sized 64, 96, 128, ...
+    auto *ptr = static_cast<char *>(umfPoolMalloc(pool, 70));
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(umfPoolMallocUsableSize(pool, ptr), 96);
+    memset(ptr, 0xab, 70);
+
+    // the new size fits in the same bucket
+    auto *newPtr = static_cast<char *>(umfPoolRealloc(pool, ptr, 96));
+    ASSERT_EQ(newPtr, ptr);
+
+    // the new size maps to a bigger bucket
+    newPtr = static_cast<char *>(umfPoolRealloc(pool, ptr, 200));
+    ASSERT_NE(newPtr, nullptr);
+    ASSERT_EQ(umfPoolMallocUsableSize(pool, newPtr), 256);
+    for (size_t i = 0; i < 70; i++) {
+        ASSERT_EQ(newPtr[i], (char)0xab);
+    }
+
+    // shrinking to a smaller bucket moves the allocation as well
+    ptr = newPtr;
+    newPtr = static_cast<char *>(umfPoolRealloc(pool, ptr, 64));
+    ASSERT_NE(newPtr, nullptr);
+    ASSERT_EQ(umfPoolMallocUsableSize(pool, newPtr), 64);
+    for (size_t i = 0; i < 64; i++) {
+        ASSERT_EQ(newPtr[i], (char)0xab);
+    }
+
+    // allocations above MaxPoolableSize come from the provider
+    ptr = static_cast<char *>(umfPoolRealloc(pool, newPtr, 3 * 4096));
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(umfPoolMallocUsableSize(pool, ptr), 3 * 4096);
+    newPtr = static_cast<char *>(umfPoolRealloc(pool, ptr, 2 * 4096));
+    ASSERT_EQ(newPtr, ptr);
+
+    EXPECT_EQ(umfPoolRealloc(pool, newPtr, 0), nullptr);
+}
+
+static umf_disjoint_pool_bucket_stats_t
+getBucketStats(umf_memory_pool_handle_t pool, size_t size) {
+    size_t numBuckets = 0;
+    EXPECT_EQ(umfDisjointPoolGetStats(pool, nullptr, &numBuckets),
+              UMF_RESULT_SUCCESS);
+    std::vector<umf_disjoint_pool_bucket_stats_t> stats(numBuckets);
+    EXPECT_EQ(umfDisjointPoolGetStats(pool, stats.data(), &numBuckets),
+              UMF_RESULT_SUCCESS);
+    EXPECT_EQ(numBuckets, stats.size());
+
+    for (auto &bucketStats : stats) {
+        if (bucketStats.Size == size && bucketStats.Alignment == 0) {
+            return bucketStats;
+        }
+    }
+
+    ADD_FAILURE() << "no bucket of size " << size;
+    return {};
+}
+
+TEST_F(test, getStats) {
+    auto provider = wrapProviderUnique(
+        createProviderChecked(&MALLOC_PROVIDER_OPS, nullptr));
+
+    auto config = poolConfig();
+    umf_memory_pool_handle_t pool = nullptr;
+    auto ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                             (void *)&config, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto poolHandle = umf_test::wrapPoolUnique(pool);
+
+    size_t numBuckets = 0;
+    EXPECT_EQ(umfDisjointPoolGetStats(pool, nullptr, nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    numBuckets = 1;
+    EXPECT_EQ(umfDisjointPoolGetStats(pool, nullptr, &numBuckets),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // chunked bucket: the first allocation gets a new slab
+    std::vector<void *> ptrs;
+    for (int i = 0; i < 10; i++) {
+        ptrs.push_back(umfPoolMalloc(pool, 64));
+        ASSERT_NE(ptrs.back(), nullptr);
+    }
+
+    auto stats = getBucketStats(pool, 64);
+    EXPECT_EQ(stats.AllocCount, 10);
+    EXPECT_EQ(stats.ChunksAllocated, 10);
+    EXPECT_EQ(stats.SlabsInUse, 1);
+    EXPECT_EQ(stats.SlabsInPool, 0);
+    EXPECT_EQ(stats.PoolMisses, 1);
+    EXPECT_EQ(stats.PoolHits, 9);
+
+    for (auto *ptr : ptrs) {
+        ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+    }
+
+    // the empty slab is kept in the pool and reused
+    stats = getBucketStats(pool, 64);
+    EXPECT_EQ(stats.FreeCount, 10);
+    EXPECT_EQ(stats.ChunksAllocated, 0);
+    EXPECT_EQ(stats.SlabsInUse, 0);
+    EXPECT_EQ(stats.SlabsInPool, 1);
+    EXPECT_EQ(stats.PeakSlabsInUse, 1);
+
+    auto *ptr = umfPoolMalloc(pool, 64);
+    ASSERT_NE(ptr, nullptr);
+    stats = getBucketStats(pool, 64);
+    EXPECT_EQ(stats.PoolHits, 10);
+    EXPECT_EQ(stats.PoolMisses, 1);
+    EXPECT_EQ(stats.SlabsInPool, 0);
+    EXPECT_EQ(stats.PeakSlabsInPool, 1);
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+
+    // whole-slab bucket
+    for (int i = 0; i < 2; i++) {
+        ptr = umfPoolMalloc(pool, 4096);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+    }
+
+    stats = getBucketStats(pool, 4096);
+    EXPECT_EQ(stats.AllocCount, 2);
+    EXPECT_EQ(stats.FreeCount, 2);
+    EXPECT_EQ(stats.PoolMisses, 1);
+    EXPECT_EQ(stats.PoolHits, 1);
+    EXPECT_EQ(stats.ChunksAllocated, 0);
+    EXPECT_EQ(stats.SlabsInPool, 1);
+
+    // only the reported number of buckets is filled
+    umf_disjoint_pool_bucket_stats_t first{};
+    size_t totalBuckets = 0;
+    EXPECT_EQ(umfDisjointPoolGetStats(pool, nullptr, &totalBuckets),
+              UMF_RESULT_SUCCESS);
+    numBuckets = 1;
+    EXPECT_EQ(umfDisjointPoolGetStats(pool, &first, &numBuckets),
+              UMF_RESULT_SUCCESS);
+    EXPECT_EQ(numBuckets, totalBuckets);
+    EXPECT_EQ(first.Size, 64);
+}
+
+TEST_F(test, getStatsThreadCache) {
+    auto provider = wrapProviderUnique(
+        createProviderChecked(&MALLOC_PROVIDER_OPS, nullptr));
+
+    auto config = poolConfig();
+    config.ThreadCacheSize = 16;
+    umf_memory_pool_handle_t pool = nullptr;
+    auto ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                             (void *)&config, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto poolHandle = umf_test::wrapPoolUnique(pool);
+
+    void *first = nullptr;
+    std::thread([&] {
+        // the cache is refilled with half of its size
+        first = umfPoolMalloc(pool, 64);
+        ASSERT_NE(first, nullptr);
+
+        auto stats = getBucketStats(pool, 64);
+        EXPECT_EQ(stats.AllocCount, 1);
+        EXPECT_EQ(stats.PoolMisses, 1);
+        EXPECT_EQ(stats.ChunksAllocated, 8);
+
+        auto *ptr = umfPoolMalloc(pool, 64);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+
+        stats = getBucketStats(pool, 64);
+        EXPECT_EQ(stats.AllocCount, 2);
+        EXPECT_EQ(stats.PoolHits, 1);
+        EXPECT_EQ(stats.FreeCount, 1);
+    }).join();
+
+    // the counts of the exited thread are kept, its cached chunks are freed
+    auto stats = getBucketStats(pool, 64);
+    EXPECT_EQ(stats.AllocCount, 2);
+    EXPECT_EQ(stats.FreeCount, 1);
+    EXPECT_EQ(stats.PoolHits, 1);
+    EXPECT_EQ(stats.PoolMisses, 1);
+    EXPECT_EQ(stats.ChunksAllocated, 1);
+
+    ASSERT_EQ(umfPoolFree(pool, first), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, decayPooledSlabs) {
+    static std::set<void *> purged;
+    static uint64_t nowMs = 1000;
+
+    struct memory_provider : public umf_test::provider_malloc {
+        umf_result_t purge_lazy(void *ptr, size_t) noexcept {
+            purged.insert(ptr);
+            return UMF_RESULT_SUCCESS;
+        }
+    };
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<memory_provider, void>();
+
+    auto provider =
+        wrapProviderUnique(createProviderChecked(&provider_ops, nullptr));
+
+    auto config = poolConfig();
+    config.DecayMs = 200;
+    umf_memory_pool_handle_t pool = nullptr;
+    auto ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                             (void *)&config, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto poolHandle = umf_test::wrapPoolUnique(pool);
+    ASSERT_EQ(umfDisjointPoolSetClock(pool, [] { return nowMs; }),
+              UMF_RESULT_SUCCESS);
+
+    // the decay is driven by the operations on the pool,
+    // the clock is checked once per 256 operations of the pool
+    auto runOps = [&] {
+        for (int i = 0; i < 256; i++) {
+            void *ptr = umfPoolMalloc(pool, 64);
+            ASSERT_NE(ptr, nullptr);
+            ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+        }
+    };
+
+    void *slab = umfPoolMalloc(pool, 4096);
+    ASSERT_NE(slab, nullptr);
+    ASSERT_EQ(umfPoolFree(pool, slab), UMF_RESULT_SUCCESS);
+    runOps();
+    EXPECT_EQ(getBucketStats(pool, 4096).SlabsInPool, 1);
+    EXPECT_EQ(purged.count(slab), 0);
+
+    // idle for DecayMs: purged, but still pooled
+    nowMs += 200;
+    runOps();
+    EXPECT_EQ(getBucketStats(pool, 4096).SlabsInPool, 1);
+    EXPECT_EQ(purged.count(slab), 1);
+
+    // idle for twice DecayMs: returned to the provider
+    nowMs += 200;
+    runOps();
+    auto stats = getBucketStats(pool, 4096);
+    EXPECT_EQ(stats.SlabsInPool, 0);
+    EXPECT_EQ(stats.SlabsInUse, 0);
+
+    // the slab of the bucket in use is kept
+    EXPECT_EQ(getBucketStats(pool, 64).SlabsInPool, 1);
+}
+
+TEST_F(test, trim) {
+    auto provider = wrapProviderUnique(
+        createProviderChecked(&MALLOC_PROVIDER_OPS, nullptr));
+
+    auto config = poolConfig();
+    config.ThreadCacheSize = 16;
+    umf_memory_pool_handle_t pool = nullptr;
+    auto ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                             (void *)&config, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto poolHandle = umf_test::wrapPoolUnique(pool);
+
+    // whole-slab allocations, all of them are kept in the pool
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < config.Capacity; i++) {
+        ptrs.push_back(umfPoolMalloc(pool, 4096));
+        ASSERT_NE(ptrs.back(), nullptr);
+    }
+    for (auto *ptr : ptrs) {
+        ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+    }
+    ASSERT_EQ(getBucketStats(pool, 4096).SlabsInPool, config.Capacity);
+
+    // a chunk cached by this thread keeps its slab in use
+    void *chunk = umfPoolMalloc(pool, 64);
+    ASSERT_NE(chunk, nullptr);
+    ASSERT_EQ(umfPoolFree(pool, chunk), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(getBucketStats(pool, 64).SlabsInUse, 1);
+
+    // at least the requested size is released
+    size_t released = 0;
+    ret = umfPoolTrim(pool, 4096 + 1, &released);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(released, 2 * 4096);
+    ASSERT_EQ(getBucketStats(pool, 4096).SlabsInPool, config.Capacity - 2);
+
+    // the rest is released, including the slab of the cached chunk
+    ret = umfPoolTrim(pool, 0, &released);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(released, (config.Capacity - 2) * 4096 + 4096);
+
+    auto stats = getBucketStats(pool, 64);
+    EXPECT_EQ(stats.SlabsInUse, 0);
+    EXPECT_EQ(stats.SlabsInPool, 0);
+    EXPECT_EQ(getBucketStats(pool, 4096).SlabsInPool, 0);
+
+    // the pool can be used after trimming
+    chunk = umfPoolMalloc(pool, 64);
+    ASSERT_NE(chunk, nullptr);
+    ASSERT_EQ(umfPoolFree(pool, chunk), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, callocZeroedMemory) {
+    static constexpr unsigned char pattern = 0xAB;
+
+    // reports the memory as zeroed but fills it with a pattern, so the test
+    // can tell whether the pool skipped zeroing it
+    umf_memory_provider_ops_t provider_ops = MALLOC_PROVIDER_OPS;
+    provider_ops.ext.alloc_with_zero_info =
+        [](void *provider, size_t size, size_t alignment, void **ptr,
+           int *zeroed) {
+            umf_result_t ret =
+                MALLOC_PROVIDER_OPS.alloc(provider, size, alignment, ptr);
+            if (ret == UMF_RESULT_SUCCESS) {
+                memset(*ptr, pattern, size);
+                *zeroed = 1;
+            }
+            return ret;
+        };
+
+    auto provider =
+        wrapProviderUnique(createProviderChecked(&provider_ops, nullptr));
+
+    auto config = poolConfig();
+    umf_memory_pool_handle_t pool = nullptr;
+    auto ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                             (void *)&config, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto poolHandle = umf_test::wrapPoolUnique(pool);
+
+    // a fresh whole-slab allocation is not zeroed again
+    auto *ptr = static_cast<unsigned char *>(umfPoolCalloc(pool, 1, 4096));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(ptr[0], pattern);
+    EXPECT_EQ(ptr[4095], pattern);
+    memset(ptr, pattern, 4096);
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+
+    // a slab reused from the pool is zeroed
+    ptr = static_cast<unsigned char *>(umfPoolCalloc(pool, 1, 4096));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(ptr[0], 0);
+    EXPECT_EQ(ptr[4095], 0);
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+
+    // chunks are always zeroed
+    ptr = static_cast<unsigned char *>(umfPoolCalloc(pool, 1, 64));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(ptr[0], 0);
+    EXPECT_EQ(ptr[63], 0);
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+
+    // allocations above MaxPoolableSize come straight from the provider
+    size_t size = config.MaxPoolableSize + 1;
+    ptr = static_cast<unsigned char *>(umfPoolCalloc(pool, 1, size));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(ptr[0], pattern);
+    EXPECT_EQ(ptr[size - 1], pattern);
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+}
+
 auto defaultPoolConfig = poolConfig();
 INSTANTIATE_TEST_SUITE_P(disjointPoolTests, umfPoolTest,
                          ::testing::Values(poolCreateExtParams{
                              umfDisjointPoolOps(), (void *)&defaultPoolConfig,
                              &MALLOC_PROVIDER_OPS, nullptr}));
 
+umf_disjoint_pool_params_t threadCachePoolConfig() {
+    umf_disjoint_pool_params_t config = poolConfig();
+    config.ThreadCacheSize = 16;
+    return config;
+}
+
+auto threadCachePoolConfigInstance = threadCachePoolConfig();
+INSTANTIATE_TEST_SUITE_P(disjointPoolThreadCacheTests, umfPoolTest,
+                         ::testing::Values(poolCreateExtParams{
+                             umfDisjointPoolOps(),
+                             (void *)&threadCachePoolConfigInstance,
+                             &MALLOC_PROVIDER_OPS, nullptr}));
+
 INSTANTIATE_TEST_SUITE_P(
     disjointPoolTests, umfMemTest,
     ::testing::Values(std::make_tuple(
@@ -5,17 +5,104 @@
 #include "umf/pools/pool_jemalloc.h"
 #include "umf/providers/provider_os_memory.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
 #include "pool.hpp"
+#include "pool/pool_jemalloc_internal.h"
 #include "poolFixtures.hpp"
 
 using umf_test::test;
 using namespace umf_test;
 
 auto defaultParams = umfOsMemoryProviderParamsDefault();
-INSTANTIATE_TEST_SUITE_P(jemallocPoolTest, umfPoolTest,
-                         ::testing::Values(poolCreateExtParams{
-                             umfJemallocPoolOps(), nullptr,
-                             umfOsMemoryProviderOps(), &defaultParams}));
+
+umf_jemalloc_pool_params_t jemallocParams(
+    unsigned n_arenas, umf_jemalloc_pool_arena_selection_t selection) {
+    auto params = umfJemallocPoolParamsDefault();
+    params.n_arenas = n_arenas;
+    params.arena_selection = selection;
+    return params;
+}
+
+auto singleArenaParams =
+    jemallocParams(1, UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD);
+auto threadArenasParams =
+    jemallocParams(4, UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD);
+auto cpuArenasParams = jemallocParams(4, UMF_JEMALLOC_POOL_ARENA_SELECTION_CPU);
+auto perCpuArenasParams =
+    jemallocParams(0, UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD);
+
+auto noDecayParams = [] {
+    auto params = jemallocParams(1, UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD);
+    params.dirty_decay_ms = -1;
+    params.muzzy_decay_ms = -1;
+    return params;
+}();
+
+auto retainParams = [] {
+    auto params = jemallocParams(1, UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD);
+    params.dirty_decay_ms = 0;
+    params.muzzy_decay_ms = 0;
+    params.retain = 1;
+    params.retain_grow_limit = 4 * 1024 * 1024;
+    return params;
+}();
+
+INSTANTIATE_TEST_SUITE_P(
+    jemallocPoolTest, umfPoolTest,
+    ::testing::Values(poolCreateExtParams{umfJemallocPoolOps(), nullptr,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams},
+                      poolCreateExtParams{umfJemallocPoolOps(),
+                                          &singleArenaParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams},
+                      poolCreateExtParams{umfJemallocPoolOps(),
+                                          &threadArenasParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams},
+                      poolCreateExtParams{umfJemallocPoolOps(),
+                                          &cpuArenasParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams},
+                      poolCreateExtParams{umfJemallocPoolOps(),
+                                          &perCpuArenasParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams},
+                      poolCreateExtParams{umfJemallocPoolOps(), &noDecayParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams},
+                      poolCreateExtParams{umfJemallocPoolOps(), &retainParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams}));
+
+TEST_F(test, invalidParams) {
+    auto invalidSelection =
+        jemallocParams(1, UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD);
+    invalidSelection.arena_selection = (umf_jemalloc_pool_arena_selection_t)-1;
+
+    auto invalidDecay =
+        jemallocParams(1, UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD);
+    invalidDecay.muzzy_decay_ms = -3;
+
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t ret = umfMemoryProviderCreate(umfOsMemoryProviderOps(),
+                                               &defaultParams, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    for (auto *params : {&invalidSelection, &invalidDecay}) {
+        umf_memory_pool_handle_t pool = nullptr;
+        ret = umfPoolCreate(umfJemallocPoolOps(), provider, params, 0, &pool);
+        EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+        EXPECT_EQ(pool, nullptr);
+    }
+
+    umfMemoryProviderDestroy(provider);
+}
 
 // this test makes sure that jemalloc does not use
 // memory provider to allocate metadata (and hence
@@ -40,3 +127,118 @@ TEST_F(test, metadataNotAllocatedUsingProvider) {
             [pool = pool.get()](void *ptr) { umfPoolFree(pool, ptr); });
     }
 }
+
+// The thread exit key of the tcaches is deleted together with the last pool
+// and created again with the next one, the threads using both keys must
+// get their tcaches.
+TEST_F(test, tcachesAfterLastPoolDestroyed) {
+    for (int i = 0; i < 3; i++) {
+        auto pool = poolCreateExtUnique({umfJemallocPoolOps(), nullptr,
+                                         umfOsMemoryProviderOps(),
+                                         &defaultParams});
+
+        auto worker = [pool = pool.get()] {
+            for (int j = 0; j < 1024; j++) {
+                void *ptr = umfPoolMalloc(pool, 64);
+                ASSERT_NE(ptr, nullptr);
+                ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+            }
+        };
+
+        worker();
+        std::thread(worker).join();
+    }
+}
+
+// Returns the indexes of the arenas of the allocations made by the given
+// number of threads, all of them alive at the same time.
+static std::set<unsigned> threadArenas(umf_memory_pool_handle_t pool,
+                                       size_t numThreads) {
+    std::mutex mtx;
+    std::condition_variable cv;
+    size_t allocated = 0;
+    std::set<unsigned> arenas;
+
+    auto worker = [&] {
+        void *ptr = umfPoolMalloc(pool, 64);
+        EXPECT_NE(ptr, nullptr);
+
+        unsigned arena = 0;
+        bool found =
+            ptr && umfJemallocPoolGetArena(ptr, &arena) == UMF_RESULT_SUCCESS;
+        EXPECT_TRUE(found);
+
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (found) {
+                arenas.insert(arena);
+            }
+            allocated++;
+            cv.notify_all();
+            // keep the thread alive until all the threads allocated
+            cv.wait(lock, [&] { return allocated == numThreads; });
+        }
+
+        EXPECT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numThreads; i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    return arenas;
+}
+
+TEST_F(test, singleArenaByDefault) {
+    auto pool = poolCreateExtUnique(
+        {umfJemallocPoolOps(), nullptr, umfOsMemoryProviderOps(),
+         &defaultParams});
+
+    ASSERT_EQ(threadArenas(pool.get(), 4).size(), 1u);
+}
+
+TEST_F(test, concurrentThreadsUseDistinctArenas) {
+    auto pool = poolCreateExtUnique({umfJemallocPoolOps(), &threadArenasParams,
+                                     umfOsMemoryProviderOps(),
+                                     &defaultParams});
+
+    // new threads are assigned to the arenas round-robin
+    ASSERT_EQ(threadArenas(pool.get(), threadArenasParams.n_arenas).size(),
+              threadArenasParams.n_arenas);
+}
+
+TEST_F(test, trimStopsAfterRequestedSize) {
+    auto params = jemallocParams(4, UMF_JEMALLOC_POOL_ARENA_SELECTION_THREAD);
+    params.dirty_decay_ms = -1;
+    params.muzzy_decay_ms = -1;
+
+    auto pool = poolCreateExtUnique({umfJemallocPoolOps(), &params,
+                                     umfOsMemoryProviderOps(),
+                                     &defaultParams});
+
+    // leave unused pages in every arena (new threads are assigned
+    // to the arenas round-robin)
+    const size_t size = 4 * 1024 * 1024;
+    for (unsigned i = 0; i < params.n_arenas; i++) {
+        std::thread([&] {
+            void *ptr = umfPoolMalloc(pool.get(), size);
+            ASSERT_NE(ptr, nullptr);
+            memset(ptr, 0xFF, size);
+            ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+        }).join();
+    }
+
+    // an arena is purged as a whole, so trimming a single byte releases
+    // the pages of the first arena only
+    size_t released = 0;
+    ASSERT_EQ(umfPoolTrim(pool.get(), 1, &released), UMF_RESULT_SUCCESS);
+    ASSERT_GE(released, 1u);
+    ASSERT_LT(released, params.n_arenas * size);
+
+    ASSERT_EQ(umfPoolTrim(pool.get(), 0, &released), UMF_RESULT_SUCCESS);
+    ASSERT_GT(released, 0u);
+}
@@ -7,9 +7,94 @@
 
 #include "pool.hpp"
 #include "poolFixtures.hpp"
+#include "provider.hpp"
+
+using umf_test::test;
+using namespace umf_test;
+
+TEST_F(test, granularityAndKeepAllMemory) {
+    static constexpr size_t PageSize = 64 * 1024;
+    static size_t numAllocs = 0;
+    static size_t numFrees = 0;
+    static bool allAligned = true;
+
+    struct memory_provider : public provider_malloc {
+        umf_result_t alloc(size_t size, size_t align, void **ptr) noexcept {
+            umf_result_t ret = provider_malloc::alloc(size, align, ptr);
+            if (ret == UMF_RESULT_SUCCESS) {
+                numAllocs++;
+                allAligned = allAligned && (size % PageSize == 0) &&
+                             ((uintptr_t)*ptr % PageSize == 0);
+            }
+            return ret;
+        }
+        umf_result_t free(void *ptr, size_t size) noexcept {
+            numFrees++;
+            return provider_malloc::free(ptr, size);
+        }
+        umf_result_t get_recommended_page_size(size_t,
+                                               size_t *pageSize) noexcept {
+            *pageSize = PageSize;
+            return UMF_RESULT_SUCCESS;
+        }
+    };
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<memory_provider, void>();
+    auto provider =
+        wrapProviderUnique(createProviderChecked(&provider_ops, nullptr));
+
+    // not a multiple of the page size
+    umf_scalable_pool_params_t params = umfScalablePoolParamsDefault();
+    params.granularity = 1024 * 1024 + 1;
+    params.keep_all_memory = 1;
+
+    umf_memory_pool_handle_t pool = nullptr;
+    auto ret = umfPoolCreate(umfScalablePoolOps(), provider.get(), &params, 0,
+                             &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto poolHandle = umf_test::wrapPoolUnique(pool);
+
+    static constexpr size_t sizes[] = {64, 4096, 100 * 1024, 8 * 1024 * 1024};
+    for (size_t size : sizes) {
+        void *ptr = umfPoolMalloc(pool, size);
+        ASSERT_NE(ptr, nullptr);
+        memset(ptr, 0, size);
+        ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+    }
+
+    EXPECT_GT(numAllocs, 0);
+    EXPECT_TRUE(allAligned);
+    EXPECT_EQ(numFrees, 0);
+
+    poolHandle.reset();
+    EXPECT_EQ(numFrees, numAllocs);
+}
 
 auto defaultParams = umfOsMemoryProviderParamsDefault();
 INSTANTIATE_TEST_SUITE_P(scalablePoolTest, umfPoolTest,
                          ::testing::Values(poolCreateExtParams{
                              umfScalablePoolOps(), nullptr,
                              umfOsMemoryProviderOps(), &defaultParams}));
+
+umf_scalable_pool_params_t keepAllMemoryParams = []() {
+    umf_scalable_pool_params_t params = umfScalablePoolParamsDefault();
+    params.keep_all_memory = 1;
+    return params;
+}();
+
+umf_scalable_pool_params_t smallGranularityParams = []() {
+    umf_scalable_pool_params_t params = umfScalablePoolParamsDefault();
+    params.granularity = 64 * 1024;
+    return params;
+}();
+
+INSTANTIATE_TEST_SUITE_P(
+    scalablePoolParamsTest, umfPoolTest,
+    ::testing::Values(poolCreateExtParams{umfScalablePoolOps(),
+                                          &keepAllMemoryParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams},
+                      poolCreateExtParams{umfScalablePoolOps(),
+                                          &smallGranularityParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams}));
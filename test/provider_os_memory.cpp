@@ -6,9 +6,19 @@
 
 #include "cpp_helpers.hpp"
 
+#include <umf/memory_pool.h>
 #include <umf/memory_provider.h>
+#include <umf/pools/pool_proxy.h>
 #include <umf/providers/provider_os_memory.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vector>
+
+using umf_test::has_vm_flag;
 using umf_test::test;
 
 #define INVALID_PTR ((void *)0x01)
@@ -31,6 +41,8 @@ static const char *Native_error_str[] = {
     "lazy purging failed",             // UMF_OS_RESULT_ERROR_PURGE_LAZY_FAILED
     "force purging failed",            // UMF_OS_RESULT_ERROR_PURGE_FORCE_FAILED
     "HWLOC topology discovery failed", // UMF_OS_RESULT_ERROR_TOPO_DISCOVERY_FAILED
+    "committing memory failed",        // UMF_OS_RESULT_ERROR_COMMIT_FAILED
+    "decommitting memory failed",      // UMF_OS_RESULT_ERROR_DECOMMIT_FAILED
 };
 
 // test helpers
@@ -204,6 +216,245 @@ TEST_F(test, create_ZERO_WEIGHT_PARTITION) {
     ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
+TEST_F(test, create_WRONG_HUGE_PAGE_SIZE) {
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        umfOsMemoryProviderParamsDefault();
+
+    // not a power of 2
+    os_memory_provider_params.huge_pages = UMF_HUGE_PAGES_TRANSPARENT;
+    os_memory_provider_params.huge_page_size = 3 * 1024 * 1024;
+
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &os_memory_provider_params,
+        &os_memory_provider);
+
+    EXPECT_EQ(os_memory_provider, nullptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_F(test, create_EXPLICIT_HUGE_PAGES_SHARED) {
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        umfOsMemoryProviderParamsDefault();
+
+    os_memory_provider_params.visibility = UMF_MEM_MAP_SHARED;
+    os_memory_provider_params.huge_pages = UMF_HUGE_PAGES_EXPLICIT;
+
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &os_memory_provider_params,
+        &os_memory_provider);
+
+    EXPECT_EQ(os_memory_provider, nullptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+}
+
+// the physical memory of the freed shared memory is released
+// and the file ranges are reused
+TEST_F(test, shared_memory_footprint_tracks_live_allocations) {
+    char shm_name[] = "umf_test_fd_hole_punching";
+    const size_t size = 1024 * 1024;
+
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        umfOsMemoryProviderParamsDefault();
+    os_memory_provider_params.visibility = UMF_MEM_MAP_SHARED;
+    os_memory_provider_params.shm_name = shm_name;
+
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &os_memory_provider_params,
+        &os_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    int fd = shm_open(shm_name, O_RDONLY, 0);
+    ASSERT_GE(fd, 0);
+
+    auto footprint = [fd]() {
+        struct stat st;
+        EXPECT_EQ(fstat(fd, &st), 0);
+        return (size_t)st.st_blocks * 512;
+    };
+
+    for (int i = 0; i < 16; i++) {
+        void *ptr = nullptr;
+        int zeroed = 0;
+        umf_result = umfMemoryProviderAllocWithZeroInfo(
+            os_memory_provider, size, i % 2 ? 2 * size : 0, &ptr, &zeroed);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_NE(ptr, nullptr);
+
+        // the reused file ranges have been released, so they read zeros
+        ASSERT_EQ(zeroed, 1);
+        for (size_t j = 0; j < size; j++) {
+            ASSERT_EQ(((unsigned char *)ptr)[j], 0);
+        }
+
+        memset(ptr, 0xAB, size);
+        ASSERT_GE(footprint(), size);
+        ASSERT_LE(footprint(), 2 * size);
+
+        umf_result = umfMemoryProviderFree(os_memory_provider, ptr, size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_EQ(footprint(), 0);
+    }
+
+    close(fd);
+    umfMemoryProviderDestroy(os_memory_provider);
+    shm_unlink(shm_name);
+}
+
+TEST_F(test, create_EXPLICIT_HUGE_PAGES_RESERVED) {
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        umfOsMemoryProviderParamsDefault();
+
+    os_memory_provider_params.huge_pages = UMF_HUGE_PAGES_EXPLICIT;
+    os_memory_provider_params.reserve_size = 64 * 1024 * 1024;
+
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &os_memory_provider_params,
+        &os_memory_provider);
+
+    EXPECT_EQ(os_memory_provider, nullptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+}
+
+// the freed memory is returned to the reserved address space and reused,
+// the allocations not fitting in it are mapped separately
+static void
+test_reserved_address_space_reuse(umf_memory_visibility_t visibility,
+                                  char *shm_name) {
+    const size_t page_size = sysconf(_SC_PAGE_SIZE);
+    const size_t size = 4 * page_size;
+
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        umfOsMemoryProviderParamsDefault();
+    os_memory_provider_params.visibility = visibility;
+    os_memory_provider_params.shm_name = shm_name;
+    os_memory_provider_params.reserve_size = 2 * size;
+
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &os_memory_provider_params,
+        &os_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    void *ptr1 = nullptr;
+    umf_result = umfMemoryProviderAlloc(os_memory_provider, size, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    memset(ptr1, 0xAB, size);
+
+    umf_result = umfMemoryProviderFree(os_memory_provider, ptr1, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    for (int i = 0; i < 2; i++) {
+        void *ptr = nullptr;
+        int zeroed = 0;
+        umf_result = umfMemoryProviderAllocWithZeroInfo(
+            os_memory_provider, size, 0, &ptr, &zeroed);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        if (i == 0) {
+            ASSERT_EQ(ptr, ptr1);
+        }
+
+        // the released pages are zero-filled again
+        ASSERT_EQ(zeroed, 1);
+        for (size_t j = 0; j < size; j++) {
+            ASSERT_EQ(((unsigned char *)ptr)[j], 0);
+        }
+        memset(ptr, 0xAB, size);
+    }
+
+    // the reservation is exhausted now
+    void *ptr2 = nullptr;
+    umf_result = umfMemoryProviderAlloc(os_memory_provider, size, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr2, nullptr);
+    memset(ptr2, 0xAB, size);
+
+    umf_result = umfMemoryProviderFree(os_memory_provider, ptr2, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umfMemoryProviderDestroy(os_memory_provider);
+}
+
+TEST_F(test, reserved_address_space_reuse_private) {
+    test_reserved_address_space_reuse(UMF_MEM_MAP_PRIVATE, nullptr);
+}
+
+TEST_F(test, reserved_address_space_reuse_shared) {
+    char shm_name[] = "umf_test_reserved_address_space";
+    test_reserved_address_space_reuse(UMF_MEM_MAP_SHARED, shm_name);
+    shm_unlink(shm_name);
+}
+
+// all pages of the allocation are resident right after it is allocated
+static void test_populate(umf_os_memory_provider_params_t *params,
+                          size_t size) {
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), params, &os_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    void *ptr = nullptr;
+    umf_result = umfMemoryProviderAlloc(os_memory_provider, size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    const size_t page_size = sysconf(_SC_PAGE_SIZE);
+    std::vector<unsigned char> vec(size / page_size);
+    ASSERT_EQ(mincore(ptr, size, vec.data()), 0);
+    for (size_t i = 0; i < vec.size(); i++) {
+        ASSERT_EQ(vec[i] & 1, 1) << "page " << i << " is not resident";
+    }
+
+    // the populated memory is still zero-filled
+    for (size_t i = 0; i < size; i += page_size) {
+        ASSERT_EQ(((unsigned char *)ptr)[i], 0);
+    }
+
+    umf_result = umfMemoryProviderFree(os_memory_provider, ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umfMemoryProviderDestroy(os_memory_provider);
+}
+
+TEST_F(test, populate_small) {
+    umf_os_memory_provider_params_t params =
+        umfOsMemoryProviderParamsDefault();
+    params.populate = 1;
+    test_populate(&params, 1024 * 1024);
+}
+
+TEST_F(test, populate_large_parallel) {
+    umf_os_memory_provider_params_t params =
+        umfOsMemoryProviderParamsDefault();
+    params.populate = 1;
+    params.populate_threads = 4;
+    test_populate(&params, 64 * 1024 * 1024 + 3 * sysconf(_SC_PAGE_SIZE));
+}
+
+TEST_F(test, populate_large_parallel_bind) {
+    unsigned node = 0;
+    umf_os_memory_provider_params_t params =
+        umfOsMemoryProviderParamsDefault();
+    params.populate = 1;
+    params.populate_threads = 4;
+    params.numa_list = &node;
+    params.numa_list_len = 1;
+    params.numa_mode = UMF_NUMA_MODE_BIND;
+    test_populate(&params, 64 * 1024 * 1024);
+}
+
+TEST_F(test, populate_shared) {
+    umf_os_memory_provider_params_t params =
+        umfOsMemoryProviderParamsDefault();
+    params.populate = 1;
+    params.populate_threads = 4;
+    params.visibility = UMF_MEM_MAP_SHARED;
+    test_populate(&params, 64 * 1024 * 1024);
+}
+
 // positive tests using test_alloc_free_success
 
 auto defaultParams = umfOsMemoryProviderParamsDefault();
@@ -211,6 +462,68 @@ INSTANTIATE_TEST_SUITE_P(osProviderTest, umfProviderTest,
                          ::testing::Values(providerCreateExtParams{
                              umfOsMemoryProviderOps(), &defaultParams}));
 
+umf_os_memory_provider_params_t thpParams = []() {
+    umf_os_memory_provider_params_t params =
+        umfOsMemoryProviderParamsDefault();
+    params.huge_pages = UMF_HUGE_PAGES_TRANSPARENT;
+    return params;
+}();
+
+// falls back to transparent huge pages if no huge pages are reserved
+umf_os_memory_provider_params_t explicitHugePagesParams = []() {
+    umf_os_memory_provider_params_t params =
+        umfOsMemoryProviderParamsDefault();
+    params.huge_pages = UMF_HUGE_PAGES_EXPLICIT;
+    return params;
+}();
+
+INSTANTIATE_TEST_SUITE_P(
+    osProviderHugePagesTest, umfProviderTest,
+    ::testing::Values(providerCreateExtParams{umfOsMemoryProviderOps(),
+                                              &thpParams},
+                      providerCreateExtParams{umfOsMemoryProviderOps(),
+                                              &explicitHugePagesParams}));
+
+umf_os_memory_provider_params_t reservedParams = []() {
+    umf_os_memory_provider_params_t params =
+        umfOsMemoryProviderParamsDefault();
+    params.reserve_size = 64 * 1024 * 1024;
+    return params;
+}();
+
+umf_os_memory_provider_params_t reservedThpParams = []() {
+    umf_os_memory_provider_params_t params = reservedParams;
+    params.huge_pages = UMF_HUGE_PAGES_TRANSPARENT;
+    return params;
+}();
+
+INSTANTIATE_TEST_SUITE_P(
+    osProviderReservedTest, umfProviderTest,
+    ::testing::Values(providerCreateExtParams{umfOsMemoryProviderOps(),
+                                              &reservedParams},
+                      providerCreateExtParams{umfOsMemoryProviderOps(),
+                                              &reservedThpParams}));
+
+umf_os_memory_provider_params_t populateParams = []() {
+    umf_os_memory_provider_params_t params =
+        umfOsMemoryProviderParamsDefault();
+    params.populate = 1;
+    return params;
+}();
+
+umf_os_memory_provider_params_t populateThreadsParams = []() {
+    umf_os_memory_provider_params_t params = populateParams;
+    params.populate_threads = 4;
+    return params;
+}();
+
+INSTANTIATE_TEST_SUITE_P(
+    osProviderPopulateTest, umfProviderTest,
+    ::testing::Values(providerCreateExtParams{umfOsMemoryProviderOps(),
+                                              &populateParams},
+                      providerCreateExtParams{umfOsMemoryProviderOps(),
+                                              &populateThreadsParams}));
+
 TEST_P(umfProviderTest, create_destroy) {}
 
 TEST_P(umfProviderTest, alloc_page64_align_0) {
@@ -240,6 +553,220 @@ TEST_P(umfProviderTest, purge_force) {
     test_alloc_free_success(provider.get(), page_plus_64, 0, PURGE_FORCE);
 }
 
+TEST_P(umfProviderTest, alloc_with_zero_info) {
+    void *ptr = nullptr;
+    int zeroed = 0;
+    umf_result_t umf_result = umfMemoryProviderAllocWithZeroInfo(
+        provider.get(), page_plus_64, 0, &ptr, &zeroed);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    // the memory is freshly mapped
+    ASSERT_EQ(zeroed, 1);
+    for (size_t i = 0; i < page_plus_64; i++) {
+        ASSERT_EQ(((unsigned char *)ptr)[i], 0);
+    }
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_plus_64);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_P(umfProviderTest, proxy_pool_calloc) {
+    umf_memory_pool_handle_t pool = nullptr;
+    umf_result_t umf_result =
+        umfPoolCreate(umfProxyPoolOps(), provider.get(), nullptr, 0, &pool);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the proxy pool supports calloc only for zero-filled provider memory
+    size_t num = 3;
+    auto *ptr = (unsigned char *)umfPoolCalloc(pool, num, page_size);
+    ASSERT_NE(ptr, nullptr);
+    for (size_t i = 0; i < num * page_size; i++) {
+        ASSERT_EQ(ptr[i], 0);
+    }
+
+    umf_result = umfPoolFree(pool, ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umfPoolDestroy(pool);
+}
+
+TEST_P(umfProviderTest, decommit_commit) {
+    size_t size = 2 * page_size;
+    void *ptr = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    memset(ptr, 0xFF, size);
+
+    umf_result = umfMemoryProviderDecommit(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderCommit(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the decommitted pages are zero-filled after commit
+    for (size_t i = 0; i < size; i += page_size) {
+        ASSERT_EQ(((unsigned char *)ptr)[i], 0);
+    }
+    memset(ptr, 0xFF, size);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+// the decommitted memory is not charged to the commit limit anymore:
+// its mapping is replaced with a MAP_NORESERVE one ("nr" in VmFlags)
+TEST_P(umfProviderTest, decommit_releases_commit_charge) {
+    size_t size = 4 * page_size;
+    void *ptr = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_FALSE(has_vm_flag(ptr, "nr"));
+
+    umf_result = umfMemoryProviderDecommit(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_TRUE(has_vm_flag(ptr, "nr"));
+
+    umf_result = umfMemoryProviderCommit(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_FALSE(has_vm_flag(ptr, "nr"));
+    memset(ptr, 0xFF, size);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+// the memory committed in the reserved address space is advised to use
+// transparent huge pages ("hg" in VmFlags), also when it is reused
+TEST_F(test, reserved_address_space_transparent_huge_pages) {
+    if (access("/sys/kernel/mm/transparent_hugepage/enabled", F_OK)) {
+        GTEST_SKIP() << "transparent huge pages are not supported";
+    }
+
+    const size_t size = 4 * 1024 * 1024;
+
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &reservedThpParams, &os_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    for (int i = 0; i < 2; i++) {
+        void *ptr = nullptr;
+        umf_result =
+            umfMemoryProviderAlloc(os_memory_provider, size, 0, &ptr);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_TRUE(has_vm_flag(ptr, "hg"));
+        memset(ptr, 0xAB, size);
+
+        umf_result = umfMemoryProviderFree(os_memory_provider, ptr, size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    umfMemoryProviderDestroy(os_memory_provider);
+}
+
+// the decommitted memory freed to the reserved address space
+// is committed again when it is reused
+TEST_F(test, reserved_address_space_reuse_decommitted) {
+    const size_t size = 4 * sysconf(_SC_PAGE_SIZE);
+
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &reservedParams, &os_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    void *ptr1 = nullptr;
+    umf_result = umfMemoryProviderAlloc(os_memory_provider, size, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr1, nullptr);
+    memset(ptr1, 0xAB, size);
+
+    umf_result = umfMemoryProviderDecommit(os_memory_provider, ptr1, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderFree(os_memory_provider, ptr1, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    void *ptr2 = nullptr;
+    umf_result = umfMemoryProviderAlloc(os_memory_provider, size, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr2, ptr1);
+    ASSERT_FALSE(has_vm_flag(ptr2, "nr"));
+    memset(ptr2, 0xAB, size);
+
+    umf_result = umfMemoryProviderFree(os_memory_provider, ptr2, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umfMemoryProviderDestroy(os_memory_provider);
+}
+
+TEST_F(test, reserved_address_space_decommit_OUT_OF_RESERVATION) {
+    const size_t size = 4 * sysconf(_SC_PAGE_SIZE);
+
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &reservedParams, &os_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    void *ptr = nullptr;
+    umf_result = umfMemoryProviderAlloc(os_memory_provider, size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    // the range crosses the end of the reservation
+    umf_result = umfMemoryProviderDecommit(os_memory_provider, ptr,
+                                           2 * reservedParams.reserve_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    umf_result = umfMemoryProviderCommit(os_memory_provider, ptr,
+                                         2 * reservedParams.reserve_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfMemoryProviderFree(os_memory_provider, ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umfMemoryProviderDestroy(os_memory_provider);
+}
+
+// the pages interleaved by the kernel (single-page parts) are advised not
+// to use transparent huge pages ("nh" in VmFlags), so that the system
+// THP setting cannot turn the part size into the huge page size
+TEST_F(test, interleave_page_size_part_size_no_huge_pages) {
+    const size_t page_size = sysconf(_SC_PAGE_SIZE);
+    const size_t size = 4 * 1024 * 1024;
+    unsigned numa_list[] = {0};
+
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        umfOsMemoryProviderParamsDefault();
+    os_memory_provider_params.numa_list = numa_list;
+    os_memory_provider_params.numa_list_len = 1;
+    os_memory_provider_params.numa_mode = UMF_NUMA_MODE_INTERLEAVE;
+    os_memory_provider_params.part_size = page_size;
+
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &os_memory_provider_params,
+        &os_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    void *ptr = nullptr;
+    umf_result = umfMemoryProviderAlloc(os_memory_provider, size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_TRUE(has_vm_flag(ptr, "nh"));
+    memset(ptr, 0xAB, size);
+
+    umf_result = umfMemoryProviderFree(os_memory_provider, ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umfMemoryProviderDestroy(os_memory_provider);
+}
+
 // negative tests using test_alloc_failure
 
 TEST_P(umfProviderTest, alloc_page64_align_page_minus_1_WRONG_ALIGNMENT_1) {
@@ -283,6 +810,26 @@ TEST_P(umfProviderTest, get_recommended_page_size) {
     ASSERT_GE(recommended_page_size, min_page_size);
 }
 
+TEST_P(umfProviderTest, alloc_recommended_page_size_aligned) {
+    size_t recommended_page_size;
+    umf_result_t umf_result = umfMemoryProviderGetRecommendedPageSize(
+        provider.get(), 0, &recommended_page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // allocations of the recommended page size line up with the pages
+    size_t size = 2 * recommended_page_size;
+    void *ptr = nullptr;
+    umf_result = umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_IS_ALIGNED(ptr, recommended_page_size);
+
+    memset(ptr, 0xFF, size);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
 TEST_P(umfProviderTest, get_name) {
     const char *name = umfMemoryProviderGetName(provider.get());
     ASSERT_STREQ(name, "OS");
@@ -326,3 +873,59 @@ TEST_P(umfProviderTest, purge_force_INVALID_POINTER) {
     verify_last_native_error(provider.get(),
                              UMF_OS_RESULT_ERROR_PURGE_FORCE_FAILED);
 }
+
+TEST_P(umfProviderTest, decommit_INVALID_POINTER) {
+    umf_result_t umf_result =
+        umfMemoryProviderDecommit(provider.get(), INVALID_PTR, 1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ALIGNMENT);
+}
+
+TEST_P(umfProviderTest, decommit_commit_WRONG_SIZE) {
+    void *ptr = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), 2 * page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    umf_result = umfMemoryProviderDecommit(provider.get(), ptr, page_size + 1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ALIGNMENT);
+    umf_result = umfMemoryProviderCommit(provider.get(), ptr, page_size - 1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ALIGNMENT);
+
+    // the memory was not decommitted
+    memset(ptr, 0xFF, 2 * page_size);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, 2 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+// the pages of the memory mapped from a file are shared
+// with the other mappings of the file, so they cannot be decommitted
+TEST_F(test, decommit_commit_shared_NOT_SUPPORTED) {
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        umfOsMemoryProviderParamsDefault();
+    os_memory_provider_params.visibility = UMF_MEM_MAP_SHARED;
+
+    umf_memory_provider_handle_t os_memory_provider = nullptr;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &os_memory_provider_params,
+        &os_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    size_t size = 2 * sysconf(_SC_PAGE_SIZE);
+    void *ptr = nullptr;
+    umf_result = umfMemoryProviderAlloc(os_memory_provider, size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderDecommit(os_memory_provider, ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    umf_result = umfMemoryProviderCommit(os_memory_provider, ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    // the memory stays accessible
+    memset(ptr, 0xFF, size);
+
+    umf_result = umfMemoryProviderFree(os_memory_provider, ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umfMemoryProviderDestroy(os_memory_provider);
+}
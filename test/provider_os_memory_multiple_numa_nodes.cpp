@@ -429,6 +429,90 @@ TEST_F(testNuma, checkModeInterleaveCustomPartSize) {
     umfMemoryProviderFree(os_memory_provider, ptr, size);
 }
 
+// Test for allocations on numa nodes with interleave mode enabled and the part
+// size of one page. Each next page is expected to be on the next node in
+// the order of numa_list. Returns the memory policy mode of the last page.
+static int checkInterleavedPages(umf_memory_provider_handle_t provider,
+                                 std::vector<unsigned> &numa_nodes,
+                                 void **ptr) {
+    constexpr int pages_num = 1024;
+    size_t page_size = sysconf(_SC_PAGE_SIZE);
+    size_t size = pages_num * page_size;
+
+    umf_result_t umf_result = umfMemoryProviderAlloc(provider, size, 0, ptr);
+    EXPECT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    if (*ptr == nullptr) {
+        return -1;
+    }
+
+    // 'ptr' must point to an initialized value before retrieving its numa node
+    memset(*ptr, 0xFF, size);
+
+    char *addr = (char *)*ptr;
+    auto it = std::find(numa_nodes.begin(), numa_nodes.end(),
+                        (unsigned)getNumaNodeByPtr(addr));
+    EXPECT_NE(it, numa_nodes.end());
+    size_t index = it - numa_nodes.begin();
+    for (size_t i = 1; i < (size_t)pages_num; i++) {
+        index = (index + 1) % numa_nodes.size();
+        EXPECT_EQ(numa_nodes[index], getNumaNodeByPtr(addr + page_size * i))
+            << "for page " << i;
+    }
+
+    int mode = -1;
+    int ret = get_mempolicy(&mode, nullptr, 0, addr + size - page_size,
+                            MPOL_F_ADDR);
+    EXPECT_EQ(ret, 0);
+
+    // the pages interleaved by the kernel must not be backed by transparent
+    // huge pages, each of which would land on a single node
+    if (mode == MPOL_INTERLEAVE) {
+        EXPECT_TRUE(umf_test::has_vm_flag(*ptr, "nh"));
+    }
+
+    umfMemoryProviderFree(provider, *ptr, size);
+    *ptr = nullptr;
+
+    return mode;
+}
+
+// The kernel interleaves the pages across the nodes listed in the ascending
+// order, so the whole allocation is bound with a single interleave policy.
+TEST_F(testNuma, checkModeInterleavePageSizePartSize) {
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        UMF_OS_MEMORY_PROVIDER_PARAMS_TEST;
+
+    std::vector<unsigned> numa_nodes = get_available_numa_nodes();
+
+    os_memory_provider_params.numa_list = numa_nodes.data();
+    os_memory_provider_params.numa_list_len = numa_nodes.size();
+    os_memory_provider_params.numa_mode = UMF_NUMA_MODE_INTERLEAVE;
+    os_memory_provider_params.part_size = sysconf(_SC_PAGE_SIZE);
+    initOsProvider(os_memory_provider_params);
+
+    EXPECT_EQ(checkInterleavedPages(os_memory_provider, numa_nodes, &ptr),
+              MPOL_INTERLEAVE);
+}
+
+// The kernel cannot interleave the pages in the order of numa_list,
+// so each page is bound to its node separately.
+TEST_F(testNuma, checkModeInterleavePageSizePartSizeUnordered) {
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        UMF_OS_MEMORY_PROVIDER_PARAMS_TEST;
+
+    std::vector<unsigned> numa_nodes = get_available_numa_nodes();
+    std::reverse(numa_nodes.begin(), numa_nodes.end());
+
+    os_memory_provider_params.numa_list = numa_nodes.data();
+    os_memory_provider_params.numa_list_len = numa_nodes.size();
+    os_memory_provider_params.numa_mode = UMF_NUMA_MODE_INTERLEAVE;
+    os_memory_provider_params.part_size = sysconf(_SC_PAGE_SIZE);
+    initOsProvider(os_memory_provider_params);
+
+    EXPECT_EQ(checkInterleavedPages(os_memory_provider, numa_nodes, &ptr),
+              MPOL_BIND);
+}
+
 using numaSplitOut = std::vector<std::vector<unsigned>>;
 
 // Input for Numa split test - in the following format
@@ -7,6 +7,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <thread>
 
 #include "base_alloc.h"
@@ -51,3 +52,91 @@ TEST_F(test, baseAllocMultiThreadedAllocMemset) {
         thread.join();
     }
 }
+
+TEST_F(test, baseAllocMultiThreadedCrossThreadFree) {
+    static constexpr int NTHREADS = 10;
+    static constexpr int ITERATIONS = 1000;
+    static constexpr int ALLOCATION_SIZE = 64;
+
+    auto pool = std::shared_ptr<umf_ba_pool_t>(umf_ba_create(ALLOCATION_SIZE),
+                                               umf_ba_destroy);
+
+    std::vector<std::vector<void *>> ptrs(NTHREADS);
+
+    // chunks allocated by one thread are freed by another one,
+    // so they travel between caches of different threads
+    auto poolAlloc = [&](int TID) {
+        for (int i = 0; i < ITERATIONS; i++) {
+            void *ptr = umf_ba_alloc(pool.get());
+            UT_ASSERTne(ptr, NULL);
+            memset(ptr, TID & 0xFF, ALLOCATION_SIZE);
+            ptrs[TID].push_back(ptr);
+        }
+    };
+
+    auto poolFree = [&](int TID) {
+        for (void *ptr : ptrs[(TID + 1) % NTHREADS]) {
+            for (int k = 0; k < ALLOCATION_SIZE; k++) {
+                UT_ASSERTeq(((unsigned char *)ptr)[k],
+                            ((TID + 1) % NTHREADS) & 0xFF);
+            }
+            umf_ba_free(pool.get(), ptr);
+        }
+    };
+
+    for (auto func : {std::function<void(int)>(poolAlloc),
+                      std::function<void(int)>(poolFree)}) {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < NTHREADS; i++) {
+            threads.emplace_back(func, i);
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+}
+
+TEST_F(test, baseAllocManyPools) {
+    static constexpr int NPOOLS = 32;
+    static constexpr int ITERATIONS = 100;
+
+    // more pools than a thread can cache chunks of, and each of them
+    // is destroyed while the caching thread is still alive
+    for (int round = 0; round < 2; round++) {
+        std::vector<std::shared_ptr<umf_ba_pool_t>> pools;
+        for (int i = 0; i < NPOOLS; i++) {
+            pools.emplace_back(umf_ba_create(16 * (i + 1)), umf_ba_destroy);
+        }
+
+        auto poolAllocFree = [&](int TID) {
+            std::vector<void *> ptrs;
+            for (auto &pool : pools) {
+                for (int i = 0; i < ITERATIONS; i++) {
+                    void *ptr = umf_ba_alloc(pool.get());
+                    UT_ASSERTne(ptr, NULL);
+                    *(int *)ptr = TID;
+                    ptrs.push_back(ptr);
+                }
+            }
+
+            size_t n = 0;
+            for (auto &pool : pools) {
+                for (int i = 0; i < ITERATIONS; i++) {
+                    UT_ASSERTeq(*(int *)ptrs[n], TID);
+                    umf_ba_free(pool.get(), ptrs[n++]);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++) {
+            threads.emplace_back(poolAllocFree, i);
+        }
+        poolAllocFree(4);
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+*/
+
+#include <atomic>
+#include <cerrno>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "critnib/critnib.h"
+
+#include "base.hpp"
+
+using umf_test::test;
+
+static constexpr int NTHREADS = 8;
+static constexpr uintptr_t NKEYS = 2000;
+static constexpr int ITERATIONS = 20;
+
+// keys of all threads are interleaved, so that they share the inner nodes
+static uintptr_t threadKey(int tid, uintptr_t i) {
+    return (i * NTHREADS + tid + 1) << 4;
+}
+
+static void *keyValue(uintptr_t key) { return (void *)(key + 1); }
+static uintptr_t keyAux(uintptr_t key) { return ~key; }
+
+TEST_F(test, critnibInsertRemoveFind) {
+    auto c = std::shared_ptr<critnib>(critnib_new(), critnib_delete);
+    ASSERT_NE(c.get(), nullptr);
+
+    for (uintptr_t key = 16; key <= 1024; key += 16) {
+        ASSERT_EQ(critnib_insert_aux(c.get(), key, keyValue(key), keyAux(key),
+                                     0),
+                  0);
+    }
+    ASSERT_EQ(critnib_insert(c.get(), 16, keyValue(16), 0), EEXIST);
+
+    uintptr_t rkey, raux;
+    void *rvalue;
+    ASSERT_EQ(critnib_find_aux(c.get(), 100, FIND_LE, &rkey, &rvalue, &raux),
+              1);
+    ASSERT_EQ(rkey, 96u);
+    ASSERT_EQ(rvalue, keyValue(96));
+    ASSERT_EQ(raux, keyAux(96));
+
+    ASSERT_EQ(critnib_update_aux(c.get(), 96, 7), 0);
+    ASSERT_EQ(critnib_get_aux(c.get(), 96, &raux), keyValue(96));
+    ASSERT_EQ(raux, 7u);
+    ASSERT_EQ(critnib_update_aux(c.get(), 100, 7), ENOENT);
+
+    ASSERT_EQ(critnib_remove(c.get(), 96), keyValue(96));
+    ASSERT_EQ(critnib_get(c.get(), 96), nullptr);
+    ASSERT_EQ(critnib_find(c.get(), 100, FIND_LE, &rkey, &rvalue), 1);
+    ASSERT_EQ(rkey, 80u);
+    ASSERT_EQ(critnib_find(c.get(), 96, FIND_GE, &rkey, &rvalue), 1);
+    ASSERT_EQ(rkey, 112u);
+}
+
+// Each thread inserts, looks up and removes its own keys, while checking
+// that the keys of the other threads are either not found or found with
+// the value and the auxiliary word they were inserted with.
+TEST_F(test, critnibMultiThreadedInsertRemoveFind) {
+    auto c = std::shared_ptr<critnib>(critnib_new(), critnib_delete);
+    ASSERT_NE(c.get(), nullptr);
+
+    std::atomic<int> errors(0);
+
+    auto worker = [&](int tid) {
+        critnib *cr = c.get();
+        for (int it = 0; it < ITERATIONS; it++) {
+            for (uintptr_t i = 0; i < NKEYS; i++) {
+                uintptr_t key = threadKey(tid, i);
+                if (critnib_insert_aux(cr, key, keyValue(key), keyAux(key),
+                                       0)) {
+                    errors++;
+                }
+            }
+
+            for (uintptr_t i = 0; i < NKEYS; i++) {
+                uintptr_t key = threadKey(tid, i);
+                uintptr_t raux = 0;
+                if (critnib_get_aux(cr, key, &raux) != keyValue(key) ||
+                    raux != keyAux(key)) {
+                    errors++;
+                }
+
+                // the greatest key <= key + 1 is the key itself
+                uintptr_t rkey;
+                void *rvalue;
+                if (!critnib_find_aux(cr, key + 1, FIND_LE, &rkey, &rvalue,
+                                      &raux) ||
+                    rkey != key || rvalue != keyValue(key) ||
+                    raux != keyAux(key)) {
+                    errors++;
+                }
+
+                // a key of another thread
+                uintptr_t other = threadKey((tid + 1) % NTHREADS, i);
+                void *value = critnib_get_aux(cr, other, &raux);
+                if (value && (value != keyValue(other) ||
+                              raux != keyAux(other))) {
+                    errors++;
+                }
+            }
+
+            // remove every other key, then all the rest
+            for (uintptr_t i = it % 2; i < NKEYS; i += 2) {
+                uintptr_t key = threadKey(tid, i);
+                if (critnib_remove(cr, key) != keyValue(key)) {
+                    errors++;
+                }
+            }
+
+            for (uintptr_t i = 0; i < NKEYS; i++) {
+                uintptr_t key = threadKey(tid, i);
+                void *value = critnib_get(cr, key);
+                if ((i % 2 == (uintptr_t)it % 2) ? value != nullptr
+                                                 : value != keyValue(key)) {
+                    errors++;
+                }
+            }
+
+            for (uintptr_t i = 1 - it % 2; i < NKEYS; i += 2) {
+                uintptr_t key = threadKey(tid, i);
+                if (critnib_remove(cr, key) != keyValue(key)) {
+                    errors++;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NTHREADS; i++) {
+        threads.emplace_back(worker, i);
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(errors.load(), 0);
+
+    uintptr_t rkey;
+    void *rvalue;
+    ASSERT_EQ(critnib_find(c.get(), 0, FIND_GE, &rkey, &rvalue), 0);
+}